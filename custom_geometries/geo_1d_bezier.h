@@ -60,6 +60,7 @@
 #include "integration/quadrature.h"
 #include "integration/line_gauss_legendre_integration_points.h"
 #include "custom_utilities/bezier_utils.h"
+#include "custom_utilities/extraction_operator_pool.h"
 #include "custom_utilities/isogeometric_math_utils.h"
 
 namespace Kratos
@@ -187,6 +188,7 @@ public:
      * Type of Matrix
      */
     typedef typename BaseType::MatrixType MatrixType;
+    typedef typename BaseType::ExtractionOperatorPointerType ExtractionOperatorPointerType;
 
     /**
      * Type of Vector
@@ -781,13 +783,13 @@ public:
         VectorType bezier_functions_values(mNumber);
         BezierUtils::bernstein(bezier_functions_values, mOrder, rPoint[0]);
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         VectorType shape_functions_values(this->PointsNumber());
-        noalias( shape_functions_values ) = prod(mExtractionOperator, bezier_functions_values);
+        noalias( shape_functions_values ) = prod(*mpExtractionOperator, bezier_functions_values);
 
         return shape_functions_values(ShapeFunctionIndex) *
                     mCtrlWeights(ShapeFunctionIndex) / denom;
@@ -807,13 +809,13 @@ public:
         VectorType bezier_functions_values(mNumber);
         BezierUtils::bernstein(bezier_functions_values, mOrder, rPoint[0]);
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         rResults.resize(this->PointsNumber(), false);
-        noalias( rResults ) = prod(mExtractionOperator, bezier_functions_values);
+        noalias( rResults ) = prod(*mpExtractionOperator, bezier_functions_values);
 
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             rResults(i) *= (mCtrlWeights(i) / denom);
@@ -832,13 +834,13 @@ public:
         VectorType bezier_functions_derivatives(mNumber);
         BezierUtils::bernstein(bezier_functions_values, bezier_functions_derivatives, mOrder, rPoint[0]);
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         VectorType shape_functions_values(this->PointsNumber());
-        noalias(shape_functions_values) = prod(mExtractionOperator, bezier_functions_values);
+        noalias(shape_functions_values) = prod(*mpExtractionOperator, bezier_functions_values);
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             shape_functions_values(i) *= (mCtrlWeights(i) / denom);
 
@@ -847,7 +849,7 @@ public:
         double tmp = inner_prod(bezier_functions_derivatives, bezier_weights);
         VectorType tmp_gradients =
             prod(
-                mExtractionOperator,
+                *mpExtractionOperator,
                     (1 / denom) * bezier_functions_derivatives -
                         (tmp / pow(denom, 2)) * bezier_functions_values
             );
@@ -865,13 +867,13 @@ public:
         VectorType bezier_functions_derivatives(mNumber);
         BezierUtils::bernstein(bezier_functions_values, bezier_functions_derivatives, mOrder, rPoint[0]);
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         shape_functions_values.resize(this->PointsNumber(), false);
-        noalias( shape_functions_values ) = prod(mExtractionOperator, bezier_functions_values);
+        noalias( shape_functions_values ) = prod(*mpExtractionOperator, bezier_functions_values);
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             shape_functions_values(i) *= (mCtrlWeights(i) / denom);
 
@@ -880,7 +882,7 @@ public:
         double tmp = inner_prod(bezier_functions_derivatives, bezier_weights);
         VectorType tmp_gradients =
             prod(
-                mExtractionOperator,
+                *mpExtractionOperator,
                     (1 / denom) * bezier_functions_derivatives -
                         (tmp / pow(denom, 2)) * bezier_functions_values
             );
@@ -967,26 +969,52 @@ public:
         const int& Degree3,
         const int& NumberOfIntegrationMethod
     )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator),
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
+    /**
+     * Assign the geometry data with the extraction operator shared with the cell (or the other geometries); the operator is not copied.
+     */
+    virtual void AssignGeometryData
+    (
+        const ValuesContainerType& Knots1,
+        const ValuesContainerType& Knots2,
+        const ValuesContainerType& Knots3,
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
     {
         mCtrlWeights = Weights;
         mOrder = Degree1;
         mNumber = mOrder + 1;
-        mExtractionOperator = ExtractionOperator;
+        mpExtractionOperator = pExtractionOperator;
 
         // size checking
-        if(mExtractionOperator.size1() != this->PointsNumber())
+        if(mpExtractionOperator->size1() != this->PointsNumber())
             KRATOS_THROW_ERROR(std::logic_error, "The number of row of extraction operator must be equal to number of nodes", __FUNCTION__)
-        if(mExtractionOperator.size2() != mNumber)
+        if(mpExtractionOperator->size2() != mNumber)
             KRATOS_THROW_ERROR(std::logic_error, "The number of column of extraction operator must be equal to (p_u+1)", __FUNCTION__)
         if(mCtrlWeights.size() != this->PointsNumber())
             KRATOS_THROW_ERROR(std::logic_error, "The number of weights must be equal to number of nodes", __FUNCTION__)
 
+        // compute the Bezier weights once, they are reused by all shape function evaluations
+        mBezierWeights = prod(trans(*mpExtractionOperator), mCtrlWeights);
+
         // find the existing integration rule or create new one if not existed
         BezierUtils::RegisterIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degree1);
 
         // get the geometry_data according to integration rule. Note that this is a static geometry_data of a reference Bezier element, not the real Bezier element.
         mpGeometryData = BezierUtils::RetrieveIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degree1);
         BaseType::mpGeometryData = &(*mpGeometryData);
+
+        // the tables are computed here under the eager precompute policy
+        this->ResetPrecomputedTables();
     }
 
 protected:
@@ -1003,10 +1031,12 @@ private:
 
     GeometryData::Pointer mpGeometryData;
 
-    MatrixType mExtractionOperator;
+    typename ExtractionOperatorPool<MatrixType>::PointerType mpExtractionOperator; //extraction operator, shared with the cell and the other geometries having the same operator
 
     ValuesContainerType mCtrlWeights; // weight of control points
 
+    VectorType mBezierWeights; // weight of Bezier control points, i.e. trans(mExtractionOperator) * mCtrlWeights
+
     int mOrder; // order of the curve
 
     int mNumber; // number of Bezier shape functions
@@ -1131,6 +1161,22 @@ private:
         CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(shape_functions_values, shape_functions_local_gradients, integration_points);
     }
 
+    /**
+     * The shape function tables are determined by the integration rule, the extraction operator and the normalized weights
+     */
+    virtual bool GetShapeFunctionsTableKey(ShapeFunctionsTableCache::KeyType& rKey, IntegrationMethod ThisMethod) const
+    {
+        if(mpGeometryData == NULL)
+            return false;
+
+        rKey.AddInteger(mOrder);
+        rKey.AddInteger(static_cast<int>(ThisMethod));
+        rKey.AddObject(mpGeometryData);
+        rKey.AddObject(mpExtractionOperator);
+        rKey.SetWeights(mCtrlWeights);
+        return true;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////
     // end of method to build to GeometryData
     ////////////////////////////////////////////////////////////////////////////////////////////////////////
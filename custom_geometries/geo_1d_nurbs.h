@@ -59,6 +59,7 @@
 #include "custom_geometries/isogeometric_geometry.h"
 #include "integration/quadrature.h"
 #include "custom_utilities/bspline_utils.h"
+#include "custom_utilities/nurbs/knot_span_locator.h"
 #include "integration/quadrature.h"
 #include "integration/line_gauss_legendre_integration_points.h"
 
@@ -790,7 +791,7 @@ public:
     virtual double ShapeFunctionValue( IndexType ShapeFunctionIndex,
             const CoordinatesArrayType& rPoint ) const
     {
-        int span = BSplineUtils::FindSpan(mNumber, mOrder, rPoint[0], mKnots);
+        int span = mSpanLocator.FindSpan(mNumber, mOrder, rPoint[0]);
         int start = span - mOrder;
 
         // bound checking
@@ -829,7 +830,7 @@ public:
         //compute the b-spline shape functions
         ValuesContainerType ShapeFunctionValues1(mOrder + 1);
 
-        int Span = BSplineUtils::FindSpan(mNumber, mOrder, rCoordinates[0], mKnots);
+        int Span = mSpanLocator.FindSpan(mNumber, mOrder, rCoordinates[0]);
 
         BSplineUtils::BasisFuns(ShapeFunctionValues1, Span, rCoordinates[0], mOrder, mKnots);
 
@@ -868,7 +869,7 @@ public:
         //compute the b-spline shape functions & first derivatives
         const int NumberOfDerivatives = 1;
         Matrix ShapeFunctionsValuesAndDerivatives(NumberOfDerivatives + 1, mOrder + 1);
-        int span = BSplineUtils::FindSpan(mNumber, mOrder, rPoint[0], mKnots);
+        int span = mSpanLocator.FindSpan(mNumber, mOrder, rPoint[0]);
         BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives, span, rPoint[0], mOrder, mKnots, NumberOfDerivatives, BSplineUtils::MatrixOp());
         double denom = 0.0;
         double denom_der = 0.0;
@@ -912,7 +913,7 @@ public:
         //compute the b-spline shape functions & first derivatives
         const int NumberOfDerivatives = 1;
         Matrix ShapeFunctionsValuesAndDerivatives(NumberOfDerivatives + 1, mOrder + 1);
-        int span = BSplineUtils::FindSpan(mNumber, mOrder, rPoint[0], mKnots);
+        int span = mSpanLocator.FindSpan(mNumber, mOrder, rPoint[0]);
         BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives, span, rPoint[0], mOrder, mKnots, NumberOfDerivatives, BSplineUtils::MatrixOp());
         double denom = 0.0;
         double denom_der = 0.0;
@@ -1024,6 +1025,7 @@ public:
     )
     {
         mKnots = Knots1;
+        mSpanLocator.Initialize(mKnots);
         mCtrlWeights = Weights;
         mOrder = Degree1;
         mNumber = Knots1.size() - Degree1 - 1;
@@ -1101,6 +1103,7 @@ private:
     GeometryData::Pointer mpGeometryData;
 
     ValuesContainerType mKnots; //knot vector
+    KnotSpanLocator mSpanLocator; //span lookup on the knot vector
 
     ValuesContainerType mCtrlWeights;//weight of control points
 
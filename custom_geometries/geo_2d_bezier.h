@@ -28,6 +28,8 @@ see isogeometric_application/LICENSE.txt
 #include "integration/quadrature.h"
 #include "custom_utilities/bspline_utils.h"
 #include "custom_utilities/bezier_utils.h"
+#include "custom_utilities/extraction_operator_pool.h"
+#include "custom_utilities/bezier_kernels.h"
 //#include "integration/quadrature.h"
 //#include "integration/line_gauss_legendre_integration_points.h"
 
@@ -170,6 +172,7 @@ public:
      * Type of Matrix
      */
     typedef typename BaseType::MatrixType MatrixType;
+    typedef typename BaseType::ExtractionOperatorPointerType ExtractionOperatorPointerType;
     typedef boost::numeric::ublas::compressed_matrix<typename MatrixType::value_type> CompressedMatrixType;
 
     /**
@@ -182,18 +185,24 @@ public:
      */
     typedef typename BaseType::NormalType ValuesContainerType;
 
+    /**
+     * Type of the fixed-degree shape functions kernel
+     */
+    typedef BezierKernelSelector<VectorType, MatrixType, ValuesContainerType> KernelSelectorType;
+    typedef typename KernelSelectorType::ShapeFunctionsKernel2DType ShapeFunctionsKernelType;
+
     /**
      * Life Cycle
      */
 
     Geo2dBezier()
 //    : BaseType( PointsArrayType(), &msGeometryData )
-    : BaseType( PointsArrayType() ), mpBezierGeometryData(NULL)
+    : BaseType( PointsArrayType() ), mpBezierGeometryData(NULL), mpShapeFunctionsKernel(NULL)
     {}
 
     Geo2dBezier( const PointsArrayType& ThisPoints )
 //    : BaseType( ThisPoints, &msGeometryData )
-    : BaseType( ThisPoints ), mpBezierGeometryData(NULL)
+    : BaseType( ThisPoints ), mpBezierGeometryData(NULL), mpShapeFunctionsKernel(NULL)
     {}
 
 //    Geo2dBezier( const PointsArrayType& ThisPoints, const GeometryData* pGeometryData )
@@ -210,7 +219,7 @@ public:
      * source geometry's points too.
      */
     Geo2dBezier( Geo2dBezier const& rOther )
-    : BaseType( rOther ), mpBezierGeometryData(NULL)
+    : BaseType( rOther ), mpBezierGeometryData(NULL), mpShapeFunctionsKernel(NULL)
     {}
 
     /**
@@ -225,7 +234,7 @@ public:
      * source geometry's points too.
      */
     template<class TOtherPointType> Geo2dBezier( Geo2dBezier<TOtherPointType> const& rOther )
-    : BaseType( rOther ), mpBezierGeometryData(NULL)
+    : BaseType( rOther ), mpBezierGeometryData(NULL), mpShapeFunctionsKernel(NULL)
     {}
 
     /**
@@ -284,7 +293,7 @@ public:
         if (mpBezierGeometryData != NULL)
         {
             pNewGeom->AssignGeometryData(DummyKnots, DummyKnots, DummyKnots,
-                mCtrlWeights, mExtractionOperator, mOrder1, mOrder2, 0,
+                mCtrlWeights, mpExtractionOperator, mOrder1, mOrder2, 0,
                 static_cast<int>(mpBezierGeometryData->DefaultIntegrationMethod()) + 1);
         }
         return pNewGeom;
@@ -323,6 +332,23 @@ public:
         return GeometryData::Kratos_Bezier2D;
     }
 
+    /**
+     * The shape function tables are determined by the integration rule, the extraction operator and the normalized weights
+     */
+    virtual bool GetShapeFunctionsTableKey(ShapeFunctionsTableCache::KeyType& rKey, IntegrationMethod ThisMethod) const
+    {
+        if(mpBezierGeometryData == NULL)
+            return false;
+
+        rKey.AddInteger(mOrder1);
+        rKey.AddInteger(mOrder2);
+        rKey.AddInteger(static_cast<int>(ThisMethod));
+        rKey.AddObject(mpBezierGeometryData);
+        rKey.AddObject(mpExtractionOperator);
+        rKey.SetWeights(mCtrlWeights);
+        return true;
+    }
+
     virtual void CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
         MatrixType& shape_functions_values,
         ShapeFunctionsGradientsType& shape_functions_local_gradients,
@@ -341,7 +367,7 @@ public:
         #ifdef DEBUG_LEVEL3
         KRATOS_WATCH(NumberOfIntegrationPoints)
         KRATOS_WATCH(mCtrlWeights)
-        KRATOS_WATCH(mExtractionOperator)
+        KRATOS_WATCH(*mpExtractionOperator)
         KRATOS_WATCH(mNumber1)
         KRATOS_WATCH(mNumber2)
         KRATOS_WATCH(this->PointsNumber())
@@ -355,8 +381,26 @@ public:
 //                = this->ShapeFunctionsLocalGradients(ThisMethod); // this is correct but dangerous
             = mpBezierGeometryData->ShapeFunctionsLocalGradients( ThisMethod );
 
+        //use the fixed-degree kernel if available
+        if(mpShapeFunctionsKernel != NULL)
+        {
+            const IntegrationPointsArrayType& integration_points = mpBezierGeometryData->IntegrationPoints( ThisMethod );
+            double temp_values[KernelSelectorType::MaxNumberOfNodes2D];
+            for(IndexType i = 0; i < NumberOfIntegrationPoints; ++i)
+            {
+                mpShapeFunctionsKernel(temp_values, shape_functions_local_gradients[i], *mpExtractionOperator,
+                        mCtrlWeights, mBezierWeights, integration_points[i].X(), integration_points[i].Y());
+                for(IndexType j = 0; j < this->PointsNumber(); ++j)
+                    shape_functions_values(i, j) = temp_values[j];
+            }
+            return;
+        }
+
+        //get the Bezier weight and the denominators (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
+        const bool has_denominators = (static_cast<IndexType>(ThisMethod) < mBezierDenominators.size());
+
         VectorType temp_bezier_values(bezier_functions_values.size2());
-        VectorType bezier_weights(mNumber1*mNumber2);
         double denom, tmp1, tmp2;
         VectorType tmp_gradients1(this->PointsNumber());
         VectorType tmp_gradients2(this->PointsNumber());
@@ -364,12 +408,13 @@ public:
         {
             noalias(temp_bezier_values) = row(bezier_functions_values, i);
 
-            //compute the Bezier weight
-            noalias(bezier_weights) = prod(trans(mExtractionOperator), mCtrlWeights);
-            denom = inner_prod(temp_bezier_values, bezier_weights);
+            if(has_denominators)
+                denom = mBezierDenominators[ThisMethod](i);
+            else
+                denom = inner_prod(temp_bezier_values, bezier_weights);
 
             //compute the shape function values
-            VectorType temp_values = prod(mExtractionOperator, temp_bezier_values);
+            VectorType temp_values = prod(*mpExtractionOperator, temp_bezier_values);
             for(IndexType j = 0; j < this->PointsNumber(); ++j)
                 shape_functions_values(i, j) = (temp_values(j) * mCtrlWeights(j)) / denom;
 
@@ -378,10 +423,10 @@ public:
             tmp1 = inner_prod(row(bezier_functions_local_gradients[i], 0), bezier_weights);
             tmp2 = inner_prod(row(bezier_functions_local_gradients[i], 1), bezier_weights);
 
-            noalias(tmp_gradients1) = prod(mExtractionOperator,
+            noalias(tmp_gradients1) = prod(*mpExtractionOperator,
                     (1 / denom) * row(bezier_functions_local_gradients[i], 0) - (tmp1 / pow(denom, 2)) * temp_bezier_values );
 
-            noalias(tmp_gradients2) = prod(mExtractionOperator,
+            noalias(tmp_gradients2) = prod(*mpExtractionOperator,
                     (1 / denom) * row(bezier_functions_local_gradients[i], 1) - (tmp2 / pow(denom, 2)) * temp_bezier_values );
 
             for(IndexType j = 0; j < this->PointsNumber(); ++j)
@@ -624,14 +669,14 @@ public:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         if(rResults.size() != this->PointsNumber())
             rResults.resize(this->PointsNumber(), false);
-        noalias( rResults ) = prod(mExtractionOperator, bezier_functions_values);
+        noalias( rResults ) = prod(*mpExtractionOperator, bezier_functions_values);
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             rResults(i) *= (mCtrlWeights(i) / denom);
 
@@ -647,6 +692,14 @@ public:
         std::cout << typeid(*this).name() << "::" << __FUNCTION__ << std::endl;
         #endif
 
+        if(mpShapeFunctionsKernel != NULL)
+        {
+            double temp_values[KernelSelectorType::MaxNumberOfNodes2D];
+            mpShapeFunctionsKernel(temp_values, rResults, *mpExtractionOperator,
+                    mCtrlWeights, mBezierWeights, rCoordinates[0], rCoordinates[1]);
+            return rResults;
+        }
+
         //compute all univariate Bezier shape functions & derivatives at rPoint
         VectorType bezier_functions_values1(mNumber1);
         VectorType bezier_functions_values2(mNumber2);
@@ -686,8 +739,8 @@ public:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function local gradients
@@ -696,13 +749,13 @@ public:
         double tmp2 = inner_prod(bezier_functions_local_derivatives2, bezier_weights);
         VectorType tmp_gradients1 =
             prod(
-                mExtractionOperator,
+                *mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_derivatives1 -
                         (tmp1 / pow(denom, 2)) * bezier_functions_values
             );
         VectorType tmp_gradients2 =
             prod(
-                mExtractionOperator,
+                *mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_derivatives2 -
                         (tmp2 / pow(denom, 2)) * bezier_functions_values
             );
@@ -795,8 +848,8 @@ public:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function local second gradients
@@ -807,21 +860,21 @@ public:
         double auxs12 = inner_prod(bezier_functions_local_second_derivatives12, bezier_weights);
         double auxs22 = inner_prod(bezier_functions_local_second_derivatives22, bezier_weights);
         VectorType tmp_gradients11 =
-            prod(mExtractionOperator,
+            prod(*mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_second_derivatives11
                     - (aux1 / pow(denom, 2)) * bezier_functions_local_derivatives1 * 2
                     - (auxs11 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * pow(aux1, 2) / pow(denom, 3) * bezier_functions_values
             );
         VectorType tmp_gradients12 =
-            prod(mExtractionOperator,
+            prod(*mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_second_derivatives12
                     - ((aux1 + aux2) / pow(denom, 2)) * bezier_functions_local_derivatives1
                     - (auxs12 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * aux1 * aux2 / pow(denom, 3) * bezier_functions_values
             );
         VectorType tmp_gradients22 =
-            prod(mExtractionOperator,
+            prod(*mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_second_derivatives22
                     - (aux2 / pow(denom, 2)) * bezier_functions_local_derivatives2 * 2
                     - (auxs22 / pow(denom, 2)) * bezier_functions_values
@@ -849,8 +902,8 @@ public:
         rPoints.clear();
         rPoints.reserve(number_of_local_points);
 
-        // compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        // get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
 
         // compute the Bezier control points
         typedef typename PointType::Pointer PointPointerType;
@@ -858,7 +911,7 @@ public:
         {
             PointPointerType pPoint = PointPointerType(new PointType(0, 0.0, 0.0, 0.0));
             for(std::size_t j = 0; j < number_of_points; ++j)
-                noalias(*pPoint) += mExtractionOperator(j, i) * this->GetPoint(j) * mCtrlWeights[j] / bezier_weights[i];
+                noalias(*pPoint) += (*mpExtractionOperator)(j, i) * this->GetPoint(j) * mCtrlWeights[j] / bezier_weights[i];
             pPoint->SetInitialPosition(*pPoint);
             pPoint->SetSolutionStepVariablesList(this->GetPoint(0).pGetVariablesList());
             pPoint->SetBufferSize(this->GetPoint(0).GetBufferSize());
@@ -890,15 +943,15 @@ public:
         if (rValues.size() != number_of_local_points)
             rValues.resize(number_of_local_points);
 
-        // compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        // get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
 
         // compute the Bezier control points
         for(std::size_t i = 0; i < number_of_local_points; ++i)
         {
             rValues[i] = TDataType(0.0);
             for(std::size_t j = 0; j < number_of_points; ++j)
-                rValues[i] += mExtractionOperator(j, i) * this->GetPoint(j).GetSolutionStepValue(rVariable) * mCtrlWeights[j] / bezier_weights[i];
+                rValues[i] += (*mpExtractionOperator)(j, i) * this->GetPoint(j).GetSolutionStepValue(rVariable) * mCtrlWeights[j] / bezier_weights[i];
         }
     }
 
@@ -974,23 +1027,48 @@ public:
         const int& Degree3, //not used
         const int& NumberOfIntegrationMethod
     )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator),
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
+    /**
+     * Assign the geometry data with the extraction operator shared with the cell (or the other geometries); the operator is not copied.
+     */
+    virtual void AssignGeometryData(
+        const ValuesContainerType& Knots1, //not used
+        const ValuesContainerType& Knots2, //not used
+        const ValuesContainerType& Knots3, //not used
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3, //not used
+        const int& NumberOfIntegrationMethod
+    )
     {
         mCtrlWeights = Weights;
         mOrder1 = Degree1;
         mOrder2 = Degree2;
         mNumber1 = mOrder1 + 1;
         mNumber2 = mOrder2 + 1;
-        // TODO we have to check here if the compressed_matrix copy is called or not. Otherwise, maybe the full matrix is populated.
-        mExtractionOperator = ExtractionOperator;
+        mpExtractionOperator = pExtractionOperator;
 
         // size checking
-        if(mExtractionOperator.size1() != this->PointsNumber())
-            KRATOS_THROW_ERROR(std::logic_error, "The number of row of extraction operator must be equal to number of nodes, mExtractionOperator.size1() =", mExtractionOperator.size1())
-        if(mExtractionOperator.size2() != mNumber1*mNumber2)
-            KRATOS_THROW_ERROR(std::logic_error, "The number of column of extraction operator must be equal to (p_u+1) * (p_v+1), mExtractionOperator.size2() =", mExtractionOperator.size2())
+        if(mpExtractionOperator->size1() != this->PointsNumber())
+            KRATOS_THROW_ERROR(std::logic_error, "The number of row of extraction operator must be equal to number of nodes, mExtractionOperator.size1() =", mpExtractionOperator->size1())
+        if(mpExtractionOperator->size2() != mNumber1*mNumber2)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of column of extraction operator must be equal to (p_u+1) * (p_v+1), mExtractionOperator.size2() =", mpExtractionOperator->size2())
         if(mCtrlWeights.size() != this->PointsNumber())
             KRATOS_THROW_ERROR(std::logic_error, "The number of weights must be equal to number of nodes", __FUNCTION__)
 
+        // compute the Bezier weights once, they are reused by all shape function evaluations
+        mBezierWeights = prod(trans(*mpExtractionOperator), mCtrlWeights);
+        mBezierDenominators.clear();
+
+        // select the fixed-degree kernel, NULL if the degree is not specialized or the nodes do not fit its buffer
+        mpShapeFunctionsKernel = KernelSelectorType::Select2D(mOrder1, mOrder2, this->PointsNumber());
+
         if(NumberOfIntegrationMethod > 0)
         {
             // find the existing integration rule or create new one if not existed
@@ -999,7 +1077,13 @@ public:
             // get the geometry_data according to integration rule. Note that this is a static geometry_data of a reference Bezier element, not the real Bezier element.
             mpBezierGeometryData = BezierUtils::RetrieveIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degree1, Degree2);
             BaseType::mpGeometryData = &(*mpBezierGeometryData);
+
+            // compute the rational denominators at the integration points
+            this->ComputeBezierDenominators(NumberOfIntegrationMethod);
         }
+
+        // the tables are computed here under the eager precompute policy
+        this->ResetPrecomputedTables();
     }
 
 protected:
@@ -1007,17 +1091,36 @@ protected:
 //    static const GeometryData msGeometryData;
     GeometryData::Pointer mpBezierGeometryData;
 
-    MatrixType mExtractionOperator;
+    typename ExtractionOperatorPool<MatrixType>::PointerType mpExtractionOperator; //extraction operator, shared with the cell and the other geometries having the same operator
     // CompressedMatrixType mExtractionOperator;
 
     ValuesContainerType mCtrlWeights; //weight of control points
 
+    VectorType mBezierWeights; //weight of Bezier control points, i.e. trans(mExtractionOperator) * mCtrlWeights
+    std::vector<VectorType> mBezierDenominators; //denominator W(xi) at the integration points of each integration method
+
     int mOrder1; //order of the surface at parametric direction 1
     int mOrder2; //order of the surface at parametric direction 2
 
     int mNumber1; //number of bezier shape functions define the surface on parametric direction 1
     int mNumber2; //number of bezier shape functions define the surface on parametric direction 2
 
+    ShapeFunctionsKernelType mpShapeFunctionsKernel; //fixed-degree shape functions kernel, NULL if not available for this degree
+
+    /**
+     * Compute the denominator W(xi) = sum_i B_i(xi) * w^b_i at the integration points of all integration methods
+     */
+    void ComputeBezierDenominators(const int& NumberOfIntegrationMethod)
+    {
+        mBezierDenominators.resize(NumberOfIntegrationMethod);
+        for(int i = 0; i < NumberOfIntegrationMethod; ++i)
+        {
+            const MatrixType& bezier_functions_values
+                = mpBezierGeometryData->ShapeFunctionsValues( static_cast<IntegrationMethod>(i) );
+            mBezierDenominators[i] = prod(bezier_functions_values, mBezierWeights);
+        }
+    }
+
 private:
 
     /**
@@ -1057,6 +1160,17 @@ private:
         std::cout << typeid(*this).name() << "::" << __FUNCTION__ << std::endl;
         #endif
 
+        if(mpShapeFunctionsKernel != NULL)
+        {
+            double temp_values[KernelSelectorType::MaxNumberOfNodes2D];
+            mpShapeFunctionsKernel(temp_values, shape_functions_local_gradients, *mpExtractionOperator,
+                    mCtrlWeights, mBezierWeights, rPoint[0], rPoint[1]);
+            if(shape_functions_values.size() != this->PointsNumber())
+                shape_functions_values.resize(this->PointsNumber(), false);
+            std::copy(temp_values, temp_values + this->PointsNumber(), shape_functions_values.begin());
+            return;
+        }
+
         //compute all univariate Bezier shape functions & derivatives at rPoint
         VectorType bezier_functions_values1(mNumber1);
         VectorType bezier_functions_values2(mNumber2);
@@ -1096,14 +1210,14 @@ private:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         if(shape_functions_values.size() != this->PointsNumber())
             shape_functions_values.resize(this->PointsNumber(), false);
-        noalias( shape_functions_values ) = prod(mExtractionOperator, bezier_functions_values);
+        noalias( shape_functions_values ) = prod(*mpExtractionOperator, bezier_functions_values);
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             shape_functions_values(i) *= (mCtrlWeights(i) / denom);
 
@@ -1113,9 +1227,9 @@ private:
             shape_functions_local_gradients.resize(this->PointsNumber(), 2, false);
         double tmp1 = inner_prod(bezier_functions_local_derivatives1, bezier_weights);
         double tmp2 = inner_prod(bezier_functions_local_derivatives2, bezier_weights);
-        VectorType tmp_gradients1 = prod(mExtractionOperator,
+        VectorType tmp_gradients1 = prod(*mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_derivatives1 - (tmp1 / pow(denom, 2)) * bezier_functions_values );
-        VectorType tmp_gradients2 = prod(mExtractionOperator,
+        VectorType tmp_gradients2 = prod(*mpExtractionOperator,
                     (1 / denom) * bezier_functions_local_derivatives2 - (tmp2 / pow(denom, 2)) * bezier_functions_values );
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
         {
@@ -170,6 +170,7 @@ public:
      * Type of Matrix
      */
     typedef typename BaseType::MatrixType MatrixType;
+    typedef typename BaseType::ExtractionOperatorPointerType ExtractionOperatorPointerType;
 
     /**
      * Type of Vector
@@ -280,7 +281,7 @@ public:
         if (BaseType::mpBezierGeometryData != NULL)
         {
             pNewGeom->AssignGeometryData(DummyKnots, DummyKnots, DummyKnots,
-                BaseType::mCtrlWeights, BaseType::mExtractionOperator, BaseType::mOrder1, BaseType::mOrder2, 0,
+                BaseType::mCtrlWeights, BaseType::mpExtractionOperator, BaseType::mOrder1, BaseType::mOrder2, 0,
                 static_cast<int>(BaseType::mpBezierGeometryData->DefaultIntegrationMethod()) + 1);
         }
         return pNewGeom;
@@ -577,6 +578,25 @@ public:
         const int& Degree3, //not used
         const int& NumberOfIntegrationMethod
     )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator),
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
+    /**
+     * Assign the geometry data with the extraction operator shared with the cell (or the other geometries); the operator is not copied.
+     */
+    virtual void AssignGeometryData(
+        const ValuesContainerType& Knots1, //not used
+        const ValuesContainerType& Knots2, //not used
+        const ValuesContainerType& Knots3, //not used
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3, //not used
+        const int& NumberOfIntegrationMethod
+    )
     {
         BaseType::mCtrlWeights = Weights;
         BaseType::mOrder1 = Degree1;
@@ -584,17 +604,23 @@ public:
         BaseType::mNumber1 = BaseType::mOrder1 + 1;
         BaseType::mNumber2 = BaseType::mOrder2 + 1;
 
-        // TODO we have to check here if the compressed_matrix copy is called or not. Otherwise, maybe the full matrix is populated.
-        BaseType::mExtractionOperator = ExtractionOperator;
+        BaseType::mpExtractionOperator = pExtractionOperator;
 
         // size checking
-        if(BaseType::mExtractionOperator.size1() != this->PointsNumber())
-            KRATOS_THROW_ERROR(std::logic_error, "The number of row of extraction operator must be equal to number of nodes, mExtractionOperator.size1() =", BaseType::mExtractionOperator.size1())
-        if(BaseType::mExtractionOperator.size2() != BaseType::mNumber1*BaseType::mNumber2)
-            KRATOS_THROW_ERROR(std::logic_error, "The number of column of extraction operator must be equal to (p_u+1) * (p_v+1), mExtractionOperator.size2() =", BaseType::mExtractionOperator.size2())
+        if(BaseType::mpExtractionOperator->size1() != this->PointsNumber())
+            KRATOS_THROW_ERROR(std::logic_error, "The number of row of extraction operator must be equal to number of nodes, mExtractionOperator.size1() =", BaseType::mpExtractionOperator->size1())
+        if(BaseType::mpExtractionOperator->size2() != BaseType::mNumber1*BaseType::mNumber2)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of column of extraction operator must be equal to (p_u+1) * (p_v+1), mExtractionOperator.size2() =", BaseType::mpExtractionOperator->size2())
         if(BaseType::mCtrlWeights.size() != this->PointsNumber())
             KRATOS_THROW_ERROR(std::logic_error, "The number of weights must be equal to number of nodes", __FUNCTION__)
 
+        // compute the Bezier weights once, they are reused by all shape function evaluations
+        BaseType::mBezierWeights = prod(trans(*BaseType::mpExtractionOperator), BaseType::mCtrlWeights);
+        BaseType::mBezierDenominators.clear();
+
+        // select the fixed-degree kernel, NULL if the degree is not specialized or the nodes do not fit its buffer
+        BaseType::mpShapeFunctionsKernel = BaseType::KernelSelectorType::Select2D(BaseType::mOrder1, BaseType::mOrder2, this->PointsNumber());
+
         if (NumberOfIntegrationMethod > 0)
         {
             // find the existing integration rule or create new one if not existed
@@ -603,7 +629,13 @@ public:
             // get the geometry_data according to integration rule. Note that this is a static geometry_data of a reference Bezier element, not the real Bezier element.
             BaseType::mpBezierGeometryData = BezierUtils::RetrieveIntegrationRule<2, 3, 2>(NumberOfIntegrationMethod, Degree1, Degree2);
             BaseType::BaseType::mpGeometryData = &(*BaseType::mpBezierGeometryData);
+
+            // compute the rational denominators at the integration points
+            BaseType::ComputeBezierDenominators(NumberOfIntegrationMethod);
         }
+
+        // the tables are computed here under the eager precompute policy
+        this->ResetPrecomputedTables();
     }
 
 protected:
@@ -60,6 +60,7 @@
 #include "custom_geometries/isogeometric_geometry.h"
 #include "integration/quadrature.h"
 #include "custom_utilities/bspline_utils.h"
+#include "custom_utilities/nurbs/knot_span_locator.h"
 #include "integration/quadrature.h"
 #include "integration/line_gauss_legendre_integration_points.h"
 
@@ -965,8 +966,8 @@ public:
         int Index1 = ShapeFunctionIndex / mNumber2;
         int Index2 = ShapeFunctionIndex % mNumber2;
 
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rPoint[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rPoint[1], mKnots2);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
 
         #ifdef DEBUG_LEVEL1
         KRATOS_WATCH(Span1)
@@ -1038,8 +1039,8 @@ public:
         ValuesContainerType ShapeFunctionValues1(mOrder1 + 1);
         ValuesContainerType ShapeFunctionValues2(mOrder2 + 1);
 
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rCoordinates[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rCoordinates[1], mKnots2);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rCoordinates[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rCoordinates[1]);
 
         BSplineUtils::BasisFuns(ShapeFunctionValues1, Span1, rCoordinates[0], mOrder1, mKnots1);
         BSplineUtils::BasisFuns(ShapeFunctionValues2, Span2, rCoordinates[1], mOrder2, mKnots2);
@@ -1088,8 +1089,8 @@ public:
         const int NumberOfDerivatives = 1;
         Matrix ShapeFunctionsValuesAndDerivatives1(NumberOfDerivatives + 1, mOrder1 + 1);
         Matrix ShapeFunctionsValuesAndDerivatives2(NumberOfDerivatives + 1, mOrder2 + 1);
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rPoint[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rPoint[1], mKnots2);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
         int Start1 = Span1 - mOrder1;
         int Start2 = Span2 - mOrder2;
         BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives1, Span1, rPoint[0], mOrder1, mKnots1, NumberOfDerivatives, BSplineUtils::MatrixOp());
@@ -1171,8 +1172,8 @@ public:
         const int NumberOfDerivatives = 1;
         Matrix ShapeFunctionsValuesAndDerivatives1(NumberOfDerivatives + 1, mOrder1 + 1);
         Matrix ShapeFunctionsValuesAndDerivatives2(NumberOfDerivatives + 1, mOrder2 + 1);
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rPoint[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rPoint[1], mKnots2);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
         int Start1 = Span1 - mOrder1;
         int Start2 = Span2 - mOrder2;
 
@@ -1351,6 +1352,8 @@ public:
     {
         mKnots1 = Knots1;
         mKnots2 = Knots2;
+        mSpanLocator1.Initialize(mKnots1);
+        mSpanLocator2.Initialize(mKnots2);
         mCtrlWeights = Weights;
         mOrder1 = Degree1;
         mOrder2 = Degree2;
@@ -1484,6 +1487,8 @@ private:
 
     ValuesContainerType mKnots1; //knots vector
     ValuesContainerType mKnots2;//knots vector
+    KnotSpanLocator mSpanLocator1; //span lookup on the knot vector
+    KnotSpanLocator mSpanLocator2; //span lookup on the knot vector
 
     ValuesContainerType mCtrlWeights;//weight of control points
 
@@ -14,6 +14,7 @@ see isogeometric_application/LICENSE.txt
 
 // System includes
 #include <iostream>
+#include <map>
 
 // External includes
 #include <boost/array.hpp>
@@ -27,6 +28,7 @@ see isogeometric_application/LICENSE.txt
 #include "custom_geometries/isogeometric_geometry.h"
 #include "integration/quadrature.h"
 #include "custom_utilities/bspline_utils.h"
+#include "custom_utilities/extraction_operator_pool.h"
 //#include "integration/quadrature.h"
 //#include "integration/line_gauss_legendre_integration_points.h"
 
@@ -169,6 +171,7 @@ public:
      * Type of Matrix
      */
     typedef typename BaseType::MatrixType MatrixType;
+    typedef typename BaseType::ExtractionOperatorPointerType ExtractionOperatorPointerType;
 
     /**
      * Type of Vector
@@ -180,18 +183,30 @@ public:
      */
     typedef typename BaseType::NormalType ValuesContainerType;
 
+    /**
+     * Univariate Bernstein values (B) and derivatives (D) tables (number of points x (p+1)) on each parametric direction
+     * at the tensor-product integration points of an integration method
+     */
+    struct UnivariateBernsteinTables
+    {
+        bool IsTensorProduct;
+        MatrixType B1, D1, B2, D2, B3, D3;
+    };
+    typedef std::vector<UnivariateBernsteinTables> UnivariateBernsteinTablesContainerType;
+    typedef boost::shared_ptr<const UnivariateBernsteinTablesContainerType> UnivariateBernsteinTablesContainerPointerType;
+
     /**
      * Life Cycle
      */
 
     Geo3dBezier()
 //    : BaseType( PointsArrayType(), &msGeometryData )
-    : BaseType( PointsArrayType() ), mpBezierGeometryData(NULL)
+    : BaseType( PointsArrayType() ), mpBezierGeometryData(NULL), mIsExtractionOperatorFactored(false)
     {}
 
     Geo3dBezier( const PointsArrayType& ThisPoints )
 //    : BaseType( ThisPoints, &msGeometryData )
-    : BaseType( ThisPoints ), mpBezierGeometryData(NULL)
+    : BaseType( ThisPoints ), mpBezierGeometryData(NULL), mIsExtractionOperatorFactored(false)
     {
     }
 
@@ -205,7 +220,7 @@ public:
      * source geometry's points too.
      */
     Geo3dBezier( Geo3dBezier const& rOther )
-    : BaseType( rOther ), mpBezierGeometryData(NULL)
+    : BaseType( rOther ), mpBezierGeometryData(NULL), mIsExtractionOperatorFactored(false)
     {}
 
     /**
@@ -220,7 +235,7 @@ public:
      * source geometry's points too.
      */
     template<class TOtherPointType> Geo3dBezier( Geo3dBezier<TOtherPointType> const& rOther )
-    : BaseType( rOther ), mpBezierGeometryData(NULL)
+    : BaseType( rOther ), mpBezierGeometryData(NULL), mIsExtractionOperatorFactored(false)
     {}
 
     /**
@@ -278,9 +293,15 @@ public:
         if (mpBezierGeometryData != NULL)
         {
             ValuesContainerType DummyKnots;
-            pNewGeom->AssignGeometryData(DummyKnots, DummyKnots, DummyKnots,
-                mCtrlWeights, mExtractionOperator, mOrder1, mOrder2, mOrder3,
-                static_cast<int>(mpBezierGeometryData->DefaultIntegrationMethod()) + 1);
+            if (mIsExtractionOperatorFactored)
+                pNewGeom->AssignGeometryData(DummyKnots, DummyKnots, DummyKnots,
+                    mCtrlWeights, mpExtractionOperator1, mpExtractionOperator2, mpExtractionOperator3,
+                    mOrder1, mOrder2, mOrder3,
+                    static_cast<int>(mpBezierGeometryData->DefaultIntegrationMethod()) + 1);
+            else
+                pNewGeom->AssignGeometryData(DummyKnots, DummyKnots, DummyKnots,
+                    mCtrlWeights, mpExtractionOperator, mOrder1, mOrder2, mOrder3,
+                    static_cast<int>(mpBezierGeometryData->DefaultIntegrationMethod()) + 1);
         }
         return pNewGeom;
     }
@@ -318,6 +339,32 @@ public:
         return GeometryData::Kratos_Bezier3D;
     }
 
+    /**
+     * The shape function tables are determined by the integration rule, the extraction operator and the normalized weights.
+     * In the factored case, the shared 1D operators identify the operator.
+     */
+    virtual bool GetShapeFunctionsTableKey(ShapeFunctionsTableCache::KeyType& rKey, IntegrationMethod ThisMethod) const
+    {
+        if(mpBezierGeometryData == NULL)
+            return false;
+
+        rKey.AddInteger(mOrder1);
+        rKey.AddInteger(mOrder2);
+        rKey.AddInteger(mOrder3);
+        rKey.AddInteger(static_cast<int>(ThisMethod));
+        rKey.AddObject(mpBezierGeometryData);
+        if(mIsExtractionOperatorFactored)
+        {
+            rKey.AddObject(mpExtractionOperator1);
+            rKey.AddObject(mpExtractionOperator2);
+            rKey.AddObject(mpExtractionOperator3);
+        }
+        else
+            rKey.AddObject(mpExtractionOperator);
+        rKey.SetWeights(mCtrlWeights);
+        return true;
+    }
+
     /**
      * This method calculates and returns Length or characteristic
      * length of this geometry depending on it's dimension. For one
@@ -334,12 +381,33 @@ public:
 
     /**
      * Compute shape function values and local gradients at every integration points of an integration method.
+     * If the integration points are of tensor-product form, the values are computed by sum factorization.
      */
     virtual void CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
         MatrixType& shape_functions_values,
         ShapeFunctionsGradientsType& shape_functions_local_gradients,
         IntegrationMethod ThisMethod
     ) const
+    {
+        const UnivariateBernsteinTables* pTables = this->GetUnivariateBernsteinTables(ThisMethod);
+        if(pTables != NULL)
+            this->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradientsSumFactorization(
+                shape_functions_values, shape_functions_local_gradients,
+                pTables->B1, pTables->D1, pTables->B2, pTables->D2, pTables->B3, pTables->D3);
+        else
+            this->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradientsDense(
+                shape_functions_values, shape_functions_local_gradients, ThisMethod);
+    }
+
+    /**
+     * Compute shape function values and local gradients at every integration points of an integration method,
+     * using the trivariate Bezier shape functions tabulated in the reference Bezier geometry data.
+     */
+    void CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradientsDense(
+        MatrixType& shape_functions_values,
+        ShapeFunctionsGradientsType& shape_functions_local_gradients,
+        IntegrationMethod ThisMethod
+    ) const
     {
         #ifdef DEBUG_LEVEL3
         std::cout << typeid(*this).name() << "::" << __FUNCTION__ << std::endl;
@@ -363,9 +431,13 @@ public:
         const ShapeFunctionsGradientsType& bezier_functions_local_gradients
             = mpBezierGeometryData->ShapeFunctionsLocalGradients( ThisMethod );
 
+        //get the Bezier weight and the denominators (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
+        const bool has_denominators = (static_cast<IndexType>(ThisMethod) < mBezierDenominators.size());
+
         VectorType temp_bezier_values(bezier_functions_values.size2());
-        VectorType bezier_weights(mNumber1 * mNumber2 * mNumber3);
         double denom, tmp1, tmp2, tmp3;
+        VectorType temp_values(this->PointsNumber());
         VectorType tmp_gradients1(this->PointsNumber());
         VectorType tmp_gradients2(this->PointsNumber());
         VectorType tmp_gradients3(this->PointsNumber());
@@ -373,12 +445,13 @@ public:
         {
             noalias(temp_bezier_values) = row(bezier_functions_values, i);
 
-            //compute the Bezier weight
-            noalias(bezier_weights) = prod(trans(mExtractionOperator), mCtrlWeights);
-            denom = inner_prod(temp_bezier_values, bezier_weights);
+            if(has_denominators)
+                denom = mBezierDenominators[ThisMethod](i);
+            else
+                denom = inner_prod(temp_bezier_values, bezier_weights);
 
             //compute the shape function values
-            VectorType temp_values = prod(mExtractionOperator, temp_bezier_values);
+            this->ApplyExtractionOperator(temp_values, temp_bezier_values);
             for(IndexType j = 0; j < this->PointsNumber(); ++j)
                 shape_functions_values(i, j) = (temp_values(j) * mCtrlWeights(j) / denom);
 
@@ -388,13 +461,13 @@ public:
             tmp2 = inner_prod(row(bezier_functions_local_gradients[i], 1), bezier_weights);
             tmp3 = inner_prod(row(bezier_functions_local_gradients[i], 2), bezier_weights);
 
-            noalias(tmp_gradients1) = prod( mExtractionOperator,
+            this->ApplyExtractionOperator(tmp_gradients1,
                         (1 / denom) * row(bezier_functions_local_gradients[i], 0) - (tmp1 / pow(denom, 2)) * temp_bezier_values );
 
-            noalias(tmp_gradients2) = prod(mExtractionOperator,
+            this->ApplyExtractionOperator(tmp_gradients2,
                         (1 / denom) * row(bezier_functions_local_gradients[i], 1) - (tmp2 / pow(denom, 2)) * temp_bezier_values );
 
-            noalias(tmp_gradients3) = prod(mExtractionOperator,
+            this->ApplyExtractionOperator(tmp_gradients3,
                         (1 / denom) * row(bezier_functions_local_gradients[i], 2) - (tmp3 / pow(denom, 2)) * temp_bezier_values );
 
             for(IndexType j = 0; j < this->PointsNumber(); ++j)
@@ -406,11 +479,174 @@ public:
         }
     }
 
+    /**
+     * Compute shape function values and local gradients at the tensor-product integration points, given the univariate
+     * Bernstein values (B) and derivatives (D) tables (number of points x (p+1)) on each parametric direction.
+     * The values are computed dimension by dimension instead of forming the trivariate Bezier shape functions at each point.
+     */
+    void CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradientsSumFactorization(
+        MatrixType& shape_functions_values,
+        ShapeFunctionsGradientsType& shape_functions_local_gradients,
+        const MatrixType& B1, const MatrixType& D1,
+        const MatrixType& B2, const MatrixType& D2,
+        const MatrixType& B3, const MatrixType& D3
+    ) const
+    {
+        const IndexType q1 = B1.size1();
+        const IndexType q2 = B2.size1();
+        const IndexType q3 = B3.size1();
+        const IndexType NumberOfIntegrationPoints = q1 * q2 * q3;
+        const IndexType NumberOfNodes = this->PointsNumber();
+
+        // the denominator and its local derivatives
+        VectorType denom, denom_der1, denom_der2, denom_der3;
+        this->EvaluateTensorProduct(denom, denom_der1, denom_der2, denom_der3,
+                mBezierWeights, B1, D1, B2, D2, B3, D3);
+
+        shape_functions_values.resize(NumberOfIntegrationPoints, NumberOfNodes, false);
+        if(shape_functions_local_gradients.size() != NumberOfIntegrationPoints)
+            shape_functions_local_gradients.resize(NumberOfIntegrationPoints);
+        for(IndexType pnt = 0; pnt < NumberOfIntegrationPoints; ++pnt)
+            shape_functions_local_gradients[pnt].resize(NumberOfNodes, 3, false);
+
+        // the polynomial (non-rational) functions C * B and their local derivatives are written to the results
+        // as soon as they are computed, the rational correction only needs the denominator at the same point
+        double aux;
+        if(mIsExtractionOperatorFactored)
+        {
+            // the functions are tensor-product of the univariate functions C1 * B1, C2 * B2 and C3 * B3
+            const IndexType n1 = mpExtractionOperator1->size1();
+            const IndexType n2 = mpExtractionOperator2->size1();
+            const IndexType n3 = mpExtractionOperator3->size1();
+            MatrixType N1 = prod(B1, trans(*mpExtractionOperator1));
+            MatrixType dN1 = prod(D1, trans(*mpExtractionOperator1));
+            MatrixType N2 = prod(B2, trans(*mpExtractionOperator2));
+            MatrixType dN2 = prod(D2, trans(*mpExtractionOperator2));
+            MatrixType N3 = prod(B3, trans(*mpExtractionOperator3));
+            MatrixType dN3 = prod(D3, trans(*mpExtractionOperator3));
+
+            IndexType pnt, node;
+            double r, dr1, dr2, dr3;
+            for(IndexType j1 = 0; j1 < q1; ++j1)
+                for(IndexType j2 = 0; j2 < q2; ++j2)
+                    for(IndexType j3 = 0; j3 < q3; ++j3)
+                    {
+                        pnt = j3 + (j2 + j1 * q2) * q3;
+                        MatrixType& rGradients = shape_functions_local_gradients[pnt];
+                        for(IndexType i = 0; i < n1; ++i)
+                            for(IndexType j = 0; j < n2; ++j)
+                                for(IndexType k = 0; k < n3; ++k)
+                                {
+                                    node = k + (j + i * n2) * n3;
+                                    r   = N1(j1, i)  * N2(j2, j)  * N3(j3, k);
+                                    dr1 = dN1(j1, i) * N2(j2, j)  * N3(j3, k);
+                                    dr2 = N1(j1, i)  * dN2(j2, j) * N3(j3, k);
+                                    dr3 = N1(j1, i)  * N2(j2, j)  * dN3(j3, k);
+                                    aux = mCtrlWeights(node) / denom(pnt);
+                                    shape_functions_values(pnt, node) = aux * r;
+                                    rGradients(node, 0) = aux * (dr1 - r * denom_der1(pnt) / denom(pnt));
+                                    rGradients(node, 1) = aux * (dr2 - r * denom_der2(pnt) / denom(pnt));
+                                    rGradients(node, 2) = aux * (dr3 - r * denom_der3(pnt) / denom(pnt));
+                                }
+                    }
+        }
+        else
+        {
+            // each row of the extraction operator is the Bezier coefficients of the respective function,
+            // the functions are evaluated one node at a time
+            VectorType coefficients(mNumber1 * mNumber2 * mNumber3);
+            VectorType values, derivatives1, derivatives2, derivatives3;
+            for(IndexType node = 0; node < NumberOfNodes; ++node)
+            {
+                noalias(coefficients) = row(*mpExtractionOperator, node);
+                this->EvaluateTensorProduct(values, derivatives1, derivatives2, derivatives3,
+                        coefficients, B1, D1, B2, D2, B3, D3);
+                for(IndexType pnt = 0; pnt < NumberOfIntegrationPoints; ++pnt)
+                {
+                    aux = mCtrlWeights(node) / denom(pnt);
+                    shape_functions_values(pnt, node) = aux * values(pnt);
+                    shape_functions_local_gradients[pnt](node, 0) = aux * (derivatives1(pnt) - values(pnt) * denom_der1(pnt) / denom(pnt));
+                    shape_functions_local_gradients[pnt](node, 1) = aux * (derivatives2(pnt) - values(pnt) * denom_der2(pnt) / denom(pnt));
+                    shape_functions_local_gradients[pnt](node, 2) = aux * (derivatives3(pnt) - values(pnt) * denom_der3(pnt) / denom(pnt));
+                }
+            }
+        }
+    }
+
+    /**
+     * Compute the Jacobian at the tensor-product integration points by sum factorization, given the univariate Bernstein
+     * tables as above. The nodal coordinates are converted to the homogeneous Bezier control points once, and the
+     * mapping is then contracted dimension by dimension. The shape functions are not formed.
+     * @param rCoordinates the coordinates of the nodes, each row for each node
+     */
+    JacobiansType& JacobianSumFactorization(
+        JacobiansType& rResult,
+        const MatrixType& rCoordinates,
+        const MatrixType& B1, const MatrixType& D1,
+        const MatrixType& B2, const MatrixType& D2,
+        const MatrixType& B3, const MatrixType& D3
+    ) const
+    {
+        const IndexType NumberOfIntegrationPoints = B1.size1() * B2.size1() * B3.size1();
+        const IndexType NumberOfNodes = this->PointsNumber();
+
+        if ( rResult.size() != NumberOfIntegrationPoints )
+        {
+            JacobiansType temp( NumberOfIntegrationPoints );
+            rResult.swap( temp );
+        }
+
+        // the denominator and its local derivatives
+        VectorType denom, denom_der[3];
+        this->EvaluateTensorProduct(denom, denom_der[0], denom_der[1], denom_der[2],
+                mBezierWeights, B1, D1, B2, D2, B3, D3);
+
+        VectorType weighted_coordinates(NumberOfNodes);
+        VectorType bezier_coordinates(mNumber1 * mNumber2 * mNumber3);
+        VectorType values, derivatives[3];
+        double x;
+        for(IndexType dim = 0; dim < 3; ++dim)
+        {
+            // homogeneous Bezier control points
+            for(IndexType node = 0; node < NumberOfNodes; ++node)
+                weighted_coordinates(node) = mCtrlWeights(node) * rCoordinates(node, dim);
+            this->ApplyTransposeExtractionOperator(bezier_coordinates, weighted_coordinates);
+
+            this->EvaluateTensorProduct(values, derivatives[0], derivatives[1], derivatives[2],
+                    bezier_coordinates, B1, D1, B2, D2, B3, D3);
+
+            for(IndexType pnt = 0; pnt < NumberOfIntegrationPoints; ++pnt)
+            {
+                if(dim == 0)
+                    rResult[pnt].resize(3, 3, false);
+                x = values(pnt) / denom(pnt);
+                for(IndexType k = 0; k < 3; ++k)
+                    rResult[pnt](dim, k) = (derivatives[k](pnt) - x * denom_der[k](pnt)) / denom(pnt);
+            }
+        }
+
+        return rResult;
+    }
+
     /**
      * Compute Jacobian at every integration points for an integration method
      */
     virtual JacobiansType& Jacobian( JacobiansType& rResult, IntegrationMethod ThisMethod ) const
     {
+        const UnivariateBernsteinTables* pTables = this->GetUnivariateBernsteinTables(ThisMethod);
+        if(pTables != NULL)
+        {
+            MatrixType coordinates(this->PointsNumber(), 3);
+            for ( IndexType i = 0; i < this->PointsNumber(); ++i )
+            {
+                coordinates(i, 0) = this->GetPoint( i ).X();
+                coordinates(i, 1) = this->GetPoint( i ).Y();
+                coordinates(i, 2) = this->GetPoint( i ).Z();
+            }
+            return this->JacobianSumFactorization(rResult, coordinates,
+                pTables->B1, pTables->D1, pTables->B2, pTables->D2, pTables->B3, pTables->D3);
+        }
+
         MatrixType shape_functions_values;
         ShapeFunctionsGradientsType shape_functions_local_gradients;
 
@@ -461,6 +697,20 @@ public:
      */
     virtual JacobiansType& Jacobian( JacobiansType& rResult, IntegrationMethod ThisMethod, Matrix& DeltaPosition ) const
     {
+        const UnivariateBernsteinTables* pTables = this->GetUnivariateBernsteinTables(ThisMethod);
+        if(pTables != NULL)
+        {
+            MatrixType coordinates(this->PointsNumber(), 3);
+            for ( IndexType i = 0; i < this->PointsNumber(); ++i )
+            {
+                coordinates(i, 0) = this->GetPoint( i ).X() - DeltaPosition(i, 0);
+                coordinates(i, 1) = this->GetPoint( i ).Y() - DeltaPosition(i, 1);
+                coordinates(i, 2) = this->GetPoint( i ).Z() - DeltaPosition(i, 2);
+            }
+            return this->JacobianSumFactorization(rResult, coordinates,
+                pTables->B1, pTables->D1, pTables->B2, pTables->D2, pTables->B3, pTables->D3);
+        }
+
         MatrixType shape_functions_values;
         ShapeFunctionsGradientsType shape_functions_local_gradients;
 
@@ -742,6 +992,20 @@ public:
      */
     virtual JacobiansType& Jacobian0( JacobiansType& rResult, IntegrationMethod ThisMethod ) const
     {
+        const UnivariateBernsteinTables* pTables = this->GetUnivariateBernsteinTables(ThisMethod);
+        if(pTables != NULL)
+        {
+            MatrixType coordinates(this->PointsNumber(), 3);
+            for ( IndexType i = 0; i < this->PointsNumber(); ++i )
+            {
+                coordinates(i, 0) = this->GetPoint( i ).X0();
+                coordinates(i, 1) = this->GetPoint( i ).Y0();
+                coordinates(i, 2) = this->GetPoint( i ).Z0();
+            }
+            return this->JacobianSumFactorization(rResult, coordinates,
+                pTables->B1, pTables->D1, pTables->B2, pTables->D2, pTables->B3, pTables->D3);
+        }
+
         MatrixType shape_functions_values;
         ShapeFunctionsGradientsType shape_functions_local_gradients;
 
@@ -820,14 +1084,14 @@ public:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         if(rResults.size() != this->PointsNumber())
             rResults.resize(this->PointsNumber(), false);
-        noalias( rResults ) = prod(mExtractionOperator, bezier_functions_values);
+        this->ApplyExtractionOperator(rResults, bezier_functions_values);
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             rResults(i) *= (mCtrlWeights(i) / denom);
 
@@ -899,8 +1163,8 @@ public:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function local gradients
@@ -908,21 +1172,18 @@ public:
         double tmp1 = inner_prod(bezier_functions_local_derivatives1, bezier_weights);
         double tmp2 = inner_prod(bezier_functions_local_derivatives2, bezier_weights);
         double tmp3 = inner_prod(bezier_functions_local_derivatives3, bezier_weights);
-        VectorType tmp_gradients1 =
-            prod(
-                mExtractionOperator,
+        VectorType tmp_gradients1(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients1,
                     (1 / denom) * bezier_functions_local_derivatives1 -
                         (tmp1 / pow(denom, 2)) * bezier_functions_values
             );
-        VectorType tmp_gradients2 =
-            prod(
-                mExtractionOperator,
+        VectorType tmp_gradients2(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients2,
                     (1 / denom) * bezier_functions_local_derivatives2 -
                         (tmp2 / pow(denom, 2)) * bezier_functions_values
             );
-        VectorType tmp_gradients3 =
-            prod(
-                mExtractionOperator,
+        VectorType tmp_gradients3(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients3,
                     (1 / denom) * bezier_functions_local_derivatives3 -
                         (tmp3 / pow(denom, 2)) * bezier_functions_values
             );
@@ -1062,8 +1323,8 @@ public:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function local second gradients
@@ -1077,43 +1338,43 @@ public:
         double auxs22 = inner_prod(bezier_functions_local_second_derivatives22, bezier_weights);
         double auxs23 = inner_prod(bezier_functions_local_second_derivatives23, bezier_weights);
         double auxs33 = inner_prod(bezier_functions_local_second_derivatives33, bezier_weights);
-        VectorType tmp_gradients11 =
-            prod(mExtractionOperator,
+        VectorType tmp_gradients11(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients11,
                     (1 / denom) * bezier_functions_local_second_derivatives11
                     - (aux1 / pow(denom, 2)) * bezier_functions_local_derivatives1 * 2
                     - (auxs11 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * pow(aux1, 2) / pow(denom, 3) * bezier_functions_values
             );
-        VectorType tmp_gradients12 =
-            prod(mExtractionOperator,
+        VectorType tmp_gradients12(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients12,
                     (1 / denom) * bezier_functions_local_second_derivatives12
                     - ((aux1 + aux2) / pow(denom, 2)) * bezier_functions_local_derivatives1
                     - (auxs12 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * aux1 * aux2 / pow(denom, 3) * bezier_functions_values
             );
-        VectorType tmp_gradients13 =
-            prod(mExtractionOperator,
+        VectorType tmp_gradients13(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients13,
                     (1 / denom) * bezier_functions_local_second_derivatives13
                     - ((aux1 + aux3) / pow(denom, 2)) * bezier_functions_local_derivatives1
                     - (auxs13 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * aux1 * aux3 / pow(denom, 3) * bezier_functions_values
             );
-        VectorType tmp_gradients22 =
-            prod(mExtractionOperator,
+        VectorType tmp_gradients22(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients22,
                     (1 / denom) * bezier_functions_local_second_derivatives22
                     - (aux2 / pow(denom, 2)) * bezier_functions_local_derivatives2 * 2
                     - (auxs22 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * pow(aux2, 2) / pow(denom, 3) * bezier_functions_values
             );
-        VectorType tmp_gradients23 =
-            prod(mExtractionOperator,
+        VectorType tmp_gradients23(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients23,
                     (1 / denom) * bezier_functions_local_second_derivatives23
                     - ((aux2 + aux3) / pow(denom, 2)) * bezier_functions_local_derivatives2
                     - (auxs23 / pow(denom, 2)) * bezier_functions_values
                     + 2.0 * aux2 * aux3 / pow(denom, 3) * bezier_functions_values
             );
-        VectorType tmp_gradients33 =
-            prod(mExtractionOperator,
+        VectorType tmp_gradients33(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients33,
                     (1 / denom) * bezier_functions_local_second_derivatives33
                     - (aux3 / pow(denom, 2)) * bezier_functions_local_derivatives3 * 2
                     - (auxs33 / pow(denom, 2)) * bezier_functions_values
@@ -1146,8 +1407,8 @@ public:
         rPoints.clear();
         rPoints.reserve(number_of_local_points);
 
-        // compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        // get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
 
         // compute the Bezier control points
         typedef typename PointType::Pointer PointPointerType;
@@ -1155,7 +1416,7 @@ public:
         {
             PointPointerType pPoint = PointPointerType(new PointType(0, 0.0, 0.0, 0.0));
             for(std::size_t j = 0; j < number_of_points; ++j)
-                noalias(*pPoint) += mExtractionOperator(j, i) * this->GetPoint(j) * mCtrlWeights[j] / bezier_weights[i];
+                noalias(*pPoint) += this->ExtractionOperatorCoefficient(j, i) * this->GetPoint(j) * mCtrlWeights[j] / bezier_weights[i];
             pPoint->SetInitialPosition(*pPoint);
             pPoint->SetSolutionStepVariablesList(this->GetPoint(0).pGetVariablesList());
             pPoint->SetBufferSize(this->GetPoint(0).GetBufferSize());
@@ -1187,15 +1448,15 @@ public:
         if (rValues.size() != number_of_local_points)
             rValues.resize(number_of_local_points);
 
-        // compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        // get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
 
         // compute the Bezier control points
         for(std::size_t i = 0; i < number_of_local_points; ++i)
         {
             rValues[i] = TDataType(0.0);
             for(std::size_t j = 0; j < number_of_points; ++j)
-                rValues[i] += mExtractionOperator(j, i) * this->GetPoint(j).GetSolutionStepValue(rVariable) * mCtrlWeights[j] / bezier_weights[i];
+                rValues[i] += this->ExtractionOperatorCoefficient(j, i) * this->GetPoint(j).GetSolutionStepValue(rVariable) * mCtrlWeights[j] / bezier_weights[i];
         }
     }
 
@@ -1268,6 +1529,25 @@ public:
         const int& Degree3,
         const int& NumberOfIntegrationMethod
     )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator),
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
+    /**
+     * Assign the geometry data with the extraction operator shared with the cell (or the other geometries); the operator is not copied.
+     */
+    virtual void AssignGeometryData(
+        const ValuesContainerType& Knots1, //not used
+        const ValuesContainerType& Knots2, //not used
+        const ValuesContainerType& Knots3, //not used
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
     {
         mCtrlWeights = Weights;
         mOrder1 = Degree1;
@@ -1276,18 +1556,22 @@ public:
         mNumber1 = mOrder1 + 1;
         mNumber2 = mOrder2 + 1;
         mNumber3 = mOrder3 + 1;
-        mExtractionOperator = ExtractionOperator;
+        mpExtractionOperator = pExtractionOperator;
+        mIsExtractionOperatorFactored = false;
+        mpExtractionOperator1.reset();
+        mpExtractionOperator2.reset();
+        mpExtractionOperator3.reset();
 
         // size checking
-        if(mExtractionOperator.size1() != this->PointsNumber())
+        if(mpExtractionOperator->size1() != this->PointsNumber())
         {
             KRATOS_WATCH(this->PointsNumber())
-            KRATOS_WATCH(mExtractionOperator)
+            KRATOS_WATCH(*mpExtractionOperator)
             KRATOS_THROW_ERROR(std::logic_error, "The number of row of extraction operator must be equal to number of nodes", __FUNCTION__)
         }
-        if(mExtractionOperator.size2() != mNumber1 * mNumber2 * mNumber3)
+        if(mpExtractionOperator->size2() != mNumber1 * mNumber2 * mNumber3)
         {
-            KRATOS_WATCH(mExtractionOperator)
+            KRATOS_WATCH(*mpExtractionOperator)
             KRATOS_WATCH(mOrder1)
             KRATOS_WATCH(mOrder2)
             KRATOS_WATCH(mOrder3)
@@ -1296,47 +1580,97 @@ public:
         if(mCtrlWeights.size() != this->PointsNumber())
             KRATOS_THROW_ERROR(std::logic_error, "The number of weights must be equal to number of nodes", __FUNCTION__)
 
-        if(NumberOfIntegrationMethod > 0)
-        {
-            // find the existing integration rule or create new one if not existed
-            BezierUtils::RegisterIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, Degree1, Degree2, Degree3);
+        // compute the Bezier weights once, they are reused by all shape function evaluations
+        mBezierWeights = prod(trans(*mpExtractionOperator), mCtrlWeights);
 
-            // get the geometry_data according to integration rule. Note that this is a static geometry_data of a reference Bezier element, not the real Bezier element.
-            mpBezierGeometryData = BezierUtils::RetrieveIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, Degree1, Degree2, Degree3);
-            #ifndef ENABLE_PRECOMPUTE
-            BaseType::mpGeometryData = &(*mpBezierGeometryData);
-            #else
-            // precompute the values at each integration points; note that it can generate a LOT of data
-            IntegrationPointsContainerType all_integration_points
-                    = BezierUtils::AllIntegrationPoints(NumberOfIntegrationMethod, mOrder1, mOrder2, mOrder3);
+        this->AssignIntegrationRule(NumberOfIntegrationMethod);
+    }
 
-            ShapeFunctionsValuesContainerType shape_functions_values;
-            ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
+    /**
+     * Assign the geometry data with the extraction operator in factored form, i.e. C = C1 x C2 x C3 (Kronecker product).
+     * The dense extraction operator is not formed. Instead the 1D operators are applied by sum factorization, which reduces
+     * the storage from ((p_u+1)(p_v+1)(p_w+1))^2 to (p_u+1)^2 + (p_v+1)^2 + (p_w+1)^2 and the cost to apply the operator accordingly.
+     */
+    virtual void AssignGeometryData(
+        const ValuesContainerType& Knots1, //not used
+        const ValuesContainerType& Knots2, //not used
+        const ValuesContainerType& Knots3, //not used
+        const ValuesContainerType& Weights,
+        const MatrixType& ExtractionOperator1,
+        const MatrixType& ExtractionOperator2,
+        const MatrixType& ExtractionOperator3,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights,
+                ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator1),
+                ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator2),
+                ExtractionOperatorPool<MatrixType>::Intern(ExtractionOperator3),
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
 
-            for(IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
-            {
-                CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
-                    shape_functions_values[i],
-                    shape_functions_local_gradients[i],
-                    (GeometryData::IntegrationMethod)i
-                );
-            }
+    /**
+     * Assign the geometry data with the factored extraction operator, with the 1D operators shared with the cell (or the other geometries).
+     */
+    virtual void AssignGeometryData(
+        const ValuesContainerType& Knots1, //not used
+        const ValuesContainerType& Knots2, //not used
+        const ValuesContainerType& Knots3, //not used
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator1,
+        ExtractionOperatorPointerType pExtractionOperator2,
+        ExtractionOperatorPointerType pExtractionOperator3,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
+    {
+        mCtrlWeights = Weights;
+        mOrder1 = Degree1;
+        mOrder2 = Degree2;
+        mOrder3 = Degree3;
+        mNumber1 = mOrder1 + 1;
+        mNumber2 = mOrder2 + 1;
+        mNumber3 = mOrder3 + 1;
+        mpExtractionOperator = ExtractionOperatorPool<MatrixType>::Intern(MatrixType(0, 0));
+        mpExtractionOperator1 = pExtractionOperator1;
+        mpExtractionOperator2 = pExtractionOperator2;
+        mpExtractionOperator3 = pExtractionOperator3;
+        mIsExtractionOperatorFactored = true;
 
-            mpGeometryData = GeometryData::Pointer(
-                new GeometryData(
-                        3,
-                        3,
-                        3,
-                        GeometryData::GI_GAUSS_1,           //ThisDefaultMethod
-                        all_integration_points,             //ThisIntegrationPoints
-                        shape_functions_values,             //ThisShapeFunctionsValues
-                        shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
-                    )
-                );
-
-            BaseType::mpGeometryData = &(*mpGeometryData);
-            #endif
+        // size checking
+        if(mpExtractionOperator1->size1() * mpExtractionOperator2->size1() * mpExtractionOperator3->size1() != this->PointsNumber())
+        {
+            KRATOS_WATCH(this->PointsNumber())
+            KRATOS_WATCH(*mpExtractionOperator1)
+            KRATOS_WATCH(*mpExtractionOperator2)
+            KRATOS_WATCH(*mpExtractionOperator3)
+            KRATOS_THROW_ERROR(std::logic_error, "The product of number of rows of extraction operator factors must be equal to number of nodes", __FUNCTION__)
         }
+        if(mpExtractionOperator1->size2() != mNumber1
+            || mpExtractionOperator2->size2() != mNumber2
+            || mpExtractionOperator3->size2() != mNumber3)
+        {
+            KRATOS_WATCH(*mpExtractionOperator1)
+            KRATOS_WATCH(*mpExtractionOperator2)
+            KRATOS_WATCH(*mpExtractionOperator3)
+            KRATOS_WATCH(mOrder1)
+            KRATOS_WATCH(mOrder2)
+            KRATOS_WATCH(mOrder3)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of column of extraction operator factors must be equal to p_u+1, p_v+1 and p_w+1, error at", __FUNCTION__)
+        }
+        if(mCtrlWeights.size() != this->PointsNumber())
+            KRATOS_THROW_ERROR(std::logic_error, "The number of weights must be equal to number of nodes", __FUNCTION__)
+
+        // compute the Bezier weights once, they are reused by all shape function evaluations
+        mBezierWeights.resize(mNumber1 * mNumber2 * mNumber3, false);
+        this->ApplyTransposeExtractionOperator(mBezierWeights, mCtrlWeights);
+
+        this->AssignIntegrationRule(NumberOfIntegrationMethod);
     }
 
 protected:
@@ -1346,14 +1680,20 @@ protected:
      */
 
     GeometryData::Pointer mpBezierGeometryData;
-    #ifdef ENABLE_PRECOMPUTE
-    GeometryData::Pointer mpGeometryData;
-    #endif
 
-    MatrixType mExtractionOperator;
+    typename ExtractionOperatorPool<MatrixType>::PointerType mpExtractionOperator; //dense extraction operator, shared with the cell and the other geometries having the same operator; empty if the extraction operator is factored
+
+    bool mIsExtractionOperatorFactored; //if true, the extraction operator is given by the Kronecker product of the 1D operators below
+    ExtractionOperatorPointerType mpExtractionOperator1; //1D extraction operator on parametric direction 1, shared with the cell
+    ExtractionOperatorPointerType mpExtractionOperator2; //1D extraction operator on parametric direction 2, shared with the cell
+    ExtractionOperatorPointerType mpExtractionOperator3; //1D extraction operator on parametric direction 3, shared with the cell
 
     ValuesContainerType mCtrlWeights; //weight of control points
 
+    VectorType mBezierWeights; //weight of Bezier control points, i.e. trans(C) * mCtrlWeights
+    std::vector<VectorType> mBezierDenominators; //denominator W(xi) at the integration points of each integration method
+    UnivariateBernsteinTablesContainerPointerType mpBernsteinTables; //univariate Bernstein tables of each integration method, shared by the geometries having the same integration rule
+
     int mOrder1; //order of the surface at parametric direction 1
     int mOrder2; //order of the surface at parametric direction 2
     int mOrder3; //order of the surface at parametric direction 3
@@ -1362,6 +1702,375 @@ protected:
     int mNumber2; //number of bezier shape functions define the surface on parametric direction 2
     int mNumber3; //number of bezier shape functions define the surface on parametric direction 3
 
+    /**
+     * Compute the denominator W(xi) = sum_i B_i(xi) * w^b_i at the integration points of all integration methods
+     */
+    void ComputeBezierDenominators(const int& NumberOfIntegrationMethod)
+    {
+        mBezierDenominators.resize(NumberOfIntegrationMethod);
+        for(int i = 0; i < NumberOfIntegrationMethod; ++i)
+        {
+            const MatrixType& bezier_functions_values
+                = mpBezierGeometryData->ShapeFunctionsValues( static_cast<IntegrationMethod>(i) );
+            mBezierDenominators[i] = prod(bezier_functions_values, mBezierWeights);
+        }
+    }
+
+    /**
+     * Register and retrieve the integration rule for the Bezier element, and compute the data related to integration points
+     */
+    void AssignIntegrationRule(const int& NumberOfIntegrationMethod)
+    {
+        mBezierDenominators.clear();
+        mpBernsteinTables.reset();
+
+        if(NumberOfIntegrationMethod > 0)
+        {
+            // find the existing integration rule or create new one if not existed
+            BezierUtils::RegisterIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, mOrder1, mOrder2, mOrder3);
+
+            // get the geometry_data according to integration rule. Note that this is a static geometry_data of a reference Bezier element, not the real Bezier element.
+            mpBezierGeometryData = BezierUtils::RetrieveIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, mOrder1, mOrder2, mOrder3);
+
+            // compute the rational denominators at the integration points
+            this->ComputeBezierDenominators(NumberOfIntegrationMethod);
+
+            // retrieve the univariate Bernstein tables at the integration points
+            mpBernsteinTables = GetUnivariateBernsteinTables(mpBezierGeometryData, NumberOfIntegrationMethod, mOrder1, mOrder2, mOrder3);
+
+            BaseType::mpGeometryData = &(*mpBezierGeometryData);
+        }
+
+        // the tables are computed here under the eager precompute policy
+        this->ResetPrecomputedTables();
+    }
+
+    /**
+     * Compute rResults = C * rBezierValues, where C is the extraction operator. In the case the extraction operator is factored,
+     * C = C1 x C2 x C3 is applied by contracting one parametric direction at a time (sum factorization).
+     * rResults must be sized to the number of nodes a priori.
+     */
+    void ApplyExtractionOperator(VectorType& rResults, const VectorType& rBezierValues) const
+    {
+        if(!mIsExtractionOperatorFactored)
+        {
+            noalias(rResults) = prod(*mpExtractionOperator, rBezierValues);
+            return;
+        }
+
+        const IndexType n1 = mpExtractionOperator1->size1();
+        const IndexType n2 = mpExtractionOperator2->size1();
+        const IndexType n3 = mpExtractionOperator3->size1();
+        IndexType i, j, k, a, b, c;
+        double aux;
+
+        // contract on direction 3: T1(a, b, k) = sum_c C3(k, c) * B(a, b, c)
+        VectorType T1(mNumber1 * mNumber2 * n3);
+        for(a = 0; a < mNumber1; ++a)
+            for(b = 0; b < mNumber2; ++b)
+                for(k = 0; k < n3; ++k)
+                {
+                    aux = 0.0;
+                    for(c = 0; c < mNumber3; ++c)
+                        aux += (*mpExtractionOperator3)(k, c) * rBezierValues(c + (b + a * mNumber2) * mNumber3);
+                    T1(k + (b + a * mNumber2) * n3) = aux;
+                }
+
+        // contract on direction 2: T2(a, j, k) = sum_b C2(j, b) * T1(a, b, k)
+        VectorType T2(mNumber1 * n2 * n3);
+        for(a = 0; a < mNumber1; ++a)
+            for(j = 0; j < n2; ++j)
+                for(k = 0; k < n3; ++k)
+                {
+                    aux = 0.0;
+                    for(b = 0; b < mNumber2; ++b)
+                        aux += (*mpExtractionOperator2)(j, b) * T1(k + (b + a * mNumber2) * n3);
+                    T2(k + (j + a * n2) * n3) = aux;
+                }
+
+        // contract on direction 1: N(i, j, k) = sum_a C1(i, a) * T2(a, j, k)
+        for(i = 0; i < n1; ++i)
+            for(j = 0; j < n2; ++j)
+                for(k = 0; k < n3; ++k)
+                {
+                    aux = 0.0;
+                    for(a = 0; a < mNumber1; ++a)
+                        aux += (*mpExtractionOperator1)(i, a) * T2(k + (j + a * n2) * n3);
+                    rResults(k + (j + i * n2) * n3) = aux;
+                }
+    }
+
+    /**
+     * Compute rResults = trans(C) * rValues, where C is the extraction operator. See ApplyExtractionOperator.
+     * rResults must be sized to the number of Bezier shape functions a priori.
+     */
+    void ApplyTransposeExtractionOperator(VectorType& rResults, const VectorType& rValues) const
+    {
+        if(!mIsExtractionOperatorFactored)
+        {
+            noalias(rResults) = prod(trans(*mpExtractionOperator), rValues);
+            return;
+        }
+
+        const IndexType n1 = mpExtractionOperator1->size1();
+        const IndexType n2 = mpExtractionOperator2->size1();
+        const IndexType n3 = mpExtractionOperator3->size1();
+        IndexType i, j, k, a, b, c;
+        double aux;
+
+        // contract on direction 3: T1(i, j, c) = sum_k C3(k, c) * V(i, j, k)
+        VectorType T1(n1 * n2 * mNumber3);
+        for(i = 0; i < n1; ++i)
+            for(j = 0; j < n2; ++j)
+                for(c = 0; c < mNumber3; ++c)
+                {
+                    aux = 0.0;
+                    for(k = 0; k < n3; ++k)
+                        aux += (*mpExtractionOperator3)(k, c) * rValues(k + (j + i * n2) * n3);
+                    T1(c + (j + i * n2) * mNumber3) = aux;
+                }
+
+        // contract on direction 2: T2(i, b, c) = sum_j C2(j, b) * T1(i, j, c)
+        VectorType T2(n1 * mNumber2 * mNumber3);
+        for(i = 0; i < n1; ++i)
+            for(b = 0; b < mNumber2; ++b)
+                for(c = 0; c < mNumber3; ++c)
+                {
+                    aux = 0.0;
+                    for(j = 0; j < n2; ++j)
+                        aux += (*mpExtractionOperator2)(j, b) * T1(c + (j + i * n2) * mNumber3);
+                    T2(c + (b + i * mNumber2) * mNumber3) = aux;
+                }
+
+        // contract on direction 1: R(a, b, c) = sum_i C1(i, a) * T2(i, b, c)
+        for(a = 0; a < mNumber1; ++a)
+            for(b = 0; b < mNumber2; ++b)
+                for(c = 0; c < mNumber3; ++c)
+                {
+                    aux = 0.0;
+                    for(i = 0; i < n1; ++i)
+                        aux += (*mpExtractionOperator1)(i, a) * T2(c + (b + i * mNumber2) * mNumber3);
+                    rResults(c + (b + a * mNumber2) * mNumber3) = aux;
+                }
+    }
+
+    /**
+     * Get the entry (Row, Col) of the extraction operator
+     */
+    double ExtractionOperatorCoefficient(const IndexType& Row, const IndexType& Col) const
+    {
+        if(!mIsExtractionOperatorFactored)
+            return (*mpExtractionOperator)(Row, Col);
+
+        const IndexType n2 = mpExtractionOperator2->size1();
+        const IndexType n3 = mpExtractionOperator3->size1();
+        return (*mpExtractionOperator1)(Row / (n2 * n3), Col / (mNumber2 * mNumber3))
+             * (*mpExtractionOperator2)((Row / n3) % n2, (Col / mNumber3) % mNumber2)
+             * (*mpExtractionOperator3)(Row % n3, Col % mNumber3);
+    }
+
+    /**
+     * Get the univariate Bernstein tables of an integration method, or NULL if the integration points of this integration
+     * method are not of tensor-product form
+     */
+    const UnivariateBernsteinTables* GetUnivariateBernsteinTables(IntegrationMethod ThisMethod) const
+    {
+        if(mpBernsteinTables == NULL || static_cast<IndexType>(ThisMethod) >= mpBernsteinTables->size())
+            return NULL;
+
+        const UnivariateBernsteinTables& rTables = (*mpBernsteinTables)[ThisMethod];
+        if(!rTables.IsTensorProduct)
+            return NULL;
+        return &rTables;
+    }
+
+    /**
+     * Get the univariate Bernstein tables of all integration methods of a reference Bezier geometry data. The tables only depend
+     * on the integration rule, hence they are computed once and shared by all the geometries using the same rule. The reference
+     * geometry data are never released by BezierUtils, so their addresses identify the rules.
+     */
+    static UnivariateBernsteinTablesContainerPointerType GetUnivariateBernsteinTables(
+        const GeometryData::Pointer& pBezierGeometryData,
+        const int& NumberOfIntegrationMethod,
+        const int& Order1, const int& Order2, const int& Order3
+    )
+    {
+        typedef std::map<const GeometryData*, UnivariateBernsteinTablesContainerPointerType> TablesMapType;
+        static TablesMapType tables_map;
+
+        UnivariateBernsteinTablesContainerPointerType pTables;
+        #pragma omp critical(Geo3dBezier_GetUnivariateBernsteinTables)
+        {
+            typename TablesMapType::const_iterator it = tables_map.find(&(*pBezierGeometryData));
+            if(it != tables_map.end())
+                pTables = it->second;
+        }
+
+        if(pTables != NULL && pTables->size() == static_cast<IndexType>(NumberOfIntegrationMethod))
+            return pTables;
+
+        // compute the tables outside of the critical section; if another thread was faster, its tables are used
+        boost::shared_ptr<UnivariateBernsteinTablesContainerType> pNewTables(new UnivariateBernsteinTablesContainerType(NumberOfIntegrationMethod));
+        for(int i = 0; i < NumberOfIntegrationMethod; ++i)
+            ComputeUnivariateBernsteinTables((*pNewTables)[i], *pBezierGeometryData, static_cast<IntegrationMethod>(i), Order1, Order2, Order3);
+
+        #pragma omp critical(Geo3dBezier_GetUnivariateBernsteinTables)
+        {
+            UnivariateBernsteinTablesContainerPointerType& rpTables = tables_map[&(*pBezierGeometryData)];
+            if(rpTables == NULL || rpTables->size() != static_cast<IndexType>(NumberOfIntegrationMethod))
+                rpTables = pNewTables;
+            pTables = rpTables;
+        }
+
+        return pTables;
+    }
+
+    /**
+     * Compute the univariate Bernstein values and derivatives tables (number of points x (p+1)) on each parametric direction
+     * at the integration points of an integration method. The integration points generated by BezierUtils::AllIntegrationPoints
+     * are the tensor product of 1D Gauss rules, with the third direction varying fastest. rTables.IsTensorProduct is false
+     * if the integration points of this integration method are not of this form.
+     */
+    static void ComputeUnivariateBernsteinTables(
+        UnivariateBernsteinTables& rTables,
+        const GeometryData& rBezierGeometryData,
+        IntegrationMethod ThisMethod,
+        const int& Order1, const int& Order2, const int& Order3
+    )
+    {
+        rTables.IsTensorProduct = false;
+
+        const IntegrationPointsArrayType& integration_points = rBezierGeometryData.IntegrationPoints(ThisMethod);
+
+        // number of Gauss points on each direction, see BezierUtils::AllIntegrationPoints
+        const IndexType q1 = static_cast<IndexType>(ThisMethod) + Order1 / 2 + 1;
+        const IndexType q2 = static_cast<IndexType>(ThisMethod) + Order2 / 2 + 1;
+        const IndexType q3 = static_cast<IndexType>(ThisMethod) + Order3 / 2 + 1;
+        if(integration_points.size() != q1 * q2 * q3)
+            return;
+
+        // check the tensor-product structure of the integration points
+        const double tol = 1.0e-13;
+        IndexType pnt;
+        for(IndexType j1 = 0; j1 < q1; ++j1)
+            for(IndexType j2 = 0; j2 < q2; ++j2)
+                for(IndexType j3 = 0; j3 < q3; ++j3)
+                {
+                    pnt = j3 + (j2 + j1 * q2) * q3;
+                    if(    fabs(integration_points[pnt].X() - integration_points[j1 * q2 * q3].X()) > tol
+                        || fabs(integration_points[pnt].Y() - integration_points[j2 * q3].Y()) > tol
+                        || fabs(integration_points[pnt].Z() - integration_points[j3].Z()) > tol )
+                        return;
+                }
+
+        VectorType values1(Order1 + 1), derivatives1(Order1 + 1);
+        rTables.B1.resize(q1, Order1 + 1, false);
+        rTables.D1.resize(q1, Order1 + 1, false);
+        for(IndexType j1 = 0; j1 < q1; ++j1)
+        {
+            BezierUtils::bernstein(values1, derivatives1, Order1, integration_points[j1 * q2 * q3].X());
+            noalias(row(rTables.B1, j1)) = values1;
+            noalias(row(rTables.D1, j1)) = derivatives1;
+        }
+
+        VectorType values2(Order2 + 1), derivatives2(Order2 + 1);
+        rTables.B2.resize(q2, Order2 + 1, false);
+        rTables.D2.resize(q2, Order2 + 1, false);
+        for(IndexType j2 = 0; j2 < q2; ++j2)
+        {
+            BezierUtils::bernstein(values2, derivatives2, Order2, integration_points[j2 * q3].Y());
+            noalias(row(rTables.B2, j2)) = values2;
+            noalias(row(rTables.D2, j2)) = derivatives2;
+        }
+
+        VectorType values3(Order3 + 1), derivatives3(Order3 + 1);
+        rTables.B3.resize(q3, Order3 + 1, false);
+        rTables.D3.resize(q3, Order3 + 1, false);
+        for(IndexType j3 = 0; j3 < q3; ++j3)
+        {
+            BezierUtils::bernstein(values3, derivatives3, Order3, integration_points[j3].Z());
+            noalias(row(rTables.B3, j3)) = values3;
+            noalias(row(rTables.D3, j3)) = derivatives3;
+        }
+
+        rTables.IsTensorProduct = true;
+    }
+
+    /**
+     * Evaluate f = sum_abc F(a, b, c) * B1_a * B2_b * B3_c and its local derivatives at the tensor-product points
+     * of the univariate tables, by contracting one parametric direction at a time.
+     * The coefficients F are indexed as c + (b + a * m2) * m3; the results are indexed as j3 + (j2 + j1 * q2) * q3.
+     */
+    void EvaluateTensorProduct(
+        VectorType& rValues,
+        VectorType& rDerivatives1,
+        VectorType& rDerivatives2,
+        VectorType& rDerivatives3,
+        const VectorType& rCoefficients,
+        const MatrixType& B1, const MatrixType& D1,
+        const MatrixType& B2, const MatrixType& D2,
+        const MatrixType& B3, const MatrixType& D3
+    ) const
+    {
+        const IndexType q1 = B1.size1(), m1 = B1.size2();
+        const IndexType q2 = B2.size1(), m2 = B2.size2();
+        const IndexType q3 = B3.size1(), m3 = B3.size2();
+        IndexType a, b, c, j1, j2, j3, idx;
+        double v, d;
+
+        // contract on direction 3
+        VectorType T3v(m1 * m2 * q3), T3d(m1 * m2 * q3);
+        for(a = 0; a < m1; ++a)
+            for(b = 0; b < m2; ++b)
+                for(j3 = 0; j3 < q3; ++j3)
+                {
+                    v = 0.0; d = 0.0;
+                    for(c = 0; c < m3; ++c)
+                    {
+                        v += rCoefficients(c + (b + a * m2) * m3) * B3(j3, c);
+                        d += rCoefficients(c + (b + a * m2) * m3) * D3(j3, c);
+                    }
+                    T3v(j3 + (b + a * m2) * q3) = v;
+                    T3d(j3 + (b + a * m2) * q3) = d;
+                }
+
+        // contract on direction 2
+        VectorType T2vv(m1 * q2 * q3), T2dv(m1 * q2 * q3), T2vd(m1 * q2 * q3);
+        for(a = 0; a < m1; ++a)
+            for(j2 = 0; j2 < q2; ++j2)
+                for(j3 = 0; j3 < q3; ++j3)
+                {
+                    idx = j3 + (j2 + a * q2) * q3;
+                    T2vv(idx) = 0.0; T2dv(idx) = 0.0; T2vd(idx) = 0.0;
+                    for(b = 0; b < m2; ++b)
+                    {
+                        T2vv(idx) += T3v(j3 + (b + a * m2) * q3) * B2(j2, b);
+                        T2dv(idx) += T3v(j3 + (b + a * m2) * q3) * D2(j2, b);
+                        T2vd(idx) += T3d(j3 + (b + a * m2) * q3) * B2(j2, b);
+                    }
+                }
+
+        // contract on direction 1
+        rValues.resize(q1 * q2 * q3, false);
+        rDerivatives1.resize(q1 * q2 * q3, false);
+        rDerivatives2.resize(q1 * q2 * q3, false);
+        rDerivatives3.resize(q1 * q2 * q3, false);
+        for(j1 = 0; j1 < q1; ++j1)
+            for(j2 = 0; j2 < q2; ++j2)
+                for(j3 = 0; j3 < q3; ++j3)
+                {
+                    idx = j3 + (j2 + j1 * q2) * q3;
+                    rValues(idx) = 0.0; rDerivatives1(idx) = 0.0; rDerivatives2(idx) = 0.0; rDerivatives3(idx) = 0.0;
+                    for(a = 0; a < m1; ++a)
+                    {
+                        rValues(idx)       += T2vv(j3 + (j2 + a * q2) * q3) * B1(j1, a);
+                        rDerivatives1(idx) += T2vv(j3 + (j2 + a * q2) * q3) * D1(j1, a);
+                        rDerivatives2(idx) += T2dv(j3 + (j2 + a * q2) * q3) * B1(j1, a);
+                        rDerivatives3(idx) += T2vd(j3 + (j2 + a * q2) * q3) * B1(j1, a);
+                    }
+                }
+    }
+
 private:
 
     /**
@@ -1458,14 +2167,14 @@ private:
             }
         }
 
-        //compute the Bezier weight
-        VectorType bezier_weights = prod(trans(mExtractionOperator), mCtrlWeights);
+        //get the Bezier weight (precomputed in AssignGeometryData)
+        const VectorType& bezier_weights = mBezierWeights;
         double denom = inner_prod(bezier_functions_values, bezier_weights);
 
         //compute the shape function values
         if(shape_functions_values.size() != this->PointsNumber())
             shape_functions_values.resize(this->PointsNumber(), false);
-        noalias( shape_functions_values ) = prod(mExtractionOperator, bezier_functions_values);
+        this->ApplyExtractionOperator(shape_functions_values, bezier_functions_values);
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
             shape_functions_values(i) *= (mCtrlWeights(i) / denom);
 
@@ -1476,11 +2185,14 @@ private:
         double tmp1 = inner_prod(bezier_functions_local_derivatives1, bezier_weights);
         double tmp2 = inner_prod(bezier_functions_local_derivatives2, bezier_weights);
         double tmp3 = inner_prod(bezier_functions_local_derivatives3, bezier_weights);
-        VectorType tmp_gradients1 = prod(mExtractionOperator,
+        VectorType tmp_gradients1(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients1,
                     (1 / denom) * bezier_functions_local_derivatives1 - (tmp1 / pow(denom, 2)) * bezier_functions_values );
-        VectorType tmp_gradients2 = prod(mExtractionOperator,
+        VectorType tmp_gradients2(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients2,
                     (1 / denom) * bezier_functions_local_derivatives2 - (tmp2 / pow(denom, 2)) * bezier_functions_values );
-        VectorType tmp_gradients3 = prod(mExtractionOperator,
+        VectorType tmp_gradients3(this->PointsNumber());
+        this->ApplyExtractionOperator(tmp_gradients3,
                     (1 / denom) * bezier_functions_local_derivatives3 - (tmp3 / pow(denom, 2)) * bezier_functions_values );
         for(IndexType i = 0; i < this->PointsNumber(); ++i)
         {
@@ -1553,7 +2265,6 @@ template<class TPointType> inline std::ostream& operator <<(
 #undef DEBUG_LEVEL7
 #undef DEBUG_LEVEL8
 #undef ENABLE_PROFILING
-#undef ENABLE_PRECOMPUTE
 
 #endif
 
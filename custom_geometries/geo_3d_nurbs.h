@@ -60,6 +60,7 @@
 #include "custom_geometries/isogeometric_geometry.h"
 #include "integration/quadrature.h"
 #include "custom_utilities/bspline_utils.h"
+#include "custom_utilities/nurbs/knot_span_locator.h"
 #include "integration/quadrature.h"
 #include "integration/line_gauss_legendre_integration_points.h"
 
@@ -522,40 +523,21 @@ public:
     virtual JacobiansType& Jacobian( JacobiansType& rResult,
             IntegrationMethod ThisMethod ) const
     {
-        //getting derivatives of shape functions
-        const ShapeFunctionsGradientsType& shape_functions_gradients = BaseType::ShapeFunctionsLocalGradients( ThisMethod );
-        //getting values of shape functions
-        const Matrix& shape_functions_values = BaseType::ShapeFunctionsValues( ThisMethod );
+        const IntegrationPointsArrayType& integration_points = this->IntegrationPoints( ThisMethod );
 
-        if ( rResult.size() != this->IntegrationPointsNumber( ThisMethod ) )
+        if ( rResult.size() != integration_points.size() )
         {
-            JacobiansType temp( this->IntegrationPointsNumber( ThisMethod ) );
+            JacobiansType temp( integration_points.size() );
             rResult.swap( temp );
         }
 
-        //loop over all integration points
-        for ( unsigned int pnt = 0; pnt < this->IntegrationPointsNumber( ThisMethod ); ++pnt )
-        {
-            //defining single jacobian matrix
-            Matrix jacobian = ZeroMatrix( 3, 3 );
-            //loop over all nodes
-
-            for ( unsigned int i = 0; i < this->PointsNumber(); ++i )
-            {
-                jacobian( 0, 0 ) += ( this->GetPoint( i ).X() ) * ( shape_functions_gradients[pnt]( i, 0 ) );
-                jacobian( 0, 1 ) += ( this->GetPoint( i ).X() ) * ( shape_functions_gradients[pnt]( i, 1 ) );
-                jacobian( 0, 2 ) += ( this->GetPoint( i ).X() ) * ( shape_functions_gradients[pnt]( i, 2 ) );
-                jacobian( 1, 0 ) += ( this->GetPoint( i ).Y() ) * ( shape_functions_gradients[pnt]( i, 0 ) );
-                jacobian( 1, 1 ) += ( this->GetPoint( i ).Y() ) * ( shape_functions_gradients[pnt]( i, 1 ) );
-                jacobian( 1, 2 ) += ( this->GetPoint( i ).Y() ) * ( shape_functions_gradients[pnt]( i, 2 ) );
-                jacobian( 2, 0 ) += ( this->GetPoint( i ).Z() ) * ( shape_functions_gradients[pnt]( i, 0 ) );
-                jacobian( 2, 1 ) += ( this->GetPoint( i ).Z() ) * ( shape_functions_gradients[pnt]( i, 1 ) );
-                jacobian( 2, 2 ) += ( this->GetPoint( i ).Z() ) * ( shape_functions_gradients[pnt]( i, 2 ) );
-
-            }
+        //the knot spans and univariate B-splines at the integration points
+        SpanBasisFunctions TempBasisFunctions;
+        const SpanBasisFunctions& rBasisFunctions = GetSpanBasisFunctions( TempBasisFunctions, ThisMethod );
 
-            rResult[pnt] = jacobian;
-        } //end of loop over all integration points
+        //loop over all integration points
+        for ( unsigned int pnt = 0; pnt < integration_points.size(); ++pnt )
+            CalculateJacobianOnSpan( rResult[pnt], rBasisFunctions, pnt, NULL );
 
         return rResult;
     }
@@ -584,40 +566,23 @@ public:
             IntegrationMethod ThisMethod,
             Matrix & DeltaPosition ) const
     {
-        //getting derivatives of shape functions
-        const ShapeFunctionsGradientsType& shape_functions_gradients = BaseType::ShapeFunctionsLocalGradients( ThisMethod );
-        //getting values of shape functions
-        const Matrix& shape_functions_values = BaseType::ShapeFunctionsValues( ThisMethod );
+        const IntegrationPointsArrayType& integration_points = this->IntegrationPoints( ThisMethod );
 
-        if ( rResult.size() != this->IntegrationPointsNumber( ThisMethod ) )
+        if ( rResult.size() != integration_points.size() )
         {
             // KLUDGE: While there is a bug in ublas
             // vector resize, I have to put this beside resizing!!
-            JacobiansType temp( this->IntegrationPointsNumber( ThisMethod ) );
+            JacobiansType temp( integration_points.size() );
             rResult.swap( temp );
         }
 
-        //loop over all integration points
-        for ( unsigned int pnt = 0; pnt < this->IntegrationPointsNumber( ThisMethod ); ++pnt )
-        {
-            //defining single jacobian matrix
-            Matrix jacobian = ZeroMatrix( 3, 3 );
-            //loop over all nodes
-            for ( unsigned int i = 0; i < this->PointsNumber(); ++i )
-            {
-                jacobian( 0, 0 ) += ( this->GetPoint( i ).X() + DeltaPosition(i, 0) ) * ( shape_functions_gradients[pnt]( i, 0 ) );
-                jacobian( 0, 1 ) += ( this->GetPoint( i ).X() + DeltaPosition(i, 0) ) * ( shape_functions_gradients[pnt]( i, 1 ) );
-                jacobian( 0, 2 ) += ( this->GetPoint( i ).X() + DeltaPosition(i, 0) ) * ( shape_functions_gradients[pnt]( i, 2 ) );
-                jacobian( 1, 0 ) += ( this->GetPoint( i ).Y() + DeltaPosition(i, 1) ) * ( shape_functions_gradients[pnt]( i, 0 ) );
-                jacobian( 1, 1 ) += ( this->GetPoint( i ).Y() + DeltaPosition(i, 1) ) * ( shape_functions_gradients[pnt]( i, 1 ) );
-                jacobian( 1, 2 ) += ( this->GetPoint( i ).Y() + DeltaPosition(i, 1) ) * ( shape_functions_gradients[pnt]( i, 2 ) );
-                jacobian( 2, 0 ) += ( this->GetPoint( i ).Z() + DeltaPosition(i, 2) ) * ( shape_functions_gradients[pnt]( i, 0 ) );
-                jacobian( 2, 1 ) += ( this->GetPoint( i ).Z() + DeltaPosition(i, 2) ) * ( shape_functions_gradients[pnt]( i, 1 ) );
-                jacobian( 2, 2 ) += ( this->GetPoint( i ).Z() + DeltaPosition(i, 2) ) * ( shape_functions_gradients[pnt]( i, 2 ) );
-            }
+        //the knot spans and univariate B-splines at the integration points
+        SpanBasisFunctions TempBasisFunctions;
+        const SpanBasisFunctions& rBasisFunctions = GetSpanBasisFunctions( TempBasisFunctions, ThisMethod );
 
-            rResult[pnt] = jacobian;
-        } //end of loop over all integration points
+        //loop over all integration points
+        for ( unsigned int pnt = 0; pnt < integration_points.size(); ++pnt )
+            CalculateJacobianOnSpan( rResult[pnt], rBasisFunctions, pnt, &DeltaPosition );
 
         return rResult;
     }
@@ -1048,9 +1013,9 @@ public:
         int Index2 = (ShapeFunctionIndex / mNumber3) % mNumber2;
         int Index1 = (ShapeFunctionIndex / mNumber3) / mNumber2;
 
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rPoint[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rPoint[1], mKnots2);
-        int Span3 = BSplineUtils::FindSpan(mNumber3, mOrder3, rPoint[2], mKnots3);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
+        int Span3 = mSpanLocator3.FindSpan(mNumber3, mOrder3, rPoint[2]);
 
         #ifdef DEBUG_LEVEL1
         KRATOS_WATCH(ShapeFunctionIndex)
@@ -1149,9 +1114,9 @@ public:
         ValuesContainerType ShapeFunctionValues2(mOrder2 + 1);
         ValuesContainerType ShapeFunctionValues3(mOrder3 + 1);
 
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rCoordinates[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rCoordinates[1], mKnots2);
-        int Span3 = BSplineUtils::FindSpan(mNumber3, mOrder3, rCoordinates[2], mKnots3);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rCoordinates[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rCoordinates[1]);
+        int Span3 = mSpanLocator3.FindSpan(mNumber3, mOrder3, rCoordinates[2]);
 
         BSplineUtils::BasisFuns(ShapeFunctionValues1, Span1, rCoordinates[0], mOrder1, mKnots1);
         BSplineUtils::BasisFuns(ShapeFunctionValues2, Span2, rCoordinates[1], mOrder2, mKnots2);
@@ -1208,9 +1173,9 @@ public:
         Matrix ShapeFunctionsValuesAndDerivatives1(NumberOfDerivatives + 1, mOrder1 + 1);
         Matrix ShapeFunctionsValuesAndDerivatives2(NumberOfDerivatives + 1, mOrder2 + 1);
         Matrix ShapeFunctionsValuesAndDerivatives3(NumberOfDerivatives + 1, mOrder3 + 1);
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rPoint[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rPoint[1], mKnots2);
-        int Span3 = BSplineUtils::FindSpan(mNumber3, mOrder3, rPoint[2], mKnots3);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
+        int Span3 = mSpanLocator3.FindSpan(mNumber3, mOrder3, rPoint[2]);
         int Start1 = Span1 - mOrder1;
         int Start2 = Span2 - mOrder2;
         int Start3 = Span3 - mOrder3;
@@ -1312,9 +1277,9 @@ public:
         Matrix ShapeFunctionsValuesAndDerivatives1(NumberOfDerivatives + 1, mOrder1 + 1);
         Matrix ShapeFunctionsValuesAndDerivatives2(NumberOfDerivatives + 1, mOrder2 + 1);
         Matrix ShapeFunctionsValuesAndDerivatives3(NumberOfDerivatives + 1, mOrder3 + 1);
-        int Span1 = BSplineUtils::FindSpan(mNumber1, mOrder1, rPoint[0], mKnots1);
-        int Span2 = BSplineUtils::FindSpan(mNumber2, mOrder2, rPoint[1], mKnots2);
-        int Span3 = BSplineUtils::FindSpan(mNumber3, mOrder3, rPoint[2], mKnots3);
+        int Span1 = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+        int Span2 = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
+        int Span3 = mSpanLocator3.FindSpan(mNumber3, mOrder3, rPoint[2]);
         int Start1 = Span1 - mOrder1;
         int Start2 = Span2 - mOrder2;
         int Start3 = Span3 - mOrder3;
@@ -1513,6 +1478,9 @@ public:
         mKnots1 = Knots1;
         mKnots2 = Knots2;
         mKnots3 = Knots3;
+        mSpanLocator1.Initialize(mKnots1);
+        mSpanLocator2.Initialize(mKnots2);
+        mSpanLocator3.Initialize(mKnots3);
         mCtrlWeights = Weights;
         mOrder1 = Degree1;
         mOrder2 = Degree2;
@@ -1552,6 +1520,11 @@ public:
         start_compute = end_compute;
         #endif
 
+        //locate the knot spans and compute the univariate B-splines at the integration points once, they are reused by the Jacobian
+        mSpanBasisFunctions.resize(NumberOfIntegrationMethod);
+        for (unsigned int i = 0; i < NumberOfIntegrationMethod; ++i)
+            ComputeSpanBasisFunctions(mSpanBasisFunctions[i], all_integration_points[i]);
+
         //generate all shape function values and derivatives
         ShapeFunctionsValuesContainerType shape_functions_values;
         ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
@@ -1637,8 +1610,150 @@ public:
 protected:
 
     /**
-     * there are no protected class members
+     * Knot spans and univariate B-spline values and first derivatives ((NumberOfDerivatives + 1) x (p + 1)) on each
+     * parametric direction at the integration points of an integration method
      */
+    struct SpanBasisFunctions
+    {
+        std::vector<int> Span1, Span2, Span3;
+        std::vector<Matrix> Ders1, Ders2, Ders3;
+    };
+
+    /**
+     * Locate the knot spans and compute the univariate B-splines at a set of integration points
+     */
+    void ComputeSpanBasisFunctions( SpanBasisFunctions& rResult, const IntegrationPointsArrayType& rIntegrationPoints ) const
+    {
+        const int NumberOfDerivatives = 1;
+        const std::size_t NumberOfIntegrationPoints = rIntegrationPoints.size();
+
+        rResult.Span1.resize(NumberOfIntegrationPoints);
+        rResult.Span2.resize(NumberOfIntegrationPoints);
+        rResult.Span3.resize(NumberOfIntegrationPoints);
+        rResult.Ders1.resize(NumberOfIntegrationPoints);
+        rResult.Ders2.resize(NumberOfIntegrationPoints);
+        rResult.Ders3.resize(NumberOfIntegrationPoints);
+
+        for(std::size_t pnt = 0; pnt < NumberOfIntegrationPoints; ++pnt)
+        {
+            const CoordinatesArrayType& rPoint = rIntegrationPoints[pnt];
+            rResult.Span1[pnt] = mSpanLocator1.FindSpan(mNumber1, mOrder1, rPoint[0]);
+            rResult.Span2[pnt] = mSpanLocator2.FindSpan(mNumber2, mOrder2, rPoint[1]);
+            rResult.Span3[pnt] = mSpanLocator3.FindSpan(mNumber3, mOrder3, rPoint[2]);
+            rResult.Ders1[pnt].resize(NumberOfDerivatives + 1, mOrder1 + 1, false);
+            rResult.Ders2[pnt].resize(NumberOfDerivatives + 1, mOrder2 + 1, false);
+            rResult.Ders3[pnt].resize(NumberOfDerivatives + 1, mOrder3 + 1, false);
+            BSplineUtils::BasisFunsDer(rResult.Ders1[pnt], rResult.Span1[pnt], rPoint[0], mOrder1, mKnots1, NumberOfDerivatives, BSplineUtils::MatrixOp());
+            BSplineUtils::BasisFunsDer(rResult.Ders2[pnt], rResult.Span2[pnt], rPoint[1], mOrder2, mKnots2, NumberOfDerivatives, BSplineUtils::MatrixOp());
+            BSplineUtils::BasisFunsDer(rResult.Ders3[pnt], rResult.Span3[pnt], rPoint[2], mOrder3, mKnots3, NumberOfDerivatives, BSplineUtils::MatrixOp());
+        }
+    }
+
+    /**
+     * Get the knot spans and univariate B-splines at the integration points of an integration method. They are taken from
+     * the tables computed in GenerateGeometryData, or computed in rTemp if the integration method has no table.
+     */
+    const SpanBasisFunctions& GetSpanBasisFunctions( SpanBasisFunctions& rTemp, IntegrationMethod ThisMethod ) const
+    {
+        if ( static_cast<std::size_t>(ThisMethod) < mSpanBasisFunctions.size() )
+            return mSpanBasisFunctions[ThisMethod];
+
+        ComputeSpanBasisFunctions( rTemp, this->IntegrationPoints( ThisMethod ) );
+        return rTemp;
+    }
+
+    /**
+     * Compute the Jacobian at an integration point using only the (p1+1)*(p2+1)*(p3+1) functions supported on the knot span
+     * containing it. The homogeneous control points (w*x, w*y, w*z, w) are contracted with the univariate B-splines one
+     * parametric direction at a time, hence the shape functions are not formed.
+     * @param rBasisFunctions the knot spans and univariate B-splines at the integration points
+     * @param pDeltaPosition if not NULL, the nodal position increment added to the nodal coordinates
+     */
+    void CalculateJacobianOnSpan( Matrix& rResult, const SpanBasisFunctions& rBasisFunctions, const std::size_t& IntegrationPointIndex,
+            const Matrix* pDeltaPosition ) const
+    {
+        const int Span1 = rBasisFunctions.Span1[IntegrationPointIndex];
+        const int Span2 = rBasisFunctions.Span2[IntegrationPointIndex];
+        const int Span3 = rBasisFunctions.Span3[IntegrationPointIndex];
+        const int Start1 = Span1 - mOrder1;
+        const int Start2 = Span2 - mOrder2;
+        const int Start3 = Span3 - mOrder3;
+        const Matrix& ShapeFunctionsValuesAndDerivatives1 = rBasisFunctions.Ders1[IntegrationPointIndex];
+        const Matrix& ShapeFunctionsValuesAndDerivatives2 = rBasisFunctions.Ders2[IntegrationPointIndex];
+        const Matrix& ShapeFunctionsValuesAndDerivatives3 = rBasisFunctions.Ders3[IntegrationPointIndex];
+
+        // F[c], F1[c], F2[c], F3[c] are the value and local derivatives of the homogeneous component c
+        double F[4] = {0.0, 0.0, 0.0, 0.0};
+        double F1[4] = {0.0, 0.0, 0.0, 0.0};
+        double F2[4] = {0.0, 0.0, 0.0, 0.0};
+        double F3[4] = {0.0, 0.0, 0.0, 0.0};
+        double T2v[4], T2d2[4], T2d3[4], T3v[4], T3d[4], P[4];
+        double W;
+        int i, j, k, c, Index;
+        for(i = Start1; i <= Span1; ++i)
+        {
+            // contract on direction 2 and 3
+            for(c = 0; c < 4; ++c)
+                T2v[c] = T2d2[c] = T2d3[c] = 0.0;
+
+            for(j = Start2; j <= Span2; ++j)
+            {
+                // contract on direction 3
+                for(c = 0; c < 4; ++c)
+                    T3v[c] = T3d[c] = 0.0;
+
+                for(k = Start3; k <= Span3; ++k)
+                {
+                    Index = (i * mNumber2 + j) * mNumber3 + k;
+
+                    W = mCtrlWeights[Index];
+                    P[0] = W * this->GetPoint(Index).X();
+                    P[1] = W * this->GetPoint(Index).Y();
+                    P[2] = W * this->GetPoint(Index).Z();
+                    P[3] = W;
+                    if(pDeltaPosition != NULL)
+                    {
+                        P[0] += W * (*pDeltaPosition)(Index, 0);
+                        P[1] += W * (*pDeltaPosition)(Index, 1);
+                        P[2] += W * (*pDeltaPosition)(Index, 2);
+                    }
+
+                    for(c = 0; c < 4; ++c)
+                    {
+                        T3v[c] += P[c] * ShapeFunctionsValuesAndDerivatives3(0, k - Start3);
+                        T3d[c] += P[c] * ShapeFunctionsValuesAndDerivatives3(1, k - Start3);
+                    }
+                }
+
+                for(c = 0; c < 4; ++c)
+                {
+                    T2v[c] += T3v[c] * ShapeFunctionsValuesAndDerivatives2(0, j - Start2);
+                    T2d2[c] += T3v[c] * ShapeFunctionsValuesAndDerivatives2(1, j - Start2);
+                    T2d3[c] += T3d[c] * ShapeFunctionsValuesAndDerivatives2(0, j - Start2);
+                }
+            }
+
+            // contract on direction 1
+            for(c = 0; c < 4; ++c)
+            {
+                F[c] += T2v[c] * ShapeFunctionsValuesAndDerivatives1(0, i - Start1);
+                F1[c] += T2v[c] * ShapeFunctionsValuesAndDerivatives1(1, i - Start1);
+                F2[c] += T2d2[c] * ShapeFunctionsValuesAndDerivatives1(0, i - Start1);
+                F3[c] += T2d3[c] * ShapeFunctionsValuesAndDerivatives1(0, i - Start1);
+            }
+        }
+
+        // J(c, d) = d(F[c] / F[3]) / dxi_d
+        rResult.resize(3, 3, false);
+        double x;
+        for(c = 0; c < 3; ++c)
+        {
+            x = F[c] / F[3];
+            rResult(c, 0) = (F1[c] - x * F1[3]) / F[3];
+            rResult(c, 1) = (F2[c] - x * F2[3]) / F[3];
+            rResult(c, 2) = (F3[c] - x * F3[3]) / F[3];
+        }
+    }
 
 private:
 
@@ -1651,6 +1766,11 @@ private:
     ValuesContainerType mKnots1; //knots vector
     ValuesContainerType mKnots2; //knots vector
     ValuesContainerType mKnots3; //knots vector
+    KnotSpanLocator mSpanLocator1; //span lookup on the knot vector
+    KnotSpanLocator mSpanLocator2; //span lookup on the knot vector
+    KnotSpanLocator mSpanLocator3; //span lookup on the knot vector
+
+    std::vector<SpanBasisFunctions> mSpanBasisFunctions; //knot spans and univariate B-splines at the integration points of each integration method
 
     ValuesContainerType mCtrlWeights;//weight of control points
 
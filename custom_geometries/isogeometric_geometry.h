@@ -72,6 +72,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "utilities/math_utils.h"
 #include "integration/quadrature.h"
 #include "integration/line_gauss_legendre_integration_points.h"
+#include "custom_utilities/shape_functions_table_cache.h"
+#include "custom_utilities/shape_functions_precompute_manager.h"
 
 
 namespace Kratos
@@ -236,6 +238,11 @@ public:
      */
     typedef Matrix MatrixType;
 
+    /**
+     * Type of the pointer to an extraction operator, shared between the cells and the geometries
+     */
+    typedef boost::shared_ptr<const MatrixType> ExtractionOperatorPointerType;
+
     /**
      * Type of Vector
      */
@@ -246,9 +253,10 @@ public:
     ///@{
 
     IsogeometricGeometry() : BaseType()
-    #ifndef ENABLE_PRECOMPUTE
     , mIsInitialized(false)
-    #endif
+    , mInitializedMethod(GeometryData::NumberOfIntegrationMethods)
+    , mPrecomputePolicy(ShapeFunctionsPrecomputeManager::DefaultPolicy())
+    , mTablesSize(0)
     {
     }
 
@@ -269,9 +277,10 @@ public:
     IsogeometricGeometry( const PointsArrayType& ThisPoints,
               GeometryData const* pThisGeometryData = 0 )
     : BaseType( ThisPoints, pThisGeometryData )
-    #ifndef ENABLE_PRECOMPUTE
     , mIsInitialized(false)
-    #endif
+    , mInitializedMethod(GeometryData::NumberOfIntegrationMethods)
+    , mPrecomputePolicy(ShapeFunctionsPrecomputeManager::DefaultPolicy())
+    , mTablesSize(0)
     {
     }
 
@@ -285,9 +294,10 @@ public:
     */
     IsogeometricGeometry( const IsogeometricGeometry& rOther )
     : BaseType( rOther )
-    #ifndef ENABLE_PRECOMPUTE
     , mIsInitialized(false)
-    #endif
+    , mInitializedMethod(GeometryData::NumberOfIntegrationMethods)
+    , mPrecomputePolicy(rOther.mPrecomputePolicy)
+    , mTablesSize(0)
     {
     }
 
@@ -304,14 +314,18 @@ public:
     */
     template<class TOtherPointType> IsogeometricGeometry( IsogeometricGeometry<TOtherPointType> const & rOther )
     : BaseType( rOther.begin(), rOther.end() )
-    #ifndef ENABLE_PRECOMPUTE
     , mIsInitialized(false)
-    #endif
+    , mInitializedMethod(GeometryData::NumberOfIntegrationMethods)
+    , mPrecomputePolicy(ShapeFunctionsPrecomputeManager::DefaultPolicy())
+    , mTablesSize(0)
     {
     }
 
     /// Destructor. Do nothing!!!
-    virtual ~IsogeometricGeometry() {}
+    virtual ~IsogeometricGeometry()
+    {
+        this->ReleaseTables();
+    }
 
     ///@}
     ///@name Operators
@@ -447,6 +461,88 @@ public:
         KRATOS_THROW_ERROR(std::logic_error, "Calling IsogeometricGeometry base class function", __FUNCTION__)
     }
 
+    /**
+     * Subroutine to pass in the data to the Bezier element, with the extraction operator shared with the cell (or other geometries).
+     * The geometry keeps the instance instead of copying it. By default, the operator is copied by the subroutine above.
+     */
+    virtual void AssignGeometryData
+    (
+        const ValuesContainerType& Knots1,
+        const ValuesContainerType& Knots2,
+        const ValuesContainerType& Knots3,
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, *pExtractionOperator,
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
+    /**
+     * Subroutine to pass in the data to the Bezier element, with the extraction operator given in factored form, i.e.
+     * C = C1 x C2 x C3 is the Kronecker product of the 1D extraction operators on each parametric direction (first direction varies slowest).
+     * By default, the Kronecker product is formed and passed to the subroutine above. The geometry which can work with the factors directly shall override this.
+     */
+    virtual void AssignGeometryData
+    (
+        const ValuesContainerType& Knots1,
+        const ValuesContainerType& Knots2,
+        const ValuesContainerType& Knots3,
+        const ValuesContainerType& Weights,
+        const MatrixType& ExtractionOperator1,
+        const MatrixType& ExtractionOperator2,
+        const MatrixType& ExtractionOperator3,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
+    {
+        const std::size_t n1 = ExtractionOperator1.size1(), m1 = ExtractionOperator1.size2();
+        const std::size_t n2 = ExtractionOperator2.size1(), m2 = ExtractionOperator2.size2();
+        const std::size_t n3 = ExtractionOperator3.size1(), m3 = ExtractionOperator3.size2();
+
+        MatrixType ExtractionOperator(n1*n2*n3, m1*m2*m3);
+        for (std::size_t i = 0; i < n1; ++i)
+            for (std::size_t j = 0; j < n2; ++j)
+                for (std::size_t k = 0; k < n3; ++k)
+                    for (std::size_t a = 0; a < m1; ++a)
+                        for (std::size_t b = 0; b < m2; ++b)
+                            for (std::size_t c = 0; c < m3; ++c)
+                                ExtractionOperator(k + (j + i*n2)*n3, c + (b + a*m2)*m3)
+                                    = ExtractionOperator1(i, a) * ExtractionOperator2(j, b) * ExtractionOperator3(k, c);
+
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, ExtractionOperator,
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
+    /**
+     * Subroutine to pass in the data to the Bezier element, with the factors of the extraction operator shared with the cell (or other geometries).
+     * By default, the factors are copied by the subroutine above.
+     */
+    virtual void AssignGeometryData
+    (
+        const ValuesContainerType& Knots1,
+        const ValuesContainerType& Knots2,
+        const ValuesContainerType& Knots3,
+        const ValuesContainerType& Weights,
+        ExtractionOperatorPointerType pExtractionOperator1,
+        ExtractionOperatorPointerType pExtractionOperator2,
+        ExtractionOperatorPointerType pExtractionOperator3,
+        const int& Degree1,
+        const int& Degree2,
+        const int& Degree3,
+        const int& NumberOfIntegrationMethod
+    )
+    {
+        this->AssignGeometryData(Knots1, Knots2, Knots3, Weights, *pExtractionOperator1, *pExtractionOperator2, *pExtractionOperator3,
+                Degree1, Degree2, Degree3, NumberOfIntegrationMethod);
+    }
+
     virtual void CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
         MatrixType& shape_functions_values,
         ShapeFunctionsGradientsType& shape_functions_local_gradients,
@@ -479,6 +575,16 @@ public:
         KRATOS_THROW_ERROR(std::logic_error, "Calling IsogeometricGeometry base class function", __FUNCTION__)
     }
 
+    /**
+     * Get the key of the equivalence class of this geometry in the ShapeFunctionsTableCache, i.e. the data which fully
+     * determines the shape function values and local gradients at the integration points of ThisMethod.
+     * Return false if the tables of this geometry cannot be shared.
+     */
+    virtual bool GetShapeFunctionsTableKey(ShapeFunctionsTableCache::KeyType& rKey, IntegrationMethod ThisMethod) const
+    {
+        return false;
+    }
+
     /**
      * Compute the Jacobian in reference configuration
      */
@@ -543,67 +649,139 @@ public:
     /******************************************************
         OVERRIDE FROM GEOMETRY
     *******************************************************/
+    /**
+     * Compute the shape function values and local gradients at the integration points. Depending on the precompute
+     * policy, the tables may be already available from a previous call.
+     */
     virtual void Initialize(IntegrationMethod ThisMethod)
     {
-        #ifndef ENABLE_PRECOMPUTE
-        if(!mIsInitialized)
+        if(mIsInitialized)
+        {
+            if(mInitializedMethod == ThisMethod)
+            {
+                if(mPrecomputePolicy != _PRECOMPUTE_NEVER_)
+                    ShapeFunctionsPrecomputeManager::AddHit();
+                return;
+            }
+
+            // the tables were computed for another integration method
+            this->ReleaseTables();
+        }
+
+        if(mPrecomputePolicy == _PRECOMPUTE_LRU_)
         {
-            mpInternal_Ncontainer = boost::shared_ptr<Matrix>(new Matrix());
-            mpInternal_DN_De = boost::shared_ptr<ShapeFunctionsGradientsType>(new ShapeFunctionsGradientsType());
-            this->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(*mpInternal_Ncontainer, *mpInternal_DN_De, ThisMethod);
-            mIsInitialized = true;
+            if(ShapeFunctionsPrecomputeManager::Acquire(this, ThisMethod, mpInternal_Ncontainer, mpInternal_DN_De, mTablesSize))
+            {
+                ShapeFunctionsPrecomputeManager::AddHit();
+                mInitializedMethod = ThisMethod;
+                mIsInitialized = true;
+                return;
+            }
         }
-        #endif
+
+        // share the tables with the equivalent geometries if the cache is enabled
+        ShapeFunctionsTableCache::KeyType Key;
+        const bool use_cache = ShapeFunctionsTableCache::IsEnabled() && this->GetShapeFunctionsTableKey(Key, ThisMethod);
+        bool is_cached = false;
+        if(use_cache)
+            is_cached = ShapeFunctionsTableCache::Find(Key, mpInternal_Ncontainer, mpInternal_DN_De);
+
+        mTablesSize = 0;
+        if(!is_cached)
+        {
+            boost::shared_ptr<Matrix> pNcontainer(new Matrix());
+            boost::shared_ptr<ShapeFunctionsGradientsType> pDN_De(new ShapeFunctionsGradientsType());
+            this->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(*pNcontainer, *pDN_De, ThisMethod);
+            mpInternal_Ncontainer = pNcontainer;
+            mpInternal_DN_De = pDN_De;
+
+            if(use_cache)
+                is_cached = ShapeFunctionsTableCache::Insert(Key, mpInternal_Ncontainer, mpInternal_DN_De);
+
+            // the tables held by the cache are not attributed to this geometry
+            if(!is_cached)
+                mTablesSize = ShapeFunctionsPrecomputeManager::MemoryUsage(*mpInternal_Ncontainer, *mpInternal_DN_De);
+        }
+
+        if(mPrecomputePolicy != _PRECOMPUTE_NEVER_)
+            ShapeFunctionsPrecomputeManager::AddMiss();
+        if(mPrecomputePolicy == _PRECOMPUTE_LAZY_ || mPrecomputePolicy == _PRECOMPUTE_EAGER_)
+            ShapeFunctionsPrecomputeManager::AddResident(mTablesSize);
+
+        mInitializedMethod = ThisMethod;
+        mIsInitialized = true;
     }
 
+    /**
+     * Compute the shape function values and local gradients at the given integration points. These tables are always
+     * released at Clean, whatever the precompute policy.
+     */
     virtual void Initialize(const IntegrationPointsArrayType& integration_points)
     {
-        #ifndef ENABLE_PRECOMPUTE
-        if(!mIsInitialized)
-        {
-            mpInternal_Ncontainer = boost::shared_ptr<Matrix>(new Matrix());
-            mpInternal_DN_De = boost::shared_ptr<ShapeFunctionsGradientsType>(new ShapeFunctionsGradientsType());
-            this->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(*mpInternal_Ncontainer, *mpInternal_DN_De, integration_points);
-            mIsInitialized = true;
-        }
-        #else
-        KRATOS_THROW_ERROR(std::logic_error, __FUNCTION__, "is not available in the PRECOMPUTE mode")
-        #endif
+        if(mIsInitialized && mInitializedMethod == GeometryData::NumberOfIntegrationMethods)
+            return;
+
+        this->ReleaseTables();
+
+        boost::shared_ptr<Matrix> pNcontainer(new Matrix());
+        boost::shared_ptr<ShapeFunctionsGradientsType> pDN_De(new ShapeFunctionsGradientsType());
+        this->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(*pNcontainer, *pDN_De, integration_points);
+        mpInternal_Ncontainer = pNcontainer;
+        mpInternal_DN_De = pDN_De;
+        mTablesSize = 0;
+        mInitializedMethod = GeometryData::NumberOfIntegrationMethods;
+        mIsInitialized = true;
     }
 
+    /**
+     * Release the shape function tables, or keep them according to the precompute policy
+     */
     virtual void Clean()
     {
-        #ifndef ENABLE_PRECOMPUTE
-        if (mIsInitialized)
+        if(!mIsInitialized)
+            return;
+
+        if(mInitializedMethod != GeometryData::NumberOfIntegrationMethods)
         {
-            mpInternal_DN_De.reset();
-            mpInternal_Ncontainer.reset();
-            mIsInitialized = false;
+            if(mPrecomputePolicy == _PRECOMPUTE_LAZY_ || mPrecomputePolicy == _PRECOMPUTE_EAGER_)
+                return;
+
+            if(mPrecomputePolicy == _PRECOMPUTE_LRU_)
+                ShapeFunctionsPrecomputeManager::Release(this, mInitializedMethod, mpInternal_Ncontainer, mpInternal_DN_De, mTablesSize);
         }
-        #endif
+
+        mpInternal_DN_De.reset();
+        mpInternal_Ncontainer.reset();
+        mTablesSize = 0;
+        mIsInitialized = false;
     }
 
-    #ifndef ENABLE_PRECOMPUTE
-    virtual const Matrix& ShapeFunctionsValues( IntegrationMethod ThisMethod )  const
+    /**
+     * Set the precompute policy of the shape function tables (see ShapeFunctionsPrecomputePolicy). The kept tables are
+     * released. With the _PRECOMPUTE_EAGER_ policy, the tables of the default integration method are computed at once
+     * if the geometry data is already assigned.
+     */
+    void SetPrecomputePolicy(const int& Policy)
     {
-        return *mpInternal_Ncontainer;
+        this->ReleaseTables();
+        mPrecomputePolicy = Policy;
+        this->ResetPrecomputedTables();
     }
 
-    virtual const ShapeFunctionsGradientsType& ShapeFunctionsLocalGradients( IntegrationMethod ThisMethod ) const
+    int GetPrecomputePolicy() const
     {
-        return *mpInternal_DN_De;
+        return mPrecomputePolicy;
     }
-    #else
+
     virtual const Matrix& ShapeFunctionsValues( IntegrationMethod ThisMethod )  const
     {
-        return BaseType::ShapeFunctionsValues( ThisMethod );
+        return *mpInternal_Ncontainer;
     }
 
     virtual const ShapeFunctionsGradientsType& ShapeFunctionsLocalGradients( IntegrationMethod ThisMethod ) const
     {
-        return BaseType::ShapeFunctionsLocalGradients( ThisMethod );
+        return *mpInternal_DN_De;
     }
-    #endif
 
     virtual Vector& ShapeFunctionsValues( Vector& rResults, const CoordinatesArrayType& rCoordinates ) const
     {
@@ -698,6 +876,16 @@ protected:
     ///@name Protected Operations
     ///@{
 
+    /**
+     * To be called by the derived classes once the geometry data is (re)assigned: release the tables computed with the
+     * previous data, and compute the tables of the default integration method if the precompute policy is _PRECOMPUTE_EAGER_
+     */
+    void ResetPrecomputedTables()
+    {
+        this->ReleaseTables();
+        if(mPrecomputePolicy == _PRECOMPUTE_EAGER_ && BaseType::mpGeometryData != NULL)
+            this->Initialize(BaseType::GetDefaultIntegrationMethod());
+    }
 
     ///@}
     ///@name Protected  Access
@@ -731,11 +919,12 @@ private:
     ///@name Member Variables
     ///@{
 
-    #ifndef ENABLE_PRECOMPUTE
     bool mIsInitialized;
-    boost::shared_ptr<ShapeFunctionsGradientsType> mpInternal_DN_De;
-    boost::shared_ptr<Matrix> mpInternal_Ncontainer;
-    #endif
+    IntegrationMethod mInitializedMethod; // NumberOfIntegrationMethods if initialized with given integration points
+    int mPrecomputePolicy;
+    std::size_t mTablesSize; // memory of the tables attributed to this geometry
+    boost::shared_ptr<const ShapeFunctionsGradientsType> mpInternal_DN_De;
+    boost::shared_ptr<const Matrix> mpInternal_Ncontainer;
 
     ///@}
     ///@name Serialization
@@ -765,6 +954,25 @@ private:
     ///@name Private Operations
     ///@{
 
+    /// Release the tables whatever the precompute policy, and update the statistics
+    void ReleaseTables()
+    {
+        if(mPrecomputePolicy == _PRECOMPUTE_LRU_)
+            ShapeFunctionsPrecomputeManager::Remove(this);
+
+        if(!mIsInitialized)
+            return;
+
+        if(mInitializedMethod != GeometryData::NumberOfIntegrationMethods
+            && (mPrecomputePolicy == _PRECOMPUTE_LAZY_ || mPrecomputePolicy == _PRECOMPUTE_EAGER_))
+            ShapeFunctionsPrecomputeManager::RemoveResident(mTablesSize);
+
+        mpInternal_DN_De.reset();
+        mpInternal_Ncontainer.reset();
+        mTablesSize = 0;
+        mIsInitialized = false;
+    }
+
     ///@}
     ///@name Private  Access
     ///@{
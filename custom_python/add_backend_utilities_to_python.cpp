@@ -28,6 +28,9 @@ LICENSE: see isogeometric_application/LICENSE.txt
 #include "custom_utilities/nurbs_test_utils.h"
 #include "custom_utilities/bezier_test_utils.h"
 #include "custom_utilities/isogeometric_merge_utility.h"
+#include "custom_utilities/shape_functions_table_cache.h"
+#include "custom_utilities/shape_functions_precompute_manager.h"
+#include "custom_utilities/shape_functions_precompute_utility.h"
 
 #ifdef ISOGEOMETRIC_USE_HDF5
 #include "custom_utilities/hdf5_post_utility.h"
@@ -89,6 +92,18 @@ void BezierUtils_Bernstein_der(
     dummy.bernstein(rS, rD, p, x);
 }
 
+Matrix BezierUtils_BernsteinDerivatives(
+    BezierUtils& dummy,
+    const int p,
+    const int k,
+    const double x
+)
+{
+    Matrix Ders;
+    dummy.bernstein_derivatives(Ders, p, k, x);
+    return Ders;
+}
+
 void BezierUtils_DumpShapeFunctionsIntegrationPointsValuesAndLocalGradients(
     BezierUtils& dummy,
     ModelPart::Pointer pModelPart,
@@ -98,6 +113,121 @@ void BezierUtils_DumpShapeFunctionsIntegrationPointsValuesAndLocalGradients(
     dummy.DumpShapeFunctionsIntegrationPointsValuesAndLocalGradients(pModelPart, FileName);
 }
 
+void BezierUtils_RegisterIntegrationRules(
+    BezierUtils& dummy,
+    unsigned int NumberOfIntegrationMethod,
+    unsigned int MaxOrder
+)
+{
+    dummy.RegisterIntegrationRules(NumberOfIntegrationMethod, MaxOrder);
+}
+
+std::size_t BezierUtils_NumberOfRegisteredIntegrationRules(
+    BezierUtils& dummy
+)
+{
+    return dummy.NumberOfRegisteredIntegrationRules();
+}
+
+void ShapeFunctionsTableCache_Enable(ShapeFunctionsTableCache& dummy)
+{
+    dummy.Enable();
+}
+
+void ShapeFunctionsTableCache_Disable(ShapeFunctionsTableCache& dummy)
+{
+    dummy.Disable();
+}
+
+bool ShapeFunctionsTableCache_IsEnabled(ShapeFunctionsTableCache& dummy)
+{
+    return dummy.IsEnabled();
+}
+
+void ShapeFunctionsTableCache_SetMemoryBudget(ShapeFunctionsTableCache& dummy, std::size_t Budget)
+{
+    dummy.SetMemoryBudget(Budget);
+}
+
+std::size_t ShapeFunctionsTableCache_MemoryBudget(ShapeFunctionsTableCache& dummy)
+{
+    return dummy.MemoryBudget();
+}
+
+void ShapeFunctionsTableCache_Clear(ShapeFunctionsTableCache& dummy)
+{
+    dummy.Clear();
+}
+
+void ShapeFunctionsTableCache_ResetStatistics(ShapeFunctionsTableCache& dummy)
+{
+    dummy.ResetStatistics();
+}
+
+boost::python::dict ShapeFunctionsTableCache_Statistics(ShapeFunctionsTableCache& dummy)
+{
+    boost::python::dict stats;
+    stats["entries"] = dummy.NumberOfEntries();
+    stats["memory_usage"] = dummy.MemoryUsage();
+    stats["memory_budget"] = dummy.MemoryBudget();
+    stats["lookups"] = dummy.NumberOfLookups();
+    stats["hits"] = dummy.NumberOfHits();
+    stats["rejections"] = dummy.NumberOfRejections();
+    return stats;
+}
+
+void ShapeFunctionsPrecomputeManager_SetDefaultPolicy(ShapeFunctionsPrecomputeManager& dummy, int Policy)
+{
+    dummy.SetDefaultPolicy(Policy);
+}
+
+int ShapeFunctionsPrecomputeManager_DefaultPolicy(ShapeFunctionsPrecomputeManager& dummy)
+{
+    return dummy.DefaultPolicy();
+}
+
+void ShapeFunctionsPrecomputeManager_SetMemoryBudget(ShapeFunctionsPrecomputeManager& dummy, std::size_t Budget)
+{
+    dummy.SetMemoryBudget(Budget);
+}
+
+std::size_t ShapeFunctionsPrecomputeManager_MemoryBudget(ShapeFunctionsPrecomputeManager& dummy)
+{
+    return dummy.MemoryBudget();
+}
+
+void ShapeFunctionsPrecomputeManager_Clear(ShapeFunctionsPrecomputeManager& dummy)
+{
+    dummy.Clear();
+}
+
+void ShapeFunctionsPrecomputeManager_ResetStatistics(ShapeFunctionsPrecomputeManager& dummy)
+{
+    dummy.ResetStatistics();
+}
+
+boost::python::dict ShapeFunctionsPrecomputeManager_Statistics(ShapeFunctionsPrecomputeManager& dummy)
+{
+    boost::python::dict stats;
+    stats["hits"] = dummy.NumberOfHits();
+    stats["misses"] = dummy.NumberOfMisses();
+    stats["evictions"] = dummy.NumberOfEvictions();
+    stats["bytes_resident"] = dummy.BytesResident();
+    stats["bytes_in_store"] = dummy.BytesInStore();
+    stats["memory_budget"] = dummy.MemoryBudget();
+    return stats;
+}
+
+void ShapeFunctionsPrecomputeUtility_SetPolicy(ShapeFunctionsPrecomputeUtility& dummy, ModelPart& r_model_part, int Policy)
+{
+    dummy.SetPolicy(r_model_part, Policy);
+}
+
+void ShapeFunctionsPrecomputeUtility_SetPolicyFromProperties(ShapeFunctionsPrecomputeUtility& dummy, ModelPart& r_model_part)
+{
+    dummy.SetPolicyFromProperties(r_model_part);
+}
+
 template<class T>
 void BezierUtils_ComputeCentroid(
     BezierUtils& dummy,
@@ -269,13 +399,52 @@ void IsogeometricApplication_AddBackendUtilitiesToPython()
     class_<BezierUtils, BezierUtils::Pointer, boost::noncopyable>("BezierUtils", init<>())
     .def("Bernstein", BezierUtils_Bernstein)
     .def("BernsteinDerivative", BezierUtils_Bernstein_der)
+    .def("BernsteinDerivatives", BezierUtils_BernsteinDerivatives)
     .def("DumpShapeFunctionsIntegrationPointsValuesAndLocalGradients", BezierUtils_DumpShapeFunctionsIntegrationPointsValuesAndLocalGradients)
     .def("ComputeCentroid", BezierUtils_ComputeCentroid<Element>)
     .def("ComputeCentroid", BezierUtils_ComputeCentroid<Condition>)
+    .def("RegisterIntegrationRules", BezierUtils_RegisterIntegrationRules)
+    .def("NumberOfRegisteredIntegrationRules", BezierUtils_NumberOfRegisteredIntegrationRules)
 //    .def("compute_extended_knot_vector", &BezierUtils::compute_extended_knot_vector)
 //    .def("bezier_extraction_tsplines_1d", &BezierUtils::bezier_extraction_tsplines_1d)
     ;
 
+    class_<ShapeFunctionsTableCache, ShapeFunctionsTableCache::Pointer, boost::noncopyable>("ShapeFunctionsTableCache", init<>())
+    .def("Enable", ShapeFunctionsTableCache_Enable)
+    .def("Disable", ShapeFunctionsTableCache_Disable)
+    .def("IsEnabled", ShapeFunctionsTableCache_IsEnabled)
+    .def("SetMemoryBudget", ShapeFunctionsTableCache_SetMemoryBudget)
+    .def("MemoryBudget", ShapeFunctionsTableCache_MemoryBudget)
+    .def("Clear", ShapeFunctionsTableCache_Clear)
+    .def("ResetStatistics", ShapeFunctionsTableCache_ResetStatistics)
+    .def("Statistics", ShapeFunctionsTableCache_Statistics)
+    .def(self_ns::str(self))
+    ;
+
+    enum_<ShapeFunctionsPrecomputePolicy>("ShapeFunctionsPrecomputePolicy")
+    .value("Never", _PRECOMPUTE_NEVER_)
+    .value("Lazy", _PRECOMPUTE_LAZY_)
+    .value("Eager", _PRECOMPUTE_EAGER_)
+    .value("LRU", _PRECOMPUTE_LRU_)
+    ;
+
+    class_<ShapeFunctionsPrecomputeManager, ShapeFunctionsPrecomputeManager::Pointer, boost::noncopyable>("ShapeFunctionsPrecomputeManager", init<>())
+    .def("SetDefaultPolicy", ShapeFunctionsPrecomputeManager_SetDefaultPolicy)
+    .def("DefaultPolicy", ShapeFunctionsPrecomputeManager_DefaultPolicy)
+    .def("SetMemoryBudget", ShapeFunctionsPrecomputeManager_SetMemoryBudget)
+    .def("MemoryBudget", ShapeFunctionsPrecomputeManager_MemoryBudget)
+    .def("Clear", ShapeFunctionsPrecomputeManager_Clear)
+    .def("ResetStatistics", ShapeFunctionsPrecomputeManager_ResetStatistics)
+    .def("Statistics", ShapeFunctionsPrecomputeManager_Statistics)
+    .def(self_ns::str(self))
+    ;
+
+    class_<ShapeFunctionsPrecomputeUtility, ShapeFunctionsPrecomputeUtility::Pointer, boost::noncopyable>("ShapeFunctionsPrecomputeUtility", init<>())
+    .def("SetPolicy", ShapeFunctionsPrecomputeUtility_SetPolicy)
+    .def("SetPolicyFromProperties", ShapeFunctionsPrecomputeUtility_SetPolicyFromProperties)
+    .def(self_ns::str(self))
+    ;
+
     class_<IsogeometricPostUtility,IsogeometricPostUtility::Pointer, boost::noncopyable>("IsogeometricPostUtility", init<>())
     .def("TransferElements", &IsogeometricPostUtility_TransferElements)
     .def("TransferConditions", &IsogeometricPostUtility_TransferConditions)
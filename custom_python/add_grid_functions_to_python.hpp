@@ -95,6 +95,146 @@ boost::python::list GridFunction_GetDerivative(TGridFrunctionType& rDummy, const
     return results;
 }
 
+/// Access to the scalar components of the grid function data, to export the batch results as contiguous matrices
+template<typename TDataType>
+struct GridFunctionDataComponents
+{};
+
+template<>
+struct GridFunctionDataComponents<double>
+{
+    static std::size_t Size(const double& v) {return 1;}
+    static double Get(const double& v, const std::size_t& i) {return v;}
+};
+
+template<>
+struct GridFunctionDataComponents<array_1d<double, 3> >
+{
+    static std::size_t Size(const array_1d<double, 3>& v) {return 3;}
+    static double Get(const array_1d<double, 3>& v, const std::size_t& i) {return v[i];}
+};
+
+template<>
+struct GridFunctionDataComponents<Vector>
+{
+    static std::size_t Size(const Vector& v) {return v.size();}
+    static double Get(const Vector& v, const std::size_t& i) {return v(i);}
+};
+
+/// the homogeneous components (WX, WY, WZ, W) of the control point
+template<>
+struct GridFunctionDataComponents<ControlPoint<double> >
+{
+    static std::size_t Size(const ControlPoint<double>& v) {return 4;}
+    static double Get(const ControlPoint<double>& v, const std::size_t& i) {return v[i];}
+};
+
+/// Copy the data to a matrix, each row for each data and each column for each component
+template<typename TDataType>
+void GridFunction_CopyToMatrix(Matrix& rResults, const std::vector<TDataType>& rData)
+{
+    typedef GridFunctionDataComponents<TDataType> ComponentsType;
+    const std::size_t ncomponents = (rData.size() == 0) ? 0 : ComponentsType::Size(rData[0]);
+    rResults.resize(rData.size(), ncomponents, false);
+    for (std::size_t q = 0; q < rData.size(); ++q)
+        for (std::size_t i = 0; i < ncomponents; ++i)
+            rResults(q, i) = ComponentsType::Get(rData[q], i);
+}
+
+/// Extract the local coordinates of the points given by the rows of a matrix; the missing coordinates are zero
+template<class TGridFrunctionType>
+void GridFunction_ExtractPoints(std::vector<array_1d<double, 3> >& rPoints, const Matrix& points)
+{
+    const std::size_t dim = TGridFrunctionType::FESpaceType::Dim();
+    if (points.size2() < dim)
+        KRATOS_THROW_ERROR(std::logic_error, "The number of columns of the points matrix must be at least", dim)
+
+    rPoints.resize(points.size1());
+    for (std::size_t q = 0; q < points.size1(); ++q)
+    {
+        noalias(rPoints[q]) = ZeroVector(3);
+        for (std::size_t i = 0; i < dim; ++i)
+            rPoints[q][i] = points(q, i);
+    }
+}
+
+/// Extract the coordinates of the tensor grid from a list of coordinate vectors, one per direction
+inline void GridFunction_ExtractCoordinates(std::vector<std::vector<double> >& rCoordinates, const boost::python::list& coordinates)
+{
+    typedef boost::python::stl_input_iterator<Vector> iterator_coordinates_type;
+    BOOST_FOREACH(const iterator_coordinates_type::value_type& c, std::make_pair(iterator_coordinates_type(coordinates), iterator_coordinates_type() ) )
+    {
+        rCoordinates.push_back(std::vector<double>(c.begin(), c.end()));
+    }
+}
+
+/// Values at the points given by the rows of a matrix. The values are returned as a matrix with one row per point.
+template<class TGridFrunctionType>
+Matrix GridFunction_GetValues(TGridFrunctionType& rDummy, const Matrix& points)
+{
+    std::vector<array_1d<double, 3> > points_vec;
+    GridFunction_ExtractPoints<TGridFrunctionType>(points_vec, points);
+
+    std::vector<typename TGridFrunctionType::DataType> values;
+    rDummy.GetValues(values, points_vec);
+
+    Matrix values_mat;
+    GridFunction_CopyToMatrix(values_mat, values);
+    return values_mat;
+}
+
+/// Values at the points of the tensor grid given by a list of coordinate vectors, one per direction.
+/// The results are arranged as in GridFunction_GetValues.
+template<class TGridFrunctionType>
+Matrix GridFunction_GetValuesOnGrid(TGridFrunctionType& rDummy, const boost::python::list& coordinates)
+{
+    std::vector<std::vector<double> > coordinates_vec;
+    GridFunction_ExtractCoordinates(coordinates_vec, coordinates);
+
+    std::vector<typename TGridFrunctionType::DataType> values;
+    rDummy.GetValuesOnGrid(values, coordinates_vec);
+
+    Matrix values_mat;
+    GridFunction_CopyToMatrix(values_mat, values);
+    return values_mat;
+}
+
+/// Values and derivatives at the points given by the rows of a matrix. The values are returned as a matrix with one row
+/// per point, the derivatives as a matrix with row q*TDim + dim for the derivative w.r.t xi_dim at the point q.
+template<class TGridFrunctionType>
+boost::python::tuple GridFunction_GetValuesAndDerivatives(TGridFrunctionType& rDummy, const Matrix& points)
+{
+    std::vector<array_1d<double, 3> > points_vec;
+    GridFunction_ExtractPoints<TGridFrunctionType>(points_vec, points);
+
+    std::vector<typename TGridFrunctionType::DataType> values, derivatives;
+    rDummy.GetValuesAndDerivatives(values, derivatives, points_vec);
+
+    Matrix values_mat, derivatives_mat;
+    GridFunction_CopyToMatrix(values_mat, values);
+    GridFunction_CopyToMatrix(derivatives_mat, derivatives);
+
+    return boost::python::make_tuple(values_mat, derivatives_mat);
+}
+
+/// Values and derivatives at the points of the tensor grid given by a list of coordinate vectors, one per direction.
+/// The results are arranged as in GridFunction_GetValuesAndDerivatives.
+template<class TGridFrunctionType>
+boost::python::tuple GridFunction_GetValuesAndDerivativesOnGrid(TGridFrunctionType& rDummy, const boost::python::list& coordinates)
+{
+    std::vector<std::vector<double> > coordinates_vec;
+    GridFunction_ExtractCoordinates(coordinates_vec, coordinates);
+
+    std::vector<typename TGridFrunctionType::DataType> values, derivatives;
+    rDummy.GetValuesAndDerivativesOnGrid(values, derivatives, coordinates_vec);
+
+    Matrix values_mat, derivatives_mat;
+    GridFunction_CopyToMatrix(values_mat, values);
+    GridFunction_CopyToMatrix(derivatives_mat, derivatives);
+
+    return boost::python::make_tuple(values_mat, derivatives_mat);
+}
+
 ///////////////////////////////////////////////////////
 
 template<int TDim>
@@ -111,6 +251,10 @@ void IsogeometricApplication_AddGridFunctionsToPython()
     .add_property("ControlGrid", GridFunction_GetControlGrid<ControlPointGridFunctionType>, GridFunction_SetControlGrid<ControlPointGridFunctionType>)
     .def("GetValue", &GridFunction_GetValue<ControlPointGridFunctionType>)
     .def("GetDerivative", &GridFunction_GetDerivative<ControlPointGridFunctionType>)
+    .def("GetValues", &GridFunction_GetValues<ControlPointGridFunctionType>)
+    .def("GetValuesOnGrid", &GridFunction_GetValuesOnGrid<ControlPointGridFunctionType>)
+    .def("GetValuesAndDerivatives", &GridFunction_GetValuesAndDerivatives<ControlPointGridFunctionType>)
+    .def("GetValuesAndDerivativesOnGrid", &GridFunction_GetValuesAndDerivativesOnGrid<ControlPointGridFunctionType>)
     .def(self_ns::str(self))
     ;
 
@@ -123,6 +267,10 @@ void IsogeometricApplication_AddGridFunctionsToPython()
     .add_property("ControlGrid", GridFunction_GetControlGrid<DoubleGridFunctionType>, GridFunction_SetControlGrid<DoubleGridFunctionType>)
     .def("GetValue", &GridFunction_GetValue<DoubleGridFunctionType>)
     .def("GetDerivative", &GridFunction_GetDerivative<DoubleGridFunctionType>)
+    .def("GetValues", &GridFunction_GetValues<DoubleGridFunctionType>)
+    .def("GetValuesOnGrid", &GridFunction_GetValuesOnGrid<DoubleGridFunctionType>)
+    .def("GetValuesAndDerivatives", &GridFunction_GetValuesAndDerivatives<DoubleGridFunctionType>)
+    .def("GetValuesAndDerivativesOnGrid", &GridFunction_GetValuesAndDerivativesOnGrid<DoubleGridFunctionType>)
     .def(self_ns::str(self))
     ;
 
@@ -135,6 +283,10 @@ void IsogeometricApplication_AddGridFunctionsToPython()
     .add_property("ControlGrid", GridFunction_GetControlGrid<Array1DGridFunctionType>, GridFunction_SetControlGrid<Array1DGridFunctionType>)
     .def("GetValue", &GridFunction_GetValue<Array1DGridFunctionType>)
     .def("GetDerivative", &GridFunction_GetDerivative<Array1DGridFunctionType>)
+    .def("GetValues", &GridFunction_GetValues<Array1DGridFunctionType>)
+    .def("GetValuesOnGrid", &GridFunction_GetValuesOnGrid<Array1DGridFunctionType>)
+    .def("GetValuesAndDerivatives", &GridFunction_GetValuesAndDerivatives<Array1DGridFunctionType>)
+    .def("GetValuesAndDerivativesOnGrid", &GridFunction_GetValuesAndDerivativesOnGrid<Array1DGridFunctionType>)
     .def(self_ns::str(self))
     ;
 
@@ -147,6 +299,10 @@ void IsogeometricApplication_AddGridFunctionsToPython()
     .add_property("ControlGrid", GridFunction_GetControlGrid<VectorGridFunctionType>, GridFunction_SetControlGrid<VectorGridFunctionType>)
     .def("GetValue", &GridFunction_GetValue<VectorGridFunctionType>)
     .def("GetDerivative", &GridFunction_GetDerivative<VectorGridFunctionType>)
+    .def("GetValues", &GridFunction_GetValues<VectorGridFunctionType>)
+    .def("GetValuesOnGrid", &GridFunction_GetValuesOnGrid<VectorGridFunctionType>)
+    .def("GetValuesAndDerivatives", &GridFunction_GetValuesAndDerivatives<VectorGridFunctionType>)
+    .def("GetValuesAndDerivativesOnGrid", &GridFunction_GetValuesAndDerivativesOnGrid<VectorGridFunctionType>)
     .def(self_ns::str(self))
     ;
 }
@@ -184,6 +184,8 @@ void IsogeometricApplication_AddHBSplinesSpaceToPython()
     .def("ConstructBoundaryFESpace", pointer_to_ConstructBoundaryFESpace1)
     // .def("ConstructBoundaryFESpace", pointer_to_ConstructBoundaryFESpace2)
     .def("UpdateCells", &HBSplinesFESpace<TDim>::UpdateCells)
+    .def("SetEvaluationMode", &HBSplinesFESpace<TDim>::SetEvaluationMode)
+    .def("EvaluationMode", &HBSplinesFESpace<TDim>::EvaluationMode)
     .def(self_ns::str(self))
     ;
 
@@ -52,12 +52,82 @@ typename T::MultiPatchType& MultiPatchModelPart_GetMultiPatch(T& rDummy)
     return *(rDummy.pMultiPatch());
 }
 
+template<class T>
+boost::python::dict MultiPatchModelPart_GetMovedEquationIds(T& rDummy)
+{
+    boost::python::dict moved_ids;
+    for (std::map<std::size_t, std::size_t>::const_iterator it = rDummy.MovedEquationIds().begin(); it != rDummy.MovedEquationIds().end(); ++it)
+        moved_ids[it->first] = it->second;
+    return moved_ids;
+}
+
 template<class T>
 typename T::MultiPatchType& MultiPatchModelPart_GetMultiPatch2(T& rDummy, const std::size_t& i)
 {
     return *(rDummy.pMultiPatch(i));
 }
 
+template<class T, class TVariableType>
+void MultiPatchModelPart_SynchronizeForward(T& rDummy, const TVariableType& rVariable)
+{
+    rDummy.SynchronizeForward(rVariable);
+}
+
+template<class T, class TVariableType>
+void MultiPatchModelPart_SynchronizeBackward(T& rDummy, const TVariableType& rVariable)
+{
+    rDummy.SynchronizeBackward(rVariable);
+}
+
+/// Sort the variables of a python list by type
+void MultiPatchModelPart_ExtractVariables(boost::python::list& variables,
+    std::vector<const Variable<double>*>& double_variables,
+    std::vector<const Variable<array_1d<double, 3> >*>& array_1d_variables,
+    std::vector<const Variable<Vector>*>& vector_variables)
+{
+    for (std::size_t i = 0; i < static_cast<std::size_t>(boost::python::len(variables)); ++i)
+    {
+        boost::python::extract<Variable<double>&> double_var(variables[i]);
+        boost::python::extract<Variable<array_1d<double, 3> >&> array_1d_var(variables[i]);
+        boost::python::extract<Variable<Vector>&> vector_var(variables[i]);
+
+        if (double_var.check())
+            double_variables.push_back(&double_var());
+        else if (array_1d_var.check())
+            array_1d_variables.push_back(&array_1d_var());
+        else if (vector_var.check())
+            vector_variables.push_back(&vector_var());
+        else
+            KRATOS_THROW_ERROR(std::logic_error, "The type of the variable is not supported for synchronization. Variable at position", i)
+    }
+}
+
+template<class T>
+void MultiPatchModelPart_SynchronizeForwardList(T& rDummy, boost::python::list variables)
+{
+    std::vector<const Variable<double>*> double_variables;
+    std::vector<const Variable<array_1d<double, 3> >*> array_1d_variables;
+    std::vector<const Variable<Vector>*> vector_variables;
+    MultiPatchModelPart_ExtractVariables(variables, double_variables, array_1d_variables, vector_variables);
+
+    if (double_variables.size() != 0) rDummy.SynchronizeForward(double_variables);
+    if (array_1d_variables.size() != 0) rDummy.SynchronizeForward(array_1d_variables);
+    if (vector_variables.size() != 0) rDummy.SynchronizeForward(vector_variables);
+}
+
+template<class T>
+void MultiPatchModelPart_SynchronizeBackwardList(T& rDummy, boost::python::list variables)
+{
+    std::vector<const Variable<double>*> double_variables;
+    std::vector<const Variable<array_1d<double, 3> >*> array_1d_variables;
+    std::vector<const Variable<Vector>*> vector_variables;
+    MultiPatchModelPart_ExtractVariables(variables, double_variables, array_1d_variables, vector_variables);
+
+    if (double_variables.size() != 0) rDummy.SynchronizeBackward(double_variables);
+    if (array_1d_variables.size() != 0) rDummy.SynchronizeBackward(array_1d_variables);
+    if (vector_variables.size() != 0) rDummy.SynchronizeBackward(vector_variables);
+}
+
 template<int TDim>
 ModelPart::ConditionsContainerType MultiPatchModelPart_AddConditions(MultiPatchModelPart<TDim>& rDummy,
     typename Patch<TDim>::Pointer pPatch,
@@ -172,14 +242,18 @@ void IsogeometricApplication_AddModelPartToPython()
     .def("AddConditions", &MultiPatchModelPart_AddConditions<TDim>)
     .def("AddConditions", &MultiPatchModelPart_AddConditions_OnBoundary<TDim>)
     .def("EndModelPart", &MultiPatchModelPartType::EndModelPart)
+    .def("UpdateModelPart", &MultiPatchModelPartType::UpdateModelPart)
+    .def("GetMovedEquationIds", &MultiPatchModelPart_GetMovedEquationIds<MultiPatchModelPartType>)
     .def("GetModelPart", &MultiPatchModelPart_GetModelPart<MultiPatchModelPartType>, return_internal_reference<>())
     .def("GetMultiPatch", &MultiPatchModelPart_GetMultiPatch<MultiPatchModelPartType>, return_internal_reference<>())
-    .def("SynchronizeForward", &MultiPatchModelPartType::template SynchronizeForward<Variable<double> >)
-    .def("SynchronizeBackward", &MultiPatchModelPartType::template SynchronizeBackward<Variable<double> >)
-    .def("SynchronizeForward", &MultiPatchModelPartType::template SynchronizeForward<Variable<array_1d<double, 3> > >)
-    .def("SynchronizeBackward", &MultiPatchModelPartType::template SynchronizeBackward<Variable<array_1d<double, 3> > >)
-    .def("SynchronizeForward", &MultiPatchModelPartType::template SynchronizeForward<Variable<Vector> >)
-    .def("SynchronizeBackward", &MultiPatchModelPartType::template SynchronizeBackward<Variable<Vector> >)
+    .def("SynchronizeForward", &MultiPatchModelPart_SynchronizeForward<MultiPatchModelPartType, Variable<double> >)
+    .def("SynchronizeBackward", &MultiPatchModelPart_SynchronizeBackward<MultiPatchModelPartType, Variable<double> >)
+    .def("SynchronizeForward", &MultiPatchModelPart_SynchronizeForward<MultiPatchModelPartType, Variable<array_1d<double, 3> > >)
+    .def("SynchronizeBackward", &MultiPatchModelPart_SynchronizeBackward<MultiPatchModelPartType, Variable<array_1d<double, 3> > >)
+    .def("SynchronizeForward", &MultiPatchModelPart_SynchronizeForward<MultiPatchModelPartType, Variable<Vector> >)
+    .def("SynchronizeBackward", &MultiPatchModelPart_SynchronizeBackward<MultiPatchModelPartType, Variable<Vector> >)
+    .def("SynchronizeForward", &MultiPatchModelPart_SynchronizeForwardList<MultiPatchModelPartType>)
+    .def("SynchronizeBackward", &MultiPatchModelPart_SynchronizeBackwardList<MultiPatchModelPartType>)
     .def(self_ns::str(self))
     ;
 
@@ -141,6 +141,16 @@ std::size_t MultiPatch_Enumerate2(MultiPatch<TDim>& rDummy, const std::size_t& s
     return system_size;
 }
 
+template<int TDim>
+boost::python::list MultiPatch_EquationPermutation(MultiPatch<TDim>& rDummy)
+{
+    boost::python::list perm;
+    const std::vector<std::size_t>& permutation = rDummy.EquationPermutation();
+    for (std::size_t i = 0; i < permutation.size(); ++i)
+        perm.append(permutation[i]);
+    return perm;
+}
+
 template<int TDim>
 typename Patch<TDim>::Pointer PatchInterface_pPatch1(PatchInterface<TDim>& rDummy)
 {
@@ -238,6 +248,8 @@ void IsogeometricApplication_AddPatchesToPython_Helper()
     .def("ResetFunctionIndices", &MultiPatch<TDim>::ResetFunctionIndices)
     .def("Enumerate", &MultiPatch_Enumerate1<TDim>)
     .def("Enumerate", &MultiPatch_Enumerate2<TDim>)
+    .def("SetEquationReordering", &MultiPatch<TDim>::SetEquationReordering)
+    .def("EquationPermutation", &MultiPatch_EquationPermutation<TDim>)
     .def("IsEnumerated", &MultiPatch<TDim>::IsEnumerated)
     .def(self_ns::str(self))
     ;
@@ -68,6 +68,8 @@ void IsogeometricApplication_AddPBBSplinesSpaceToPython()
     (ss.str().c_str(), init<>())
     .def("__getitem__", &FESpace_GetItem<PBBSplinesFESpaceType>)
     .def("UpdateCells", &PBBSplinesFESpaceType::UpdateCells)
+    .def("SetEvaluationMode", &PBBSplinesFESpaceType::SetEvaluationMode)
+    .def("EvaluationMode", &PBBSplinesFESpaceType::EvaluationMode)
     .def(self_ns::str(self))
     ;
 
@@ -86,6 +88,11 @@ void IsogeometricApplication_AddPBBSplinesToPython()
     ///////////////////////Point-based BSplines//////////////////////
     /////////////////////////////////////////////////////////////////
 
+    enum_<PointEvaluationMode>("PointEvaluationMode")
+    .value("CoxDeBoor", _EVALUATE_COX_DE_BOOR_)
+    .value("BezierExtraction", _EVALUATE_BEZIER_EXTRACTION_)
+    ;
+
     IsogeometricApplication_AddPBBSplinesSpaceToPython<1>();
     IsogeometricApplication_AddPBBSplinesSpaceToPython<2>();
     IsogeometricApplication_AddPBBSplinesSpaceToPython<3>();
@@ -73,6 +73,7 @@ BOOST_PYTHON_MODULE(KratosIsogeometricApplication)
     KRATOS_REGISTER_IN_PYTHON_3D_VARIABLE_WITH_COMPONENTS( LOCAL_COORDINATES )
     KRATOS_REGISTER_IN_PYTHON_3D_VARIABLE_WITH_COMPONENTS( CONTROL_POINT_COORDINATES )
     KRATOS_REGISTER_IN_PYTHON_VARIABLE( NUM_IGA_INTEGRATION_METHOD )
+    KRATOS_REGISTER_IN_PYTHON_VARIABLE( SHAPE_FUNCTIONS_PRECOMPUTE_POLICY )
     KRATOS_REGISTER_IN_PYTHON_VARIABLE( CONTROL_POINT )
     KRATOS_REGISTER_IN_PYTHON_VARIABLE( KNOT_LEFT )
     KRATOS_REGISTER_IN_PYTHON_VARIABLE( KNOT_RIGHT )
@@ -0,0 +1,541 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 2026-10-16 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_BEZIER_BATCH_EVALUATOR_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_BEZIER_BATCH_EVALUATOR_H_INCLUDED
+
+// System includes
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+// External includes
+
+// Project includes
+#include "includes/define.h"
+#include "includes/ublas_interface.h"
+#include "geometries/geometry_data.h"
+#include "custom_utilities/bezier_utils.h"
+#include "custom_utilities/cell.h"
+#include "custom_utilities/nurbs/bcell.h"
+
+
+namespace Kratos
+{
+///@addtogroup IsogeometricApplication
+///@{
+
+/**
+ * Retrieve the integration rule of the reference Bezier element, with the same keys as the Bezier geometries
+ */
+template<int TDim>
+struct BezierBatchIntegrationRule
+{};
+
+template<>
+struct BezierBatchIntegrationRule<1>
+{
+    static GeometryData::Pointer Get(const int& NumberOfIntegrationMethod, const std::vector<int>& Degrees)
+    {
+        BezierUtils::RegisterIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degrees[0]);
+        return BezierUtils::RetrieveIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degrees[0]);
+    }
+};
+
+template<>
+struct BezierBatchIntegrationRule<2>
+{
+    static GeometryData::Pointer Get(const int& NumberOfIntegrationMethod, const std::vector<int>& Degrees)
+    {
+        BezierUtils::RegisterIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degrees[0], Degrees[1]);
+        return BezierUtils::RetrieveIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, Degrees[0], Degrees[1]);
+    }
+};
+
+template<>
+struct BezierBatchIntegrationRule<3>
+{
+    static GeometryData::Pointer Get(const int& NumberOfIntegrationMethod, const std::vector<int>& Degrees)
+    {
+        BezierUtils::RegisterIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, Degrees[0], Degrees[1], Degrees[2]);
+        return BezierUtils::RetrieveIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, Degrees[0], Degrees[1], Degrees[2]);
+    }
+};
+
+/**
+ * Evaluation of the rational Bezier geometry data of a block of elements sharing the same degrees and integration rule.
+ * The elements are added from the cells of BCellManager, whose extraction operator is read from the rows shared in the
+ * arena or from the shared 1D factors of the tensor-product cell, without forming the dense operator of the cell. An
+ * element can also be added with a (shared) extraction operator matrix. Evaluate() then fills structure-of-arrays buffers
+ * with the element index running fastest:
+ *  + N(q, i, e):         shape function values,                  index (q*n + i)*E + e
+ *  + DN(q, i, d, e):     shape function local gradients,         index ((q*n + i)*TDim + d)*E + e
+ *  + J(q, a, d, e):      Jacobian dx_a/dxi_d,                    index ((q*TDim + a)*TDim + d)*E + e
+ *  + DetJ(q, e):         determinant of the Jacobian,            index q*E + e
+ *  + InvJ(q, d, a, e):   inverse of the Jacobian dxi_d/dx_a,     index ((q*TDim + d)*TDim + a)*E + e
+ * where q is the integration point, i the node, d the local direction, a the global direction, n the number of nodes and
+ * E the number of elements. The innermost loops run over the elements, so that they vectorize.
+ * Elements with less nodes than NumberOfNodes are padded with zero rows, i.e. the values at the padded nodes are zero.
+ * The evaluator is not thread-safe; one evaluator per thread shall be used.
+ */
+template<int TDim>
+class BezierBatchEvaluator
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(BezierBatchEvaluator);
+
+    /// Type definitions
+    typedef GeometryData::IntegrationMethod IntegrationMethod;
+    typedef GeometryData::IntegrationPointsArrayType IntegrationPointsArrayType;
+    typedef std::vector<double> BufferType;
+
+    /// Constructor
+    BezierBatchEvaluator(const std::vector<int>& Degrees, const int& NumberOfIntegrationMethod,
+            const IntegrationMethod& ThisMethod, const std::size_t& NumberOfNodes)
+    : mDegrees(Degrees), mThisMethod(ThisMethod), mNumberOfNodes(NumberOfNodes), mNumberOfElements(0)
+    {
+        if(mDegrees.size() != TDim)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of degrees must be equal to the dimension", TDim)
+
+        mpIntegrationRule = BezierBatchIntegrationRule<TDim>::Get(NumberOfIntegrationMethod, mDegrees);
+        if(mpIntegrationRule == NULL)
+            KRATOS_THROW_ERROR(std::logic_error, "The integration rule could not be retrieved", "")
+
+        mNumberOfBezierFunctions = 1;
+        for(int d = 0; d < TDim; ++d)
+            mNumberOfBezierFunctions *= mDegrees[d] + 1;
+
+        // copy the Bernstein tables of the reference element in flat arrays; the local gradients are stored TDim x nb by BezierUtils
+        const Matrix& B = mpIntegrationRule->ShapeFunctionsValues(mThisMethod);
+        const GeometryData::ShapeFunctionsGradientsType& D = mpIntegrationRule->ShapeFunctionsLocalGradients(mThisMethod);
+        const std::size_t nq = B.size1();
+        const std::size_t nb = mNumberOfBezierFunctions;
+        mB.resize(nq * nb);
+        mD.resize(nq * nb * TDim);
+        for(std::size_t q = 0; q < nq; ++q)
+        {
+            for(std::size_t k = 0; k < nb; ++k)
+            {
+                mB[q*nb + k] = B(q, k);
+                for(int d = 0; d < TDim; ++d)
+                    mD[(q*nb + k)*TDim + d] = D[q](d, k);
+            }
+        }
+    }
+
+    /// Destructor
+    virtual ~BezierBatchEvaluator() {}
+
+    /// Remove all the elements
+    void Clear()
+    {
+        mNumberOfElements = 0;
+        mC.clear();
+        mW.clear();
+        mX.clear();
+    }
+
+    /**
+     * Add an element to the block. Return the index of the element in the block.
+     * @param rExtractionOperator extraction operator, each row for each node, e.g. the one shared by MultiPatchModelPart::GetExtractionOperators
+     * @param rWeights weights of the control points
+     * @param rCoordinates coordinates of the control points, each row for each node; only the first TDim columns are used
+     */
+    std::size_t AddElement(const Matrix& rExtractionOperator, const Vector& rWeights, const Matrix& rCoordinates)
+    {
+        const std::size_t n = rExtractionOperator.size1();
+        const std::size_t nb = mNumberOfBezierFunctions;
+        if(rExtractionOperator.size2() != nb)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of columns of the extraction operator is not equal to the number of Bezier functions:", rExtractionOperator.size2())
+        if(rWeights.size() != n || rCoordinates.size1() != n || rCoordinates.size2() < TDim)
+            KRATOS_THROW_ERROR(std::logic_error, "The size of the weights/coordinates is not compatible with the extraction operator", "")
+
+        const std::size_t e = this->AppendElement(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            double* pC = &mC[(e*mNumberOfNodes + i)*nb];
+            for(std::size_t k = 0; k < nb; ++k)
+                pC[k] = rExtractionOperator(i, k);
+            mW[e*mNumberOfNodes + i] = rWeights(i);
+            for(int a = 0; a < TDim; ++a)
+                mX[(e*mNumberOfNodes + i)*TDim + a] = rCoordinates(i, a);
+        }
+
+        return e;
+    }
+
+    /**
+     * Add an element from a cell of BCellManager. Return the index of the element in the block.
+     * @param rCoordinates coordinates of the supported anchors of the cell, each row for each anchor; only the first TDim columns are used
+     */
+    std::size_t AddCell(const Cell& rCell, const Matrix& rCoordinates)
+    {
+        const std::size_t n = rCell.NumberOfAnchors();
+        if(rCoordinates.size1() != n || rCoordinates.size2() < TDim)
+            KRATOS_THROW_ERROR(std::logic_error, "The size of the coordinates is not compatible with the cell", rCell.Id())
+
+        const std::size_t e = this->AddCellOperator(rCell);
+        for(std::size_t i = 0; i < n; ++i)
+            for(int a = 0; a < TDim; ++a)
+                mX[(e*mNumberOfNodes + i)*TDim + a] = rCoordinates(i, a);
+
+        return e;
+    }
+
+    /**
+     * Add a block of cells, e.g. all the cells of a BCellManager sharing the degrees. TIteratorType dereferences to a pointer to the cell.
+     * @param rControlPoints coordinates of the control points, row Id for the anchor Id; only the first TDim columns are used
+     */
+    template<class TIteratorType>
+    void AddCells(TIteratorType it_begin, TIteratorType it_end, const Matrix& rControlPoints)
+    {
+        if(rControlPoints.size2() < TDim)
+            KRATOS_THROW_ERROR(std::logic_error, "The control points must have at least the coordinates on the dimension", TDim)
+
+        for(TIteratorType it = it_begin; it != it_end; ++it)
+        {
+            const std::size_t e = this->AddCellOperator(**it);
+            const std::vector<std::size_t>& anchors = (*it)->GetSupportedAnchors();
+            for(std::size_t i = 0; i < anchors.size(); ++i)
+            {
+                if(anchors[i] >= rControlPoints.size1())
+                    KRATOS_THROW_ERROR(std::logic_error, "There is no control point for anchor", anchors[i])
+                for(int a = 0; a < TDim; ++a)
+                    mX[(e*mNumberOfNodes + i)*TDim + a] = rControlPoints(anchors[i], a);
+            }
+        }
+    }
+
+    /// Compute the geometry data of all the elements at all the integration points
+    void Evaluate()
+    {
+        const std::size_t E = mNumberOfElements;
+        const std::size_t n = mNumberOfNodes;
+        const std::size_t nb = mNumberOfBezierFunctions;
+        const std::size_t nq = NumberOfIntegrationPoints();
+        std::size_t e, i, k, q;
+        int a, d;
+
+        // transpose the element data to structure-of-arrays
+        BufferType C(n * nb * E), w(n * E), X(n * TDim * E);
+        for(e = 0; e < E; ++e)
+        {
+            for(i = 0; i < n; ++i)
+            {
+                for(k = 0; k < nb; ++k)
+                    C[(i*nb + k)*E + e] = mC[(e*n + i)*nb + k];
+                w[i*E + e] = mW[e*n + i];
+                for(a = 0; a < TDim; ++a)
+                    X[(i*TDim + a)*E + e] = mX[(e*n + i)*TDim + a];
+            }
+        }
+
+        // weights of the Bezier control points, wb = trans(C) * w
+        BufferType wb(nb * E, 0.0);
+        for(i = 0; i < n; ++i)
+            for(k = 0; k < nb; ++k)
+            {
+                const double* pC = &C[(i*nb + k)*E];
+                const double* pw = &w[i*E];
+                double* pwb = &wb[k*E];
+                for(e = 0; e < E; ++e)
+                    pwb[e] += pC[e] * pw[e];
+            }
+
+        mN.resize(nq * n * E);
+        mDN.resize(nq * n * TDim * E);
+        mJ.assign(nq * TDim * TDim * E, 0.0);
+        mDetJ.resize(nq * E);
+        mInvJ.resize(nq * TDim * TDim * E);
+
+        BufferType W(E), dW(TDim * E), v(E), dv(TDim * E);
+        for(q = 0; q < nq; ++q)
+        {
+            const double* Bq = &mB[q*nb];
+            const double* Dq = &mD[q*nb*TDim];
+
+            // denominator and its derivatives
+            std::fill(W.begin(), W.end(), 0.0);
+            std::fill(dW.begin(), dW.end(), 0.0);
+            for(k = 0; k < nb; ++k)
+            {
+                const double* pwb = &wb[k*E];
+                for(e = 0; e < E; ++e)
+                    W[e] += Bq[k] * pwb[e];
+                for(d = 0; d < TDim; ++d)
+                {
+                    double* pdW = &dW[d*E];
+                    for(e = 0; e < E; ++e)
+                        pdW[e] += Dq[k*TDim + d] * pwb[e];
+                }
+            }
+
+            for(i = 0; i < n; ++i)
+            {
+                // polynomial part C * B and its derivatives
+                std::fill(v.begin(), v.end(), 0.0);
+                std::fill(dv.begin(), dv.end(), 0.0);
+                for(k = 0; k < nb; ++k)
+                {
+                    const double* pC = &C[(i*nb + k)*E];
+                    for(e = 0; e < E; ++e)
+                        v[e] += pC[e] * Bq[k];
+                    for(d = 0; d < TDim; ++d)
+                    {
+                        double* pdv = &dv[d*E];
+                        for(e = 0; e < E; ++e)
+                            pdv[e] += pC[e] * Dq[k*TDim + d];
+                    }
+                }
+
+                // rational shape functions
+                const double* pw = &w[i*E];
+                double* pN = &mN[(q*n + i)*E];
+                for(e = 0; e < E; ++e)
+                    pN[e] = pw[e] * v[e] / W[e];
+                for(d = 0; d < TDim; ++d)
+                {
+                    double* pDN = &mDN[((q*n + i)*TDim + d)*E];
+                    const double* pdv = &dv[d*E];
+                    const double* pdW = &dW[d*E];
+                    for(e = 0; e < E; ++e)
+                        pDN[e] = pw[e] * (pdv[e] - v[e] * pdW[e] / W[e]) / W[e];
+                }
+
+                // contribution to the Jacobian
+                for(a = 0; a < TDim; ++a)
+                {
+                    const double* pX = &X[(i*TDim + a)*E];
+                    for(d = 0; d < TDim; ++d)
+                    {
+                        double* pJ = &mJ[((q*TDim + a)*TDim + d)*E];
+                        const double* pDN = &mDN[((q*n + i)*TDim + d)*E];
+                        for(e = 0; e < E; ++e)
+                            pJ[e] += pX[e] * pDN[e];
+                    }
+                }
+            }
+
+            // determinant and inverse of the Jacobian
+            const double* pJ = &mJ[q*TDim*TDim*E];
+            double* pDetJ = &mDetJ[q*E];
+            double* pInvJ = &mInvJ[q*TDim*TDim*E];
+            ComputeDeterminantAndInverse(pDetJ, pInvJ, pJ, E);
+        }
+    }
+
+    /// Access
+    std::size_t NumberOfElements() const {return mNumberOfElements;}
+    std::size_t NumberOfNodes() const {return mNumberOfNodes;}
+    std::size_t NumberOfBezierFunctions() const {return mNumberOfBezierFunctions;}
+    std::size_t NumberOfIntegrationPoints() const {return mB.size() / mNumberOfBezierFunctions;}
+    const IntegrationPointsArrayType& IntegrationPoints() const {return mpIntegrationRule->IntegrationPoints(mThisMethod);}
+
+    const BufferType& ShapeFunctionsValues() const {return mN;}
+    const BufferType& ShapeFunctionsLocalGradients() const {return mDN;}
+    const BufferType& Jacobians() const {return mJ;}
+    const BufferType& DeterminantsOfJacobian() const {return mDetJ;}
+    const BufferType& InversesOfJacobian() const {return mInvJ;}
+
+    double N(const std::size_t& q, const std::size_t& i, const std::size_t& e) const
+    {
+        return mN[(q*mNumberOfNodes + i)*mNumberOfElements + e];
+    }
+
+    double DN(const std::size_t& q, const std::size_t& i, const int& d, const std::size_t& e) const
+    {
+        return mDN[((q*mNumberOfNodes + i)*TDim + d)*mNumberOfElements + e];
+    }
+
+    double J(const std::size_t& q, const int& a, const int& d, const std::size_t& e) const
+    {
+        return mJ[((q*TDim + a)*TDim + d)*mNumberOfElements + e];
+    }
+
+    double DetJ(const std::size_t& q, const std::size_t& e) const
+    {
+        return mDetJ[q*mNumberOfElements + e];
+    }
+
+    double InvJ(const std::size_t& q, const int& d, const int& a, const std::size_t& e) const
+    {
+        return mInvJ[((q*TDim + d)*TDim + a)*mNumberOfElements + e];
+    }
+
+    /// Information
+    virtual void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "BezierBatchEvaluator<" << TDim << ">: " << mNumberOfElements << " elements, "
+                 << mNumberOfNodes << " nodes, " << NumberOfIntegrationPoints() << " integration points";
+    }
+
+private:
+
+    std::vector<int> mDegrees;
+    IntegrationMethod mThisMethod;
+    GeometryData::Pointer mpIntegrationRule;
+    std::size_t mNumberOfNodes;
+    std::size_t mNumberOfBezierFunctions;
+    std::size_t mNumberOfElements;
+
+    BufferType mB; // Bernstein values, index q*nb + k
+    BufferType mD; // Bernstein local gradients, index (q*nb + k)*TDim + d
+
+    BufferType mC; // extraction operators, element by element, index (e*n + i)*nb + k
+    BufferType mW; // control weights, element by element, index e*n + i
+    BufferType mX; // control point coordinates, element by element, index (e*n + i)*TDim + a
+
+    BufferType mN, mDN, mJ, mDetJ, mInvJ;
+
+    /// Append a zero element of n nodes to the element data. Return the index of the element.
+    std::size_t AppendElement(const std::size_t& n)
+    {
+        if(n > mNumberOfNodes)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of nodes exceeds the one of the block:", n)
+
+        mC.resize(mC.size() + mNumberOfNodes * mNumberOfBezierFunctions, 0.0);
+        mW.resize(mW.size() + mNumberOfNodes, 0.0);
+        mX.resize(mX.size() + mNumberOfNodes * TDim, 0.0);
+        return mNumberOfElements++;
+    }
+
+    /// Append the extraction operator and the weights of a cell to the element data. Return the index of the element.
+    /// The rows are copied from the arena, or from the Kronecker product of the 1D factors for the tensor-product cell.
+    std::size_t AddCellOperator(const Cell& rCell)
+    {
+        const std::size_t n = rCell.NumberOfAnchors();
+        const std::size_t nb = mNumberOfBezierFunctions;
+        const std::size_t e = this->AppendElement(n);
+
+        const std::vector<double>& weights = rCell.GetAnchorWeights();
+        std::copy(weights.begin(), weights.end(), mW.begin() + e*mNumberOfNodes);
+
+        if(rCell.HasCrowsInArena())
+        {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                Cell::RowViewType Crow = rCell.GetCrowView(i);
+                if(Crow.Size != nb)
+                    KRATOS_THROW_ERROR(std::logic_error, "The length of the extraction operator row is not equal to the number of Bezier functions:", Crow.Size)
+                double* pC = &mC[(e*mNumberOfNodes + i)*nb];
+                for(std::size_t k = 0; k < Crow.NumberOfNonzeros; ++k)
+                    pC[Crow.Indices[k]] = Crow.Values[k];
+            }
+        }
+        else
+        {
+            const std::vector<Cell::ExtractionOperatorPointerType>& factors
+                = dynamic_cast<const BCell&>(rCell).GetExtractionOperatorFactors();
+            if(factors.size() != TDim)
+                KRATOS_THROW_ERROR(std::logic_error, "The number of extraction operator factors is not equal to the dimension:", factors.size())
+            for(int dim = 0; dim < TDim; ++dim)
+                if(factors[dim]->size2() != static_cast<std::size_t>(mDegrees[dim] + 1))
+                    KRATOS_THROW_ERROR(std::logic_error, "The extraction operator factor is not compatible with the degree on direction", dim)
+
+            // row i of C1 x C2 (x C3), with the first direction varying slowest for both the rows and the columns
+            std::size_t u[TDim], b[TDim];
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                std::size_t tmp = i;
+                for(int dim = TDim-1; dim >= 0; --dim)
+                {
+                    u[dim] = tmp % factors[dim]->size1();
+                    tmp /= factors[dim]->size1();
+                }
+
+                double* pC = &mC[(e*mNumberOfNodes + i)*nb];
+                for(std::size_t k = 0; k < nb; ++k)
+                {
+                    tmp = k;
+                    for(int dim = TDim-1; dim >= 0; --dim)
+                    {
+                        b[dim] = tmp % (mDegrees[dim] + 1);
+                        tmp /= mDegrees[dim] + 1;
+                    }
+
+                    double v = 1.0;
+                    for(int dim = 0; dim < TDim; ++dim)
+                        v *= (*factors[dim])(u[dim], b[dim]);
+                    pC[k] = v;
+                }
+            }
+        }
+
+        return e;
+    }
+
+    /// compute the determinant and the inverse of E Jacobian matrices stored as structure-of-arrays
+    static void ComputeDeterminantAndInverse(double* pDetJ, double* pInvJ, const double* pJ, const std::size_t& E);
+};
+
+template<>
+inline void BezierBatchEvaluator<1>::ComputeDeterminantAndInverse(double* pDetJ, double* pInvJ, const double* pJ, const std::size_t& E)
+{
+    for(std::size_t e = 0; e < E; ++e)
+    {
+        pDetJ[e] = pJ[e];
+        pInvJ[e] = 1.0 / pJ[e];
+    }
+}
+
+template<>
+inline void BezierBatchEvaluator<2>::ComputeDeterminantAndInverse(double* pDetJ, double* pInvJ, const double* pJ, const std::size_t& E)
+{
+    const double *J00 = pJ, *J01 = pJ + E, *J10 = pJ + 2*E, *J11 = pJ + 3*E;
+    for(std::size_t e = 0; e < E; ++e)
+    {
+        const double det = J00[e] * J11[e] - J01[e] * J10[e];
+        pDetJ[e] = det;
+        pInvJ[e]       =  J11[e] / det;
+        pInvJ[E + e]   = -J01[e] / det;
+        pInvJ[2*E + e] = -J10[e] / det;
+        pInvJ[3*E + e] =  J00[e] / det;
+    }
+}
+
+template<>
+inline void BezierBatchEvaluator<3>::ComputeDeterminantAndInverse(double* pDetJ, double* pInvJ, const double* pJ, const std::size_t& E)
+{
+    const double *J00 = pJ,       *J01 = pJ + E,   *J02 = pJ + 2*E;
+    const double *J10 = pJ + 3*E, *J11 = pJ + 4*E, *J12 = pJ + 5*E;
+    const double *J20 = pJ + 6*E, *J21 = pJ + 7*E, *J22 = pJ + 8*E;
+    for(std::size_t e = 0; e < E; ++e)
+    {
+        const double c00 = J11[e] * J22[e] - J12[e] * J21[e];
+        const double c01 = J12[e] * J20[e] - J10[e] * J22[e];
+        const double c02 = J10[e] * J21[e] - J11[e] * J20[e];
+        const double det = J00[e] * c00 + J01[e] * c01 + J02[e] * c02;
+        pDetJ[e] = det;
+        pInvJ[e]       = c00 / det;
+        pInvJ[E + e]   = (J02[e] * J21[e] - J01[e] * J22[e]) / det;
+        pInvJ[2*E + e] = (J01[e] * J12[e] - J02[e] * J11[e]) / det;
+        pInvJ[3*E + e] = c01 / det;
+        pInvJ[4*E + e] = (J00[e] * J22[e] - J02[e] * J20[e]) / det;
+        pInvJ[5*E + e] = (J02[e] * J10[e] - J00[e] * J12[e]) / det;
+        pInvJ[6*E + e] = c02 / det;
+        pInvJ[7*E + e] = (J01[e] * J20[e] - J00[e] * J21[e]) / det;
+        pInvJ[8*E + e] = (J00[e] * J11[e] - J01[e] * J10[e]) / det;
+    }
+}
+
+/// output stream function
+template<int TDim>
+inline std::ostream& operator <<(std::ostream& rOStream, const BezierBatchEvaluator<TDim>& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+///@}
+
+///@} addtogroup block
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_BEZIER_BATCH_EVALUATOR_H_INCLUDED
@@ -0,0 +1,353 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 2026-10-16 $
+//   Revision:            $Revision: 1.1 $
+//
+//
+
+#if !defined(KRATOS_BEZIER_KERNELS_H_INCLUDED )
+#define  KRATOS_BEZIER_KERNELS_H_INCLUDED
+
+// System includes
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+// External includes
+
+// Project includes
+#include "includes/define.h"
+
+namespace Kratos
+{
+///@addtogroup IsogeometricApplication
+///@{
+
+///@name Kratos Classes
+///@{
+
+/**
+ * Univariate Bernstein polynomials of fixed degree. The values are computed by the triangular (de Casteljau) scheme
+ * on stack arrays; since the loop bounds are known at compile time, the compiler fully unrolls them.
+ */
+template<int TDegree>
+struct BernsteinKernel
+{
+    static const int Number = TDegree + 1;
+
+    /// compute the values B[0..TDegree] and derivatives D[0..TDegree] at x in [0, 1]
+    static inline void Evaluate(double* B, double* D, const double& x)
+    {
+        const double y = 1.0 - x;
+
+        // Bernstein polynomials of degree TDegree - 1
+        double b[TDegree + 1];
+        b[0] = 1.0;
+        for(int k = 1; k < TDegree; ++k)
+        {
+            b[k] = x * b[k - 1];
+            for(int i = k - 1; i > 0; --i)
+                b[i] = x * b[i - 1] + y * b[i];
+            b[0] = y * b[0];
+        }
+
+        // derivatives
+        D[0] = -TDegree * b[0];
+        for(int i = 1; i < TDegree; ++i)
+            D[i] = TDegree * (b[i - 1] - b[i]);
+        D[TDegree] = TDegree * b[TDegree - 1];
+
+        // values
+        B[TDegree] = x * b[TDegree - 1];
+        for(int i = TDegree - 1; i > 0; --i)
+            B[i] = x * b[i - 1] + y * b[i];
+        B[0] = y * b[0];
+    }
+};
+
+/**
+ * Univariate Bernstein polynomials of runtime degree p <= MaxDegree and their derivatives up to order k.
+ * The values are computed by the triangular (de Casteljau) recurrence B_i^q = (1-x) B_i^{q-1} + x B_{i-1}^{q-1},
+ * and the derivatives from the levels p-j of the triangle:
+ *      d^j B_i^p / dx^j = p!/(p-j)! * sum_{m=0}^{j} (-1)^{j-m} C(j, m) B_{i-m}^{p-j}
+ * with the binomial coefficients C(j, m) taken from a precomputed table. The batch version evaluates a set of
+ * abscissae at once with the abscissa index running fastest, so that the inner loops vectorize.
+ */
+struct BernsteinBasis
+{
+    static const int MaxDegree = 32;
+
+    /// binomial coefficient C(n, k), taken from the table for n <= MaxDegree and computed by the product formula otherwise
+    static inline double Binomial(const int& n, const int& k)
+    {
+        if(k < 0 || k > n)
+            return 0.0;
+        if(n <= MaxDegree)
+            return GetBinomialTable().Coefficients[n][k];
+
+        const int m = std::min(k, n - k);
+        double c = 1.0;
+        for(int j = 1; j <= m; ++j)
+            c = c * (n - m + j) / j;
+        return c;
+    }
+
+    /// compute the values B[0..p] at x in [0, 1]
+    template<class TValuesContainerType>
+    static inline void Values(TValuesContainerType& rS, const int& p, const double& x)
+    {
+        const double y = 1.0 - x;
+        rS[0] = 1.0;
+        for(int q = 1; q <= p; ++q)
+        {
+            rS[q] = x * rS[q - 1];
+            for(int i = q - 1; i > 0; --i)
+                rS[i] = x * rS[i - 1] + y * rS[i];
+            rS[0] = y * rS[0];
+        }
+    }
+
+    /**
+     * compute the derivatives of order 0..k at x in [0, 1]
+     * @param pDers output, index j*(p+1) + i for the j-th derivative of B_i^p; the derivatives of order > p are zero
+     */
+    static inline void Derivatives(double* pDers, const int& p, const int& k, const double& x)
+    {
+        double Work[(MaxDegree + 1) * (MaxDegree + 2)];
+        CheckDegree(p, k);
+        Compute(pDers, Work, p, k, &x, 1);
+    }
+
+    /**
+     * compute the derivatives of order 0..k at the abscissae pX[0..nx-1]
+     * @param pDers output, index (j*(p+1) + i)*nx + t for the j-th derivative of B_i^p at pX[t]
+     */
+    static inline void Derivatives(double* pDers, const int& p, const int& k, const double* pX, const std::size_t& nx)
+    {
+        CheckDegree(p, k);
+        std::vector<double> Work((std::min(k, p) + 2) * (p + 1) * nx);
+        Compute(pDers, &Work[0], p, k, pX, nx);
+    }
+
+private:
+
+    struct BinomialTableType
+    {
+        BinomialTableType()
+        {
+            for(int n = 0; n <= MaxDegree; ++n)
+            {
+                Coefficients[n][0] = 1.0;
+                Coefficients[n][n] = 1.0;
+                for(int k = 1; k < n; ++k)
+                    Coefficients[n][k] = Coefficients[n - 1][k - 1] + Coefficients[n - 1][k];
+            }
+        }
+        double Coefficients[MaxDegree + 1][MaxDegree + 1];
+    };
+
+    static const BinomialTableType& GetBinomialTable()
+    {
+        static const BinomialTableType table;
+        return table;
+    }
+
+    static inline void CheckDegree(const int& p, const int& k)
+    {
+        if(p < 0 || p > MaxDegree)
+            KRATOS_THROW_ERROR(std::logic_error, "The Bernstein degree is not supported:", p)
+        if(k < 0)
+            KRATOS_THROW_ERROR(std::logic_error, "The derivative order must be non-negative:", k)
+    }
+
+    /// pWork must hold (min(k, p) + 2) * (p + 1) * nx values
+    static void Compute(double* pDers, double* pWork, const int& p, const int& k, const double* pX, const std::size_t& nx)
+    {
+        const int n = p + 1;
+        const int kk = std::min(k, p);
+        double* b = pWork;              // current level of the triangle, index i*nx + t
+        double* pLevels = pWork + n*nx; // levels p-j, j = 0..kk, index (j*n + i)*nx + t
+        std::size_t t;
+
+        for(t = 0; t < nx; ++t)
+            b[t] = 1.0;
+        for(int q = 0; q <= p; ++q)
+        {
+            if(q > 0)
+            {
+                double* bq = b + q*nx;
+                const double* bq1 = b + (q - 1)*nx;
+                for(t = 0; t < nx; ++t)
+                    bq[t] = pX[t] * bq1[t];
+                for(int i = q - 1; i > 0; --i)
+                {
+                    double* bi = b + i*nx;
+                    const double* bi1 = b + (i - 1)*nx;
+                    for(t = 0; t < nx; ++t)
+                        bi[t] = pX[t] * bi1[t] + (1.0 - pX[t]) * bi[t];
+                }
+                for(t = 0; t < nx; ++t)
+                    b[t] = (1.0 - pX[t]) * b[t];
+            }
+
+            const int j = p - q;
+            if(j <= kk)
+                std::copy(b, b + (q + 1)*nx, pLevels + j*n*nx);
+        }
+
+        // combine the levels
+        const BinomialTableType& rTable = GetBinomialTable();
+        double factor = 1.0;
+        for(int j = 0; j <= kk; ++j)
+        {
+            if(j > 0)
+                factor *= (p - j + 1);
+            const double* pLevel = pLevels + j*n*nx; // B^{p-j}_{0..p-j}
+            for(int i = 0; i < n; ++i)
+            {
+                double* d = pDers + (j*n + i)*nx;
+                for(t = 0; t < nx; ++t)
+                    d[t] = 0.0;
+                for(int m = std::max(0, i - (p - j)); m <= std::min(j, i); ++m)
+                {
+                    const double c = (((j - m) % 2) ? -factor : factor) * rTable.Coefficients[j][m];
+                    const double* bl = pLevel + (i - m)*nx;
+                    for(t = 0; t < nx; ++t)
+                        d[t] += c * bl[t];
+                }
+            }
+        }
+
+        for(int j = kk + 1; j <= k; ++j)
+            std::fill(pDers + j*n*nx, pDers + (j + 1)*n*nx, 0.0);
+    }
+};
+
+/**
+ * Rational Bezier shape functions of a 2D Bezier element with fixed degrees. The bivariate Bernstein values, the
+ * denominator and the extraction are computed on stack arrays, without any ublas temporaries.
+ */
+template<int TDegree1, int TDegree2>
+struct BezierKernel2D
+{
+    static const int NumberOfBezierFunctions = (TDegree1 + 1) * (TDegree2 + 1);
+
+    /**
+     * Compute the shape function values and local gradients at (xi1, xi2)
+     * @param pValues output values, must hold rExtractionOperator.size1() entries
+     * @param rExtractionOperator extraction operator, each row for each node
+     * @param rWeights weights of the control points
+     * @param rBezierWeights weights of the Bezier control points, i.e. trans(rExtractionOperator) * rWeights
+     */
+    template<class TVectorType, class TMatrixType, class TValuesContainerType>
+    static void ComputeShapeFunctionsValuesAndLocalGradients(
+        double* pValues,
+        TMatrixType& rLocalGradients,
+        const TMatrixType& rExtractionOperator,
+        const TValuesContainerType& rWeights,
+        const TVectorType& rBezierWeights,
+        const double& xi1,
+        const double& xi2
+    )
+    {
+        double B1[TDegree1 + 1], D1[TDegree1 + 1];
+        double B2[TDegree2 + 1], D2[TDegree2 + 1];
+        BernsteinKernel<TDegree1>::Evaluate(B1, D1, xi1);
+        BernsteinKernel<TDegree2>::Evaluate(B2, D2, xi2);
+
+        //compute bivariate Bezier shape functions values & derivatives, and the denominator
+        double B[NumberOfBezierFunctions], dB1[NumberOfBezierFunctions], dB2[NumberOfBezierFunctions];
+        double W = 0.0, dW1 = 0.0, dW2 = 0.0;
+        int index;
+        for(int i = 0; i < TDegree1 + 1; ++i)
+        {
+            for(int j = 0; j < TDegree2 + 1; ++j)
+            {
+                index = j + i * (TDegree2 + 1);
+                B[index] = B1[i] * B2[j];
+                dB1[index] = D1[i] * B2[j];
+                dB2[index] = B1[i] * D2[j];
+                W += rBezierWeights(index) * B[index];
+                dW1 += rBezierWeights(index) * dB1[index];
+                dW2 += rBezierWeights(index) * dB2[index];
+            }
+        }
+
+        //compute the shape function values and local gradients
+        const std::size_t NumberOfNodes = rExtractionOperator.size1();
+        if(rLocalGradients.size1() != NumberOfNodes || rLocalGradients.size2() != 2)
+            rLocalGradients.resize(NumberOfNodes, 2, false);
+
+        double v, d1, d2, c, aux;
+        for(std::size_t r = 0; r < NumberOfNodes; ++r)
+        {
+            v = 0.0; d1 = 0.0; d2 = 0.0;
+            for(int k = 0; k < NumberOfBezierFunctions; ++k)
+            {
+                c = rExtractionOperator(r, k);
+                v += c * B[k];
+                d1 += c * dB1[k];
+                d2 += c * dB2[k];
+            }
+
+            aux = rWeights(r) / W;
+            pValues[r] = aux * v;
+            rLocalGradients(r, 0) = aux * (d1 - v * dW1 / W);
+            rLocalGradients(r, 1) = aux * (d2 - v * dW2 / W);
+        }
+    }
+};
+
+/**
+ * Runtime selection of the fixed-degree kernels. Degrees 1 to MaxDegree in each direction are specialized; NULL is
+ * returned for other degrees, or if the number of nodes exceeds MaxNumberOfNodes2D, and the caller shall use its
+ * generic path. Hence the callers can hold the values of a selected kernel in a stack buffer of MaxNumberOfNodes2D.
+ */
+template<class TVectorType, class TMatrixType, class TValuesContainerType>
+struct BezierKernelSelector
+{
+    static const int MaxDegree = 4;
+    static const int MaxNumberOfNodes2D = (MaxDegree + 1) * (MaxDegree + 1);
+
+    typedef void (*ShapeFunctionsKernel2DType)(double*, TMatrixType&, const TMatrixType&,
+            const TValuesContainerType&, const TVectorType&, const double&, const double&);
+
+    static ShapeFunctionsKernel2DType Select2D(const int& Degree1, const int& Degree2, const std::size_t& NumberOfNodes)
+    {
+        if(NumberOfNodes > static_cast<std::size_t>(MaxNumberOfNodes2D))
+            return NULL;
+
+        switch(Degree1)
+        {
+        case 1: return SelectSecondDegree2D<1>(Degree2);
+        case 2: return SelectSecondDegree2D<2>(Degree2);
+        case 3: return SelectSecondDegree2D<3>(Degree2);
+        case 4: return SelectSecondDegree2D<4>(Degree2);
+        default: return NULL;
+        }
+    }
+
+private:
+
+    template<int TDegree1>
+    static ShapeFunctionsKernel2DType SelectSecondDegree2D(const int& Degree2)
+    {
+        switch(Degree2)
+        {
+        case 1: return &BezierKernel2D<TDegree1, 1>::template ComputeShapeFunctionsValuesAndLocalGradients<TVectorType, TMatrixType, TValuesContainerType>;
+        case 2: return &BezierKernel2D<TDegree1, 2>::template ComputeShapeFunctionsValuesAndLocalGradients<TVectorType, TMatrixType, TValuesContainerType>;
+        case 3: return &BezierKernel2D<TDegree1, 3>::template ComputeShapeFunctionsValuesAndLocalGradients<TVectorType, TMatrixType, TValuesContainerType>;
+        case 4: return &BezierKernel2D<TDegree1, 4>::template ComputeShapeFunctionsValuesAndLocalGradients<TVectorType, TMatrixType, TValuesContainerType>;
+        default: return NULL;
+        }
+    }
+};
+
+///@}
+
+///@} addtogroup block
+
+}// namespace Kratos.
+
+#endif // KRATOS_BEZIER_KERNELS_H_INCLUDED  defined
@@ -20,25 +20,8 @@
 namespace Kratos
 {
 
-const int BezierUtils::msBernsteinCoefs[] = {
-          2                 // p = 2
-        , 3                 // p = 3
-        , 4, 6              // p = 4
-        , 5, 10
-        , 6, 15, 20
-        , 7, 21, 35
-        , 8, 28, 56, 70
-        , 9, 36, 84, 126
-        , 10, 45, 120, 210, 252
-        , 11, 55, 165, 330, 462
-        , 12, 66, 220, 495, 792, 924
-        , 13, 78, 186, 715, 1287, 1716
-        , 14, 91, 364, 1001, 2002, 3003, 3432
-        , 15, 105, 455, 1365, 3003, 5005, 6435
-        , 16, 120, 560, 1820, 4368, 8008, 11440, 12870
-    };
-
-BezierUtils::MapType BezierUtils::mIntegrationMethods;
+const BezierUtils::MapType* BezierUtils::mpIntegrationMethods = NULL;
+std::vector<boost::shared_ptr<const BezierUtils::MapType> > BezierUtils::mRetiredIntegrationMethods;
 
 // void BezierUtils::IsogeometricMathUtils::compute_extended_knot_vector(
 //        Vector& Ubar,       // extended knot vector (OUTPUT)
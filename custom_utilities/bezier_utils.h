@@ -17,6 +17,7 @@
 #include <fstream>
 
 // External includes
+#include <boost/shared_ptr.hpp>
 
 // Project includes
 #include "includes/define.h"
@@ -32,6 +33,7 @@
 #include "utilities/math_utils.h"
 #include "custom_geometries/isogeometric_geometry.h"
 #include "custom_utilities/isogeometric_math_utils.h"
+#include "custom_utilities/bezier_kernels.h"
 
 #define ENABLE_PROFILING
 
@@ -218,7 +220,6 @@ public:
 
     /**
      * Computes Bernstein basis function B(i, p)(x) on [0, 1]
-     * Remark when debugging hierarchical NURBS, it may be not correct
      */
     static inline double bernstein(const int& i, const int& p, const double& x)
     {
@@ -226,33 +227,12 @@ public:
         if(i < 0 || i > p)
             return 0.0;
 
-        double a = x;
-        double b = 1 - x;
-        double coeff;
-
-        if(p == 0)
-        {
-            return 1.0;
-        }
-        else if(p == 1)
-        {
-            coeff = 1.0;
-        }
-        else
-        {
-            int cnt;
-            for(int j = 0; j < p - 2; ++j)
-            {
-                cnt += (j + 2) / 2;
-            }
-            coeff = msBernsteinCoefs[cnt - 1];
-        }
-
-        return coeff * pow(a, i) * pow(b, p - i);
+        return BernsteinBasis::Binomial(p, i) * pow(x, i) * pow(1 - x, p - i);
     }
 
     /**
      * Computes Bernstein basis function B(i, p)(x) on [0, 1] using recursive iteration
+     * Remark: this is exponential in p and is kept as a reference implementation
      */
     static double bernstein2(const int& i, const int& p, const double& x)
     {
@@ -294,8 +274,8 @@ public:
         double a = x;
         double b = 1 - x;
 
-        double tmp1 = bernstein2(i, p - 1, x);
-        double tmp2 = bernstein2(i - 1, p - 1, x);
+        double tmp1 = bernstein(i, p - 1, x);
+        double tmp2 = bernstein(i - 1, p - 1, x);
 
         v = b * tmp1 + a * tmp2;
         d = p * (tmp2 - tmp1);
@@ -314,15 +294,7 @@ public:
             return;
         }
 
-        if(p == 0)
-        {
-            v = 1.0;
-            d = 0.0;
-            d2 = 0.0;
-            return;
-        }
-
-        if(p == 1)
+        if(p < 2)
         {
             bernstein(v, d, i, p, x);
             d2 = 0.0;
@@ -332,76 +304,47 @@ public:
         double a = x;
         double b = 1 - x;
 
-        double tmp1 = bernstein2(i    , p - 1, x);
-        double tmp2 = bernstein2(i - 1, p - 1, x);
-        double tmp3 = bernstein2(i    , p - 2, x);
-        double tmp4 = bernstein2(i - 1, p - 2, x);
-        double tmp5 = bernstein2(i - 2, p - 2, x);
+        double tmp3 = bernstein(i    , p - 2, x);
+        double tmp4 = bernstein(i - 1, p - 2, x);
+        double tmp5 = bernstein(i - 2, p - 2, x);
+        double tmp1 = b * tmp3 + a * tmp4;
+        double tmp2 = b * tmp4 + a * tmp5;
 
         v = b * tmp1 + a * tmp2;
         d = p * (tmp2 - tmp1);
         d2 = p * (p-1) * (tmp3 - 2 * tmp4 + tmp5);
     }
 
+    /**
+     * Computes all Bernstein basis functions B(0..p, p)(x) on [0, 1]
+     */
     template<class ValuesContainerType>
     static inline void bernstein(ValuesContainerType& rS, const int& p, const double& x)
     {
-        double a = x;
-        double b = 1 - x;
-
-        if(p == 0)
-        {
-            rS[0] = 1.0;
-            return;
-        }
-        else if(p == 1)
-        {
-            rS[0] = b;
-            rS[1] = a;
-            return;
-        }
-        else
-        {
-            rS[0] = 1.0;
-            rS[p] = 1.0;
-            int cnt = 0;
-
-            for(int j = 0; j < p - 2; ++j)
-            {
-                cnt += (j + 2) / 2;
-            }
-
-            for(int j = 0; j < p / 2; ++j)
-            {
-                rS[j + 1] = msBernsteinCoefs[cnt + j];
-            }
-
-            for(int j = 0; j < (p - 1) / 2; ++j)
-            {
-                rS[p - j - 1] = rS[j + 1];
-            }
-
-            for(int j = 0; j < p + 1; ++j)
-            {
-                rS[j] *= (pow(a, j) * pow(b, p - j));
-            }
-
-            return;
-        }
+        BernsteinBasis::Values(rS, p, x);
     }
 
+    /**
+     * Computes all Bernstein basis functions B(0..p, p)(x) on [0, 1] and their derivatives
+     */
     template<class ValuesContainerType>
     static inline void bernstein(ValuesContainerType& rS,
                                  ValuesContainerType& rD,
                                  const int& p,
                                  const double& x)
     {
+        double ders[2 * (BernsteinBasis::MaxDegree + 1)];
+        BernsteinBasis::Derivatives(ders, p, 1, x);
         for(int i = 0; i < p + 1; ++i)
         {
-            bernstein(rS[i], rD[i], i, p, x);
+            rS[i] = ders[i];
+            rD[i] = ders[p + 1 + i];
         }
     }
 
+    /**
+     * Computes all Bernstein basis functions B(0..p, p)(x) on [0, 1] and their first and second derivatives
+     */
     template<class ValuesContainerType>
     static inline void bernstein(ValuesContainerType& rS,
                                  ValuesContainerType& rD,
@@ -409,12 +352,48 @@ public:
                                  const int& p,
                                  const double& x)
     {
+        double ders[3 * (BernsteinBasis::MaxDegree + 1)];
+        BernsteinBasis::Derivatives(ders, p, 2, x);
         for(int i = 0; i < p + 1; ++i)
         {
-            bernstein(rS[i], rD[i], rD2[i], i, p, x);
+            rS[i] = ders[i];
+            rD[i] = ders[p + 1 + i];
+            rD2[i] = ders[2*(p + 1) + i];
         }
     }
 
+    /**
+     * Computes the derivatives of order 0..k of all Bernstein basis functions B(0..p, p)(x) on [0, 1]
+     * rDers(j, i) is the j-th derivative of B(i, p)
+     */
+    template<class ValuesArrayContainerType>
+    static inline void bernstein_derivatives(ValuesArrayContainerType& rDers, const int& p, const int& k, const double& x)
+    {
+        std::vector<double> ders((k + 1) * (p + 1));
+        BernsteinBasis::Derivatives(&ders[0], p, k, x);
+        if(rDers.size1() != static_cast<std::size_t>(k + 1) || rDers.size2() != static_cast<std::size_t>(p + 1))
+            rDers.resize(k + 1, p + 1, false);
+        for(int j = 0; j < k + 1; ++j)
+            for(int i = 0; i < p + 1; ++i)
+                rDers(j, i) = ders[j * (p + 1) + i];
+    }
+
+    /**
+     * Computes the derivatives of order 0..k of all Bernstein basis functions B(0..p, p) at a set of abscissae on [0, 1]
+     * rDers[(j*(p+1) + i)*n + t] is the j-th derivative of B(i, p) at rX[t], n being the number of abscissae
+     */
+    template<class TVectorType>
+    static inline void bernstein_derivatives(std::vector<double>& rDers, const int& p, const int& k, const TVectorType& rX)
+    {
+        const std::size_t n = rX.size();
+        std::vector<double> X(n);
+        for(std::size_t t = 0; t < n; ++t)
+            X[t] = rX[t];
+        rDers.resize((k + 1) * (p + 1) * n);
+        if(n > 0)
+            BernsteinBasis::Derivatives(&rDers[0], p, k, &X[0], n);
+    }
+
     /********************************************************
             End of Fundamental Bezier handling functions
      ********************************************************/
@@ -431,49 +410,49 @@ public:
         //define the key
         BezierGeometryDataKey Key(NumberOfIntegrationMethod, Order, 0, 0, TDimension, TWorkingSpaceDimension, TLocalSpaceDimension);
 
-        //find the key in existing map
-        if(mIntegrationMethods.find(Key) != mIntegrationMethods.end())
-        //found the key
-        {
-//            std::cout << "Key " << Key << " existed and ready to be used" << std::endl;
-        }
-        else
-        {
-            //created integration rule and insert the key
-            //define the integration rule
-            IntegrationPointsContainerType all_integration_points
-                = AllIntegrationPoints(NumberOfIntegrationMethod, Order);
-
-            ShapeFunctionsValuesContainerType shape_functions_values;
-            ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
+        //the key is already registered, this does not need any lock
+        if(FindIntegrationRule(Key) != NULL)
+            return;
 
-            for (IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
+        //only one thread creates the integration rule, the others wait and find it afterward
+        #pragma omp critical(BezierUtils_RegisterIntegrationRule)
+        {
+            if(FindIntegrationRule(Key) == NULL)
             {
-                CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
-                    Order,
-                    shape_functions_values[i],
-                    shape_functions_local_gradients[i],
-                    all_integration_points[i]
-                );
-            }
+                //created integration rule and insert the key
+                //define the integration rule
+                IntegrationPointsContainerType all_integration_points
+                    = AllIntegrationPoints(NumberOfIntegrationMethod, Order);
 
-            //create the geometry_data pointer
-            GeometryData::Pointer pNewGeometryData = GeometryData::Pointer(
-                new GeometryData(
-                    TDimension,
-                    TWorkingSpaceDimension,
-                    TLocalSpaceDimension,
-                    GeometryData::GI_GAUSS_2,           //ThisDefaultMethod
-                    all_integration_points,             //ThisIntegrationPoints
-                    shape_functions_values,             //ThisShapeFunctionsValues
-                    shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
-                )
-            );
+                ShapeFunctionsValuesContainerType shape_functions_values;
+                ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
+
+                for (IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
+                {
+                    CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
+                        Order,
+                        shape_functions_values[i],
+                        shape_functions_local_gradients[i],
+                        all_integration_points[i]
+                    );
+                }
 
-            //insert value to map
-            mIntegrationMethods.insert(PairType(Key, pNewGeometryData));
+                //create the geometry_data pointer
+                GeometryData::Pointer pNewGeometryData = GeometryData::Pointer(
+                    new GeometryData(
+                        TDimension,
+                        TWorkingSpaceDimension,
+                        TLocalSpaceDimension,
+                        GeometryData::GI_GAUSS_2,           //ThisDefaultMethod
+                        all_integration_points,             //ThisIntegrationPoints
+                        shape_functions_values,             //ThisShapeFunctionsValues
+                        shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
+                    )
+                );
 
-            std::cout << "Registered BezierGeometryData " << Key << " successfully" << std::endl;
+                //publish the new integration rule
+                InsertIntegrationRule(Key, pNewGeometryData);
+            }
         }
     }
 
@@ -487,47 +466,47 @@ public:
         //define the key
         BezierGeometryDataKey Key(NumberOfIntegrationMethod, Order1, Order2, 0, TDimension, TWorkingSpaceDimension, TLocalSpaceDimension);
 
-        //find the key in existing map
-        if(mIntegrationMethods.find(Key) != mIntegrationMethods.end())
-        //found the key
-        {
-//            std::cout << "Key " << Key << " existed and ready to be used" << std::endl;
-        }
-        else
-        {
-            IntegrationPointsContainerType all_integration_points
-                = AllIntegrationPoints(NumberOfIntegrationMethod, Order1, Order2);
-
-            ShapeFunctionsValuesContainerType shape_functions_values;
-            ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
+        //the key is already registered, this does not need any lock
+        if(FindIntegrationRule(Key) != NULL)
+            return;
 
-            for (IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
+        //only one thread creates the integration rule, the others wait and find it afterward
+        #pragma omp critical(BezierUtils_RegisterIntegrationRule)
+        {
+            if(FindIntegrationRule(Key) == NULL)
             {
-                CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
-                    Order1,
-                    Order2,
-                    shape_functions_values[i],
-                    shape_functions_local_gradients[i],
-                    all_integration_points[i]
-                );
-            }
+                IntegrationPointsContainerType all_integration_points
+                    = AllIntegrationPoints(NumberOfIntegrationMethod, Order1, Order2);
 
-            GeometryData::Pointer pNewGeometryData = GeometryData::Pointer(
-                new GeometryData(
-                    TDimension,
-                    TWorkingSpaceDimension,
-                    TLocalSpaceDimension,
-                    GeometryData::GI_GAUSS_2,           //ThisDefaultMethod
-                    all_integration_points,             //ThisIntegrationPoints
-                    shape_functions_values,             //ThisShapeFunctionsValues
-                    shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
-                )
-            );
+                ShapeFunctionsValuesContainerType shape_functions_values;
+                ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
 
-            //insert value to map
-            mIntegrationMethods.insert(PairType(Key, pNewGeometryData));
+                for (IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
+                {
+                    CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
+                        Order1,
+                        Order2,
+                        shape_functions_values[i],
+                        shape_functions_local_gradients[i],
+                        all_integration_points[i]
+                    );
+                }
 
-            std::cout << "Registered BezierGeometryData " << Key << " successfully" << std::endl;
+                GeometryData::Pointer pNewGeometryData = GeometryData::Pointer(
+                    new GeometryData(
+                        TDimension,
+                        TWorkingSpaceDimension,
+                        TLocalSpaceDimension,
+                        GeometryData::GI_GAUSS_2,           //ThisDefaultMethod
+                        all_integration_points,             //ThisIntegrationPoints
+                        shape_functions_values,             //ThisShapeFunctionsValues
+                        shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
+                    )
+                );
+
+                //publish the new integration rule
+                InsertIntegrationRule(Key, pNewGeometryData);
+            }
         }
     }
 
@@ -542,49 +521,48 @@ public:
         //define the key
         BezierGeometryDataKey Key(NumberOfIntegrationMethod, Order1, Order2, Order3, TDimension, TWorkingSpaceDimension, TLocalSpaceDimension);
 
-        //find the key in existing map
-        if(mIntegrationMethods.find(Key) != mIntegrationMethods.end())
-        //found the key
-        {
-//            std::cout << "Key " << Key << " existed and ready to be used" << std::endl;
+        //the key is already registered, this does not need any lock
+        if(FindIntegrationRule(Key) != NULL)
             return;
-        }
-        else
-        {
-            IntegrationPointsContainerType all_integration_points
-                = AllIntegrationPoints(NumberOfIntegrationMethod, Order1, Order2, Order3);
 
-            ShapeFunctionsValuesContainerType shape_functions_values;
-            ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
-
-            for (IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
+        //only one thread creates the integration rule, the others wait and find it afterward
+        #pragma omp critical(BezierUtils_RegisterIntegrationRule)
+        {
+            if(FindIntegrationRule(Key) == NULL)
             {
-                CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
-                    Order1,
-                    Order2,
-                    Order3,
-                    shape_functions_values[i],
-                    shape_functions_local_gradients[i],
-                    all_integration_points[i]
-                );
-            }
+                IntegrationPointsContainerType all_integration_points
+                    = AllIntegrationPoints(NumberOfIntegrationMethod, Order1, Order2, Order3);
 
-            GeometryData::Pointer pNewGeometryData = GeometryData::Pointer(
-                new GeometryData(
-                    TDimension,
-                    TWorkingSpaceDimension,
-                    TLocalSpaceDimension,
-                    GeometryData::GI_GAUSS_2,           //ThisDefaultMethod
-                    all_integration_points,             //ThisIntegrationPoints
-                    shape_functions_values,             //ThisShapeFunctionsValues
-                    shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
-                )
-            );
+                ShapeFunctionsValuesContainerType shape_functions_values;
+                ShapeFunctionsLocalGradientsContainerType shape_functions_local_gradients;
+
+                for (IndexType i = 0; i < NumberOfIntegrationMethod; ++i)
+                {
+                    CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(
+                        Order1,
+                        Order2,
+                        Order3,
+                        shape_functions_values[i],
+                        shape_functions_local_gradients[i],
+                        all_integration_points[i]
+                    );
+                }
 
-            //insert value to map
-            mIntegrationMethods.insert(PairType(Key, pNewGeometryData));
+                GeometryData::Pointer pNewGeometryData = GeometryData::Pointer(
+                    new GeometryData(
+                        TDimension,
+                        TWorkingSpaceDimension,
+                        TLocalSpaceDimension,
+                        GeometryData::GI_GAUSS_2,           //ThisDefaultMethod
+                        all_integration_points,             //ThisIntegrationPoints
+                        shape_functions_values,             //ThisShapeFunctionsValues
+                        shape_functions_local_gradients     //ThisShapeFunctionsLocalGradients
+                    )
+                );
 
-            std::cout << "Registered BezierGeometryData " << Key << " successfully" << std::endl;
+                //publish the new integration rule
+                InsertIntegrationRule(Key, pNewGeometryData);
+            }
         }
     }
 
@@ -595,7 +573,7 @@ public:
     )
     {
         BezierGeometryDataKey Key(NumberOfIntegrationMethod, Order1, 0, 0, TDimension, TWorkingSpaceDimension, TLocalSpaceDimension);
-        return mIntegrationMethods[Key];
+        return GetIntegrationRule(Key);
     }
 
     template<std::size_t TDimension, std::size_t TWorkingSpaceDimension, std::size_t TLocalSpaceDimension>
@@ -606,7 +584,7 @@ public:
     )
     {
         BezierGeometryDataKey Key(NumberOfIntegrationMethod, Order1, Order2, 0, TDimension, TWorkingSpaceDimension, TLocalSpaceDimension);
-        return mIntegrationMethods[Key];
+        return GetIntegrationRule(Key);
     }
 
     template<std::size_t TDimension, std::size_t TWorkingSpaceDimension, std::size_t TLocalSpaceDimension>
@@ -618,7 +596,34 @@ public:
     )
     {
         BezierGeometryDataKey Key(NumberOfIntegrationMethod, Order1, Order2, Order3, TDimension, TWorkingSpaceDimension, TLocalSpaceDimension);
-        return mIntegrationMethods[Key];
+        return GetIntegrationRule(Key);
+    }
+
+    /**
+     * Register the integration rules of the Bezier geometries (Geo1dBezier, Geo2dBezier, Geo2dBezier3 and Geo3dBezier)
+     * for all degrees up to MaxOrder in each direction. This is to be called at the start of the application, such that
+     * the later calls to RegisterIntegrationRule from the element creation loop only need the lock-free lookup.
+     */
+    static void RegisterIntegrationRules(unsigned int NumberOfIntegrationMethod, unsigned int MaxOrder)
+    {
+        for(unsigned int p1 = 1; p1 <= MaxOrder; ++p1)
+        {
+            RegisterIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, p1);
+            for(unsigned int p2 = 1; p2 <= MaxOrder; ++p2)
+            {
+                RegisterIntegrationRule<2, 2, 2>(NumberOfIntegrationMethod, p1, p2);
+                RegisterIntegrationRule<2, 3, 2>(NumberOfIntegrationMethod, p1, p2);
+                for(unsigned int p3 = 1; p3 <= MaxOrder; ++p3)
+                    RegisterIntegrationRule<3, 3, 3>(NumberOfIntegrationMethod, p1, p2, p3);
+            }
+        }
+    }
+
+    /// Get the number of registered integration rules
+    static std::size_t NumberOfRegisteredIntegrationRules()
+    {
+        const MapType* pIntegrationMethods = GetIntegrationMethods();
+        return (pIntegrationMethods == NULL) ? 0 : pIntegrationMethods->size();
     }
 
     template<std::size_t TDimension, std::size_t TWorkingSpaceDimension, std::size_t TLocalSpaceDimension>
@@ -653,8 +658,6 @@ public:
             )
         );
 
-        std::cout << "Create BezierGeometryData successfully for " << integration_points.size() << " integration points" << std::endl;
-
         return pNewGeometryData;
     }
 
@@ -692,8 +695,6 @@ public:
             )
         );
 
-        std::cout << "Create BezierGeometryData successfully for " << integration_points.size() << " integration points" << std::endl;
-
         return pNewGeometryData;
     }
 
@@ -733,8 +734,6 @@ public:
             )
         );
 
-        std::cout << "Create BezierGeometryData successfully for " << integration_points.size() << " integration points" << std::endl;
-
         return pNewGeometryData;
     }
 
@@ -1099,8 +1098,6 @@ public:
 //            KRATOS_WATCH(BaseRule[offset1].size())
 //            KRATOS_WATCH(BaseRule[offset2].size())
 //            KRATOS_WATCH(BaseRule[offset3].size())
-
-            std::cout << BaseRule[offset1].size() * BaseRule[offset2].size() * BaseRule[offset3].size() << " integration points are generated" << std::endl;
         }
         return integration_points;
     }
@@ -1467,9 +1464,13 @@ private:
     ///@name Static Member Variables
     ///@{
 
-    static const int msBernsteinCoefs[];
-
-    static MapType mIntegrationMethods;
+    // The registered integration rules. The published map is never modified; a new registration copies it, inserts
+    // the new key and publishes the copy through an atomic pointer. Every published map, the current one included, is
+    // owned by mRetiredIntegrationMethods and never freed, since a concurrent lookup may still read it. Hence a lookup is a
+    // single atomic load, without lock nor reference counting. The number of retired maps is bounded by the number
+    // of registered rules, which is small and fixed at the start by RegisterIntegrationRules.
+    static const MapType* mpIntegrationMethods;
+    static std::vector<boost::shared_ptr<const MapType> > mRetiredIntegrationMethods;
 
     ///@}
     ///@name Member Variables
@@ -1483,6 +1484,57 @@ private:
     ///@name Private Operations
     ///@{
 
+    /// Get the current published map of integration rules, NULL if nothing is registered yet
+    static const MapType* GetIntegrationMethods()
+    {
+        const MapType* pIntegrationMethods;
+        #pragma omp atomic read
+        pIntegrationMethods = mpIntegrationMethods;
+        #pragma omp flush
+        return pIntegrationMethods;
+    }
+
+    /// Find the integration rule of a key in the published map; NULL is returned if the key is not registered.
+    /// The returned pointer stays valid for the whole run, and no reference count is touched.
+    static const GeometryData::Pointer* FindIntegrationRule(const BezierGeometryDataKey& Key)
+    {
+        const MapType* pIntegrationMethods = GetIntegrationMethods();
+        if(pIntegrationMethods == NULL)
+            return NULL;
+
+        MapType::const_iterator it = pIntegrationMethods->find(Key);
+        if(it == pIntegrationMethods->end())
+            return NULL;
+
+        return &(it->second);
+    }
+
+    /// Get the integration rule of a key; an empty pointer is returned if the key is not registered
+    static GeometryData::Pointer GetIntegrationRule(const BezierGeometryDataKey& Key)
+    {
+        const GeometryData::Pointer* ppGeometryData = FindIntegrationRule(Key);
+        if(ppGeometryData == NULL)
+            return GeometryData::Pointer();
+        return *ppGeometryData;
+    }
+
+    /// Publish a new integration rule. It must be called inside the critical section of RegisterIntegrationRule.
+    static void InsertIntegrationRule(const BezierGeometryDataKey& Key, GeometryData::Pointer pGeometryData)
+    {
+        boost::shared_ptr<MapType> pNewIntegrationMethods;
+        if(mpIntegrationMethods == NULL)
+            pNewIntegrationMethods = boost::shared_ptr<MapType>(new MapType());
+        else
+            pNewIntegrationMethods = boost::shared_ptr<MapType>(new MapType(*mpIntegrationMethods));
+        pNewIntegrationMethods->insert(PairType(Key, pGeometryData));
+        mRetiredIntegrationMethods.push_back(pNewIntegrationMethods);
+
+        const MapType* pIntegrationMethods = pNewIntegrationMethods.get();
+        #pragma omp flush
+        #pragma omp atomic write
+        mpIntegrationMethods = pIntegrationMethods;
+    }
+
     /**
      * Calculate global coodinates w.r.t initial configuration
      */
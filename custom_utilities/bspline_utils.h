@@ -582,6 +582,68 @@ public:
         return N[nt-s+p];
     }
 
+    /// Compute the value and the first derivative of the B-spline basis function on the local knot vector
+    /// The triangular table of the lower degree functions is computed iteratively in place, without the extended knot vector.
+    /// Same as CoxDeBoor3, the function is right-continuous except at the last knot, where the left limit is taken.
+    //    % Input:
+    //    %   u       knot to be compute the function value
+    //    %   p       B-spline degree, p < 32
+    //    %   knots   local knot vector (p+2 values), must be ascending
+    //    % Output: function value and derivative
+    template<class ValuesContainerType>
+    static void CoxDeBoorLocal(double& value, double& derivative, const double& u, const int& p, const ValuesContainerType& knots)
+    {
+        value = 0.0;
+        derivative = 0.0;
+        if ((u < knots[0]) || (u > knots[p+1]))
+            return;
+
+        if (p > 31)
+            KRATOS_THROW_ERROR(std::logic_error, "CoxDeBoorLocal does not support the degree", p)
+
+        // degree 0
+        double N[32];
+        for (int j = 0; j <= p; ++j)
+            N[j] = ((u >= knots[j]) && (u < knots[j+1])) ? 1.0 : 0.0;
+        if (u == knots[p+1])
+        {
+            for (int j = p; j >= 0; --j)
+            {
+                if (knots[j+1] > knots[j])
+                {
+                    N[j] = 1.0;
+                    break;
+                }
+            }
+        }
+
+        if (p == 0)
+        {
+            value = N[0];
+            return;
+        }
+
+        // degree 1 to p-1; N[j] is overwritten by N_{j,k} and N[j+1] still holds N_{j+1,k-1}
+        for (int k = 1; k < p; ++k)
+        {
+            for (int j = 0; j <= p - k; ++j)
+            {
+                double a = 0.0, b = 0.0;
+                if (knots[j+k] > knots[j])
+                    a = (u - knots[j]) / (knots[j+k] - knots[j]) * N[j];
+                if (knots[j+k+1] > knots[j+1])
+                    b = (knots[j+k+1] - u) / (knots[j+k+1] - knots[j+1]) * N[j+1];
+                N[j] = a + b;
+            }
+        }
+
+        // degree p and its derivative from N_{0,p-1} and N_{1,p-1}
+        const double left = (knots[p] > knots[0]) ? N[0] / (knots[p] - knots[0]) : 0.0;
+        const double right = (knots[p+1] > knots[1]) ? N[1] / (knots[p+1] - knots[1]) : 0.0;
+        value = (u - knots[0]) * left + (knots[p+1] - u) * right;
+        derivative = p * (left - right);
+    }
+
     /// Compute the refinement coefficients for one knot insertion B-Splines refinement in 1D
     /// REF: Eq (5.10) the NURBS books
     template<class MatrixType, class ValuesContainerType>
@@ -17,6 +17,7 @@
 // Project includes
 #include "includes/define.h"
 #include "includes/ublas_interface.h"
+#include "custom_utilities/extraction_operator_arena.h"
 
 // External includes
 #include <boost/numeric/ublas/vector_sparse.hpp>
@@ -37,14 +38,20 @@ public:
     /// Type definitions
     typedef boost::numeric::ublas::mapped_vector<double> SparseVectorType;
     // typedef boost::numeric::ublas::vector<double> SparseVectorType;
+    typedef ExtractionOperatorArena ArenaType;
+    typedef ArenaType::RowView RowViewType;
+    typedef ArenaType::OperatorPointerType ExtractionOperatorPointerType;
 
     /// Default constructor
     Cell(const std::size_t& Id) : mId(Id)
     {}
 
-    /// Destructor
+    /// Destructor. The rows of the extraction operator are given back to the arena.
     virtual ~Cell()
-    {}
+    {
+        if (mpArena != NULL)
+            mpArena->ReleaseRows(mCrowIds);
+    }
 
     /// Get the Id
     std::size_t Id() const {return mId;}
@@ -54,34 +61,52 @@ public:
     {
         mSupportedAnchors.clear();
         mAnchorWeights.clear();
-        mCrows.clear();
+        if (mpArena != NULL)
+            mpArena->ReleaseRows(mCrowIds);
+        mCrowIds.clear();
     }
 
+    /// Set the arena to store the extraction operator of this cell. If the cell already has extraction data, it is moved to the new arena.
+    void SetExtractionOperatorArena(ArenaType::Pointer pArena)
+    {
+        if (mpArena == pArena)
+            return;
+
+        Vector Crow;
+        for (std::size_t i = 0; i < mCrowIds.size(); ++i)
+        {
+            mpArena->GetRow(mCrowIds[i], Crow);
+            mpArena->ReleaseRow(mCrowIds[i]);
+            mCrowIds[i] = pArena->AddRow(Crow);
+        }
+        mpArena = pArena;
+    }
+
+    /// Get the arena storing the extraction operator of this cell
+    ArenaType::Pointer pGetExtractionOperatorArena() const {return mpArena;}
+
     /// Add supported anchor and the respective extraction operator of this cell to the anchor
-    void AddAnchor(const std::size_t& Id, const double& W, const Vector& Crow)
+    virtual void AddAnchor(const std::size_t& Id, const double& W, const Vector& Crow)
     {
         mSupportedAnchors.push_back(Id);
         mAnchorWeights.push_back(W);
 
-        std::vector<std::size_t> inz;
-        inz.reserve(Crow.size());
-        for (std::size_t i = 0; i < Crow.size(); ++i)
-            if (Crow[i] != 0.0)
-                inz.push_back(i);
-        SparseVectorType Crow_sparse(Crow.size(), inz.size());
-        for (std::size_t i = 0; i < inz.size(); ++i)
-            Crow_sparse[inz[i]] = Crow[inz[i]];
-        mCrows.push_back(Crow_sparse);
+        // the cell which is not managed by a cell manager keeps its own arena
+        if (mpArena == NULL)
+            mpArena = ArenaType::Pointer(new ArenaType());
+        mCrowIds.push_back(mpArena->AddRow(Crow));
     }
 
     /// Absorb the information from the other cell
     virtual void Absorb(Cell::Pointer pOther)
     {
+        Vector Crow;
         for (std::size_t i = 0; i < pOther->NumberOfAnchors(); ++i)
         {
             if (std::find(mSupportedAnchors.begin(), mSupportedAnchors.end(), pOther->GetSupportedAnchors()[i]) == mSupportedAnchors.end())
             {
-                this->AddAnchor(pOther->GetSupportedAnchors()[i], pOther->GetAnchorWeights()[i], pOther->GetCrows()[i]);
+                pOther->GetCrow(i, Crow);
+                this->AddAnchor(pOther->GetSupportedAnchors()[i], pOther->GetAnchorWeights()[i], Crow);
             }
         }
     }
@@ -107,44 +132,70 @@ public:
         std::copy(mAnchorWeights.begin(), mAnchorWeights.end(), rWeights.begin());
     }
 
-    /// Get the internal data of row of the extraction operator
-    const std::vector<SparseVectorType>& GetCrows() const {return mCrows;}
+    /// Get the indices of the rows of the extraction operator in the arena
+    const std::vector<std::size_t>& GetCrowIds() const {return mCrowIds;}
+
+    /// Get the view on row i of the extraction operator. The view is valid until new rows are added to the arena.
+    RowViewType GetCrowView(const std::size_t& i) const {return mpArena->GetRowView(mCrowIds[i]);}
+
+    /// Get row i of the extraction operator
+    virtual void GetCrow(const std::size_t& i, Vector& rCrow) const {mpArena->GetRow(mCrowIds[i], rCrow);}
+
+    /// Check if the extraction operator of this cell is stored row by row in the arena. Otherwise GetCrowIds and GetCrowView are not applicable.
+    virtual bool HasCrowsInArena() const {return true;}
 
     /// Get the extraction operator matrix
-    Matrix GetExtractionOperator() const
+    virtual Matrix GetExtractionOperator() const
     {
-        Matrix M(mCrows.size(), mCrows[0].size());
-        for(std::size_t i = 0; i < mCrows.size(); ++i)
-            noalias(row(M, i)) = mCrows[i];
+        if (mCrowIds.size() == 0)
+            return Matrix(0, 0);
+
+        Matrix M(mCrowIds.size(), mpArena->RowSize(mCrowIds[0]));
+        noalias(M) = ZeroMatrix(M.size1(), M.size2());
+        for(std::size_t i = 0; i < mCrowIds.size(); ++i)
+        {
+            RowViewType Crow = mpArena->GetRowView(mCrowIds[i]);
+            for(std::size_t k = 0; k < Crow.NumberOfNonzeros; ++k)
+                M(i, Crow.Indices[k]) = Crow.Values[k];
+        }
         return M;
     }
 
     /// Get the extraction as compressed matrix
-    CompressedMatrix GetCompressedExtractionOperator() const
+    virtual CompressedMatrix GetCompressedExtractionOperator() const
     {
-        CompressedMatrix M(mCrows.size(), mCrows[0].size());
-        // here we just naively copy the data. However we shall initialize the compressed matrix properly as in the kernel (TODO)
-        for(std::size_t i = 0; i < mCrows.size(); ++i)
-            noalias(row(M, i)) = mCrows[i];
+        if (mCrowIds.size() == 0)
+            return CompressedMatrix(0, 0);
+
+        std::size_t nnz = 0;
+        for(std::size_t i = 0; i < mCrowIds.size(); ++i)
+            nnz += mpArena->GetRowView(mCrowIds[i]).NumberOfNonzeros;
+
+        // the nonzeros are appended in row-major order, hence the compressed matrix is filled without reallocation
+        CompressedMatrix M(mCrowIds.size(), mpArena->RowSize(mCrowIds[0]), nnz);
+        for(std::size_t i = 0; i < mCrowIds.size(); ++i)
+        {
+            RowViewType Crow = mpArena->GetRowView(mCrowIds[i]);
+            for(std::size_t k = 0; k < Crow.NumberOfNonzeros; ++k)
+                M.push_back(i, Crow.Indices[k], Crow.Values[k]);
+        }
         M.complete_index1_data();
         return M;
     }
 
     /// Get the extraction operator as CSR triplet
-    void GetExtractionOperator(std::vector<int>& rowPtr, std::vector<int>& colInd, std::vector<double>& values) const
+    virtual void GetExtractionOperator(std::vector<int>& rowPtr, std::vector<int>& colInd, std::vector<double>& values) const
     {
         int cnt = 0;
         rowPtr.push_back(cnt);
-        for(std::size_t i = 0; i < mCrows.size(); ++i)
+        for(std::size_t i = 0; i < mCrowIds.size(); ++i)
         {
-            for(std::size_t j = 0; j < mCrows[i].size(); ++j)
+            RowViewType Crow = mpArena->GetRowView(mCrowIds[i]);
+            for(std::size_t k = 0; k < Crow.NumberOfNonzeros; ++k)
             {
-                if(mCrows[i](j) != 0)
-                {
-                    colInd.push_back(j);
-                    values.push_back(mCrows[i](j));
-                    ++cnt;
-                }
+                colInd.push_back(Crow.Indices[k]);
+                values.push_back(Crow.Values[k]);
+                ++cnt;
             }
             rowPtr.push_back(cnt);
         }
@@ -181,7 +232,14 @@ protected:
     std::size_t mId;
     std::vector<std::size_t> mSupportedAnchors;
     std::vector<double> mAnchorWeights; // weight of the anchor
-    std::vector<SparseVectorType> mCrows; // bezier extraction operator row to each anchor
+    std::vector<std::size_t> mCrowIds; // index of the bezier extraction operator row to each anchor in the arena
+    ArenaType::Pointer mpArena; // arena storing the extraction operator rows, shared with the other cells of the cell manager
+
+private:
+
+    /// The cell holds references to the rows in the arena, hence it is not copyable
+    Cell(const Cell& rOther);
+    Cell& operator=(const Cell& rOther);
 };
 
 /// output stream function
@@ -48,7 +48,7 @@ public:
     typedef typename cell_container_t::const_iterator const_iterator;
 
     /// Default constructor
-    CellContainer()
+    CellContainer() : mpExtractionOperatorArena(new ExtractionOperatorArena())
     {}
 
     /// Destructor
@@ -59,12 +59,16 @@ public:
         #endif
     }
 
-    /// Insert a cell to the container.
+    /// Insert a cell to the container. The extraction operator of the cell is stored in the arena of this container.
     iterator insert(cell_t p_cell)
     {
-        mpCells.insert(p_cell);
+        p_cell->SetExtractionOperatorArena(mpExtractionOperatorArena);
+        return mpCells.insert(p_cell).first;
     }
 
+    /// Get the arena storing the extraction operators of all the cells of this container
+    ExtractionOperatorArena::Pointer pExtractionOperatorArena() const {return mpExtractionOperatorArena;}
+
     /// Iterators
     iterator begin() {return mpCells.begin();}
     const_iterator begin() const {return mpCells.begin();}
@@ -110,6 +114,7 @@ public:
 private:
 
     cell_container_t mpCells;
+    ExtractionOperatorArena::Pointer mpExtractionOperatorArena;
 
 };
 
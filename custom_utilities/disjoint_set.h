@@ -0,0 +1,111 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 16 Oct 2026 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_DISJOINT_SET_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_DISJOINT_SET_H_INCLUDED
+
+// System includes
+#include <vector>
+#include <iostream>
+
+// External includes
+
+// Project includes
+#include "includes/define.h"
+
+namespace Kratos
+{
+
+/**
+ * Disjoint-set (union-find) over the elements 0, 1, ..., n-1, with union by size and path halving.
+ * Find and Union are amortized almost constant time.
+ */
+class DisjointSet
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(DisjointSet);
+
+    /// Default constructor
+    DisjointSet() : mNumberOfSets(0) {}
+
+    /// Constructor with the number of elements; each element is a set
+    DisjointSet(const std::size_t& n)
+    {
+        this->Initialize(n);
+    }
+
+    /// Destructor
+    virtual ~DisjointSet() {}
+
+    /// Reset to n singleton sets
+    void Initialize(const std::size_t& n)
+    {
+        mParent.resize(n);
+        mSize.assign(n, 1);
+        for (std::size_t i = 0; i < n; ++i)
+            mParent[i] = i;
+        mNumberOfSets = n;
+    }
+
+    /// Get the number of elements
+    std::size_t size() const {return mParent.size();}
+
+    /// Get the number of disjoint sets
+    std::size_t NumberOfSets() const {return mNumberOfSets;}
+
+    /// Find the representative of the set containing i
+    std::size_t Find(std::size_t i)
+    {
+        while (mParent[i] != i)
+        {
+            mParent[i] = mParent[mParent[i]];
+            i = mParent[i];
+        }
+        return i;
+    }
+
+    /// Merge the sets containing i and j. Return false if they are already in the same set.
+    bool Union(const std::size_t& i, const std::size_t& j)
+    {
+        std::size_t ri = this->Find(i);
+        std::size_t rj = this->Find(j);
+        if (ri == rj)
+            return false;
+
+        if (mSize[ri] < mSize[rj])
+            std::swap(ri, rj);
+        mParent[rj] = ri;
+        mSize[ri] += mSize[rj];
+        --mNumberOfSets;
+        return true;
+    }
+
+    /// Information
+    void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "DisjointSet: " << mParent.size() << " elements, " << mNumberOfSets << " sets";
+    }
+
+private:
+
+    std::vector<std::size_t> mParent;
+    std::vector<std::size_t> mSize; // size of the set, valid for the representatives
+    std::size_t mNumberOfSets;
+};
+
+/// output stream function
+inline std::ostream& operator <<(std::ostream& rOStream, const DisjointSet& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_DISJOINT_SET_H_INCLUDED
@@ -0,0 +1,242 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 16 Oct 2026 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_EQUATION_ORDERING_UTILITY_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_EQUATION_ORDERING_UTILITY_H_INCLUDED
+
+// System includes
+#include <vector>
+#include <algorithm>
+
+// External includes
+
+// Project includes
+#include "includes/define.h"
+
+namespace Kratos
+{
+
+/**
+ * Utility to reorder the equations of a sparse system in order to reduce the bandwidth.
+ * The graph of the equations is given in CSR format, i.e. the neighbours of i are colInd[rowPtr[i]], ..., colInd[rowPtr[i+1]-1].
+ * The graph shall be symmetric.
+ */
+class EquationOrderingUtility
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(EquationOrderingUtility);
+
+    /// Build the graph from the lists of mutually connected equations, e.g. the anchors of each cell
+    /// The rows are built in two passes (count, then fill) from the lists containing each equation, hence the memory is
+    /// proportional to the size of the lists and of the graph.
+    /// @param n the number of equations
+    /// @param rConnectivities the lists of equations; the equations in the same list are connected to each other
+    static void CreateGraph(const std::size_t& n, const std::vector<std::vector<std::size_t> >& rConnectivities,
+        std::vector<std::size_t>& rowPtr, std::vector<std::size_t>& colInd)
+    {
+        // the lists containing each equation, in CSR format
+        std::vector<std::size_t> listPtr(n + 1, 0), listInd;
+        for (std::size_t c = 0; c < rConnectivities.size(); ++c)
+            for (std::size_t i = 0; i < rConnectivities[c].size(); ++i)
+                if (rConnectivities[c][i] < n)
+                    ++listPtr[rConnectivities[c][i] + 1];
+        for (std::size_t i = 0; i < n; ++i)
+            listPtr[i + 1] += listPtr[i];
+
+        listInd.resize(listPtr[n]);
+        std::vector<std::size_t> pos(listPtr.begin(), listPtr.end() - 1);
+        for (std::size_t c = 0; c < rConnectivities.size(); ++c)
+            for (std::size_t i = 0; i < rConnectivities[c].size(); ++i)
+                if (rConnectivities[c][i] < n)
+                    listInd[pos[rConnectivities[c][i]]++] = c;
+        std::vector<std::size_t>().swap(pos);
+
+        // count the distinct neighbours of each equation; marker[j] == i if j is already taken in the row i
+        std::vector<std::size_t> marker(n, n);
+        rowPtr.assign(n + 1, 0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t k = listPtr[i]; k < listPtr[i + 1]; ++k)
+            {
+                const std::vector<std::size_t>& conn = rConnectivities[listInd[k]];
+                for (std::size_t l = 0; l < conn.size(); ++l)
+                {
+                    const std::size_t j = conn[l];
+                    if ((j < n) && (j != i) && (marker[j] != i))
+                    {
+                        marker[j] = i;
+                        ++rowPtr[i + 1];
+                    }
+                }
+            }
+            rowPtr[i + 1] += rowPtr[i];
+        }
+
+        // fill the rows
+        marker.assign(n, n);
+        colInd.resize(rowPtr[n]);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            std::size_t cnt = rowPtr[i];
+            for (std::size_t k = listPtr[i]; k < listPtr[i + 1]; ++k)
+            {
+                const std::vector<std::size_t>& conn = rConnectivities[listInd[k]];
+                for (std::size_t l = 0; l < conn.size(); ++l)
+                {
+                    const std::size_t j = conn[l];
+                    if ((j < n) && (j != i) && (marker[j] != i))
+                    {
+                        marker[j] = i;
+                        colInd[cnt++] = j;
+                    }
+                }
+            }
+            std::sort(colInd.begin() + rowPtr[i], colInd.begin() + rowPtr[i + 1]);
+        }
+    }
+
+    /// Compute the reverse Cuthill-McKee ordering of the graph
+    /// @param rPermutation the new index of each equation, i.e. equation i becomes rPermutation[i]
+    static void ReverseCuthillMcKee(const std::vector<std::size_t>& rowPtr, const std::vector<std::size_t>& colInd,
+        std::vector<std::size_t>& rPermutation)
+    {
+        const std::size_t n = rowPtr.size() - 1;
+
+        std::vector<std::size_t> degree(n);
+        for (std::size_t i = 0; i < n; ++i)
+            degree[i] = rowPtr[i + 1] - rowPtr[i];
+
+        // the equations sorted by degree, to select the starting equation of each connected component
+        std::vector<std::size_t> by_degree(n);
+        for (std::size_t i = 0; i < n; ++i)
+            by_degree[i] = i;
+        std::stable_sort(by_degree.begin(), by_degree.end(), DegreeLess(degree));
+
+        std::vector<std::size_t> order;
+        order.reserve(n);
+        std::vector<bool> is_numbered(n, false);
+        std::vector<std::size_t> level_stamp(n, 0);
+        std::size_t stamp = 0;
+        std::vector<std::size_t> neighbours;
+
+        for (std::size_t s = 0; s < n; ++s)
+        {
+            if (is_numbered[by_degree[s]])
+                continue;
+
+            const std::size_t root = FindPseudoPeripheral(by_degree[s], rowPtr, colInd, degree, is_numbered, level_stamp, stamp);
+
+            // Cuthill-McKee: breadth-first search, visiting the neighbours by increasing degree
+            std::size_t head = order.size();
+            order.push_back(root);
+            is_numbered[root] = true;
+            while (head < order.size())
+            {
+                const std::size_t i = order[head++];
+
+                neighbours.clear();
+                for (std::size_t k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+                    if (!is_numbered[colInd[k]])
+                        neighbours.push_back(colInd[k]);
+                std::stable_sort(neighbours.begin(), neighbours.end(), DegreeLess(degree));
+
+                for (std::size_t k = 0; k < neighbours.size(); ++k)
+                {
+                    is_numbered[neighbours[k]] = true;
+                    order.push_back(neighbours[k]);
+                }
+            }
+        }
+
+        // reverse the ordering
+        rPermutation.resize(n);
+        for (std::size_t k = 0; k < n; ++k)
+            rPermutation[order[k]] = n - 1 - k;
+    }
+
+    /// Compute the bandwidth of the graph with the given permutation of the equations. An empty permutation means the identity.
+    static std::size_t Bandwidth(const std::vector<std::size_t>& rowPtr, const std::vector<std::size_t>& colInd,
+        const std::vector<std::size_t>& rPermutation)
+    {
+        std::size_t bandwidth = 0;
+        for (std::size_t i = 0; i < rowPtr.size() - 1; ++i)
+        {
+            const std::size_t pi = rPermutation.empty() ? i : rPermutation[i];
+            for (std::size_t k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+            {
+                const std::size_t pj = rPermutation.empty() ? colInd[k] : rPermutation[colInd[k]];
+                bandwidth = std::max(bandwidth, (pi > pj) ? pi - pj : pj - pi);
+            }
+        }
+        return bandwidth;
+    }
+
+private:
+
+    struct DegreeLess
+    {
+        DegreeLess(const std::vector<std::size_t>& rDegree) : mrDegree(rDegree) {}
+        bool operator() (const std::size_t& i, const std::size_t& j) const {return mrDegree[i] < mrDegree[j];}
+        const std::vector<std::size_t>& mrDegree;
+    };
+
+    /// Find a pseudo-peripheral equation of the connected component of root (George-Liu algorithm), among the equations not numbered yet
+    static std::size_t FindPseudoPeripheral(std::size_t root,
+        const std::vector<std::size_t>& rowPtr, const std::vector<std::size_t>& colInd,
+        const std::vector<std::size_t>& degree, const std::vector<bool>& is_numbered,
+        std::vector<std::size_t>& level_stamp, std::size_t& stamp)
+    {
+        std::vector<std::size_t> queue, last_level;
+        std::size_t eccentricity = 0;
+
+        for (int iter = 0; iter < 8; ++iter)
+        {
+            // breadth-first search from root, keeping the last level
+            ++stamp;
+            queue.assign(1, root);
+            level_stamp[root] = stamp;
+            std::size_t head = 0, number_of_levels = 0;
+            while (head < queue.size())
+            {
+                const std::size_t level_end = queue.size();
+                last_level.assign(queue.begin() + head, queue.end());
+                for (; head < level_end; ++head)
+                {
+                    const std::size_t i = queue[head];
+                    for (std::size_t k = rowPtr[i]; k < rowPtr[i + 1]; ++k)
+                    {
+                        const std::size_t j = colInd[k];
+                        if (!is_numbered[j] && (level_stamp[j] != stamp))
+                        {
+                            level_stamp[j] = stamp;
+                            queue.push_back(j);
+                        }
+                    }
+                }
+                ++number_of_levels;
+            }
+
+            if ((iter > 0) && (number_of_levels <= eccentricity))
+                break;
+            eccentricity = number_of_levels;
+
+            // restart from the equation of minimum degree in the last level
+            const std::size_t next = *std::min_element(last_level.begin(), last_level.end(), DegreeLess(degree));
+            if (next == root)
+                break;
+            root = next;
+        }
+
+        return root;
+    }
+};
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_EQUATION_ORDERING_UTILITY_H_INCLUDED
@@ -0,0 +1,410 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 16 Oct 2026 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_EXTRACTION_OPERATOR_ARENA_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_EXTRACTION_OPERATOR_ARENA_H_INCLUDED
+
+// System includes
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+// External includes
+#include <omp.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/functional/hash.hpp>
+
+// Project includes
+#include "includes/define.h"
+#include "includes/ublas_interface.h"
+#include "custom_utilities/extraction_operator_pool.h"
+
+namespace Kratos
+{
+
+/**
+ * Storage of the rows of the Bezier extraction operators of a collection of cells, in one arena.
+ * Each row is stored as (length, column indices, values) of its nonzeros; identical rows, up to a tolerance, are stored once.
+ * The cells keep the indices of their rows in the arena, and release them when they do not need them anymore. The rows are
+ * reference counted; the index of a released row is reused, and the storage of the released rows is reclaimed by compacting
+ * the arena when they make up more than half of it. The index of a row does not change during its lifetime.
+ * The dense extraction operator of a cell is also provided by the arena, from the indices of its rows. The cells having the same
+ * rows get the same operator, which is then shared with the geometries created from them. The operator keeps its rows alive.
+ * Adding and releasing rows is thread-safe. Reading rows must not overlap with adding rows, because the arrays may be reallocated or compacted.
+ */
+class ExtractionOperatorArena
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(ExtractionOperatorArena);
+
+    /// Type definitions
+    typedef std::size_t IndexType;
+    typedef std::map<std::size_t, std::vector<IndexType> > MapType;
+    typedef boost::shared_ptr<const Matrix> OperatorPointerType;
+    typedef boost::weak_ptr<const Matrix> OperatorWeakPointerType;
+    typedef std::map<std::vector<IndexType>, OperatorWeakPointerType> OperatorMapType;
+
+    /// View on a row of the arena. The view is invalidated when new rows are added to the arena.
+    struct RowView
+    {
+        std::size_t Size; // length of the dense row
+        std::size_t NumberOfNonzeros;
+        const IndexType* Indices;
+        const double* Values;
+    };
+
+    /// Default constructor
+    ExtractionOperatorArena() : mTolerance(1.0e-10), mNumberOfReleasedNonzeros(0)
+    {
+        omp_init_lock(&mLock);
+    }
+
+    /// Destructor
+    virtual ~ExtractionOperatorArena()
+    {
+        omp_destroy_lock(&mLock);
+    }
+
+    /// Set the tolerance to identify the equal rows
+    void SetTolerance(const double& Tolerance) {mTolerance = Tolerance;}
+
+    /// Add a row to the arena and return its index. If an equal row exists in the arena, its index is returned.
+    /// Each call takes a reference to the row, which must be given back by ReleaseRow.
+    IndexType AddRow(const Vector& Crow)
+    {
+        // hash the row on its nonzeros
+        const double quantum = 1.0e3 * mTolerance;
+        std::size_t hash = 0;
+        boost::hash_combine(hash, Crow.size());
+        for (std::size_t i = 0; i < Crow.size(); ++i)
+        {
+            if (Crow[i] != 0.0)
+            {
+                boost::hash_combine(hash, i);
+                ExtractionOperatorPoolHelper::HashCombine(hash, Crow[i], quantum);
+            }
+        }
+
+        omp_set_lock(&mLock);
+
+        std::vector<IndexType>& rBucket = mRowMap[hash];
+
+        IndexType row = 0;
+        bool found = false;
+        for (std::size_t k = 0; k < rBucket.size(); ++k)
+        {
+            if (this->IsEqual(rBucket[k], Crow))
+            {
+                row = rBucket[k];
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            if (2 * mNumberOfReleasedNonzeros > mValues.size())
+                this->CompactUnlocked();
+
+            if (mFreeRows.empty())
+            {
+                row = mRowLengths.size();
+                mRowOffsets.push_back(0);
+                mRowNumberOfNonzeros.push_back(0);
+                mRowLengths.push_back(0);
+                mRowReferences.push_back(0);
+                mRowHashes.push_back(0);
+            }
+            else
+            {
+                row = mFreeRows.back();
+                mFreeRows.pop_back();
+            }
+
+            mRowOffsets[row] = mValues.size();
+            for (std::size_t i = 0; i < Crow.size(); ++i)
+            {
+                if (Crow[i] != 0.0)
+                {
+                    mColumnIndices.push_back(i);
+                    mValues.push_back(Crow[i]);
+                }
+            }
+            mRowNumberOfNonzeros[row] = mValues.size() - mRowOffsets[row];
+            mRowLengths[row] = Crow.size();
+            mRowHashes[row] = hash;
+            rBucket.push_back(row);
+        }
+
+        ++mRowReferences[row];
+
+        omp_unset_lock(&mLock);
+
+        return row;
+    }
+
+    /// Take one more reference to a row
+    void RetainRow(const IndexType& Row)
+    {
+        omp_set_lock(&mLock);
+        ++mRowReferences[Row];
+        omp_unset_lock(&mLock);
+    }
+
+    /// Give back a reference to a row. The row is removed from the arena when it is not referred anymore.
+    void ReleaseRow(const IndexType& Row)
+    {
+        omp_set_lock(&mLock);
+        this->ReleaseRowUnlocked(Row);
+        omp_unset_lock(&mLock);
+    }
+
+    /// Give back a reference to each row of the list
+    void ReleaseRows(const std::vector<IndexType>& Rows)
+    {
+        if (Rows.empty())
+            return;
+
+        omp_set_lock(&mLock);
+        for (std::size_t i = 0; i < Rows.size(); ++i)
+            this->ReleaseRowUnlocked(Rows[i]);
+        omp_unset_lock(&mLock);
+    }
+
+    /// Get the dense extraction operators of several lists of rows at once, taking the lock one time. The matrix Operators[i] made of
+    /// the rows RowsList[i] is built by the caller beforehand, e.g. concurrently; it is taken over by the arena, or deleted if an operator
+    /// of the same rows is alive already. On return, rSharedOperators[i] is the operator shared by all the callers asking for RowsList[i].
+    static void MergeOperators(ExtractionOperatorArena::Pointer pArena, const std::vector<const std::vector<IndexType>*>& RowsList,
+            const std::vector<Matrix*>& Operators, std::vector<OperatorPointerType>& rSharedOperators)
+    {
+        rSharedOperators.resize(RowsList.size());
+
+        omp_set_lock(&pArena->mLock);
+        for (std::size_t i = 0; i < RowsList.size(); ++i)
+        {
+            OperatorWeakPointerType& rEntry = pArena->mOperators[*RowsList[i]];
+            OperatorPointerType pOperator = rEntry.lock();
+            if (pOperator)
+                delete Operators[i];
+            else
+            {
+                pOperator = pArena->AdoptOperatorUnlocked(pArena, *RowsList[i], Operators[i]);
+                rEntry = pOperator;
+            }
+            rSharedOperators[i] = pOperator;
+        }
+        omp_unset_lock(&pArena->mLock);
+    }
+
+    /// Get the number of (distinct) rows alive in the arena
+    std::size_t NumberOfRows() const {return mRowLengths.size() - mFreeRows.size();}
+
+    /// Get the number of nonzeros of the rows alive in the arena
+    std::size_t NumberOfNonzeros() const {return mValues.size() - mNumberOfReleasedNonzeros;}
+
+    /// Get the length of the dense row
+    std::size_t RowSize(const IndexType& Row) const {return mRowLengths[Row];}
+
+    /// Get the view on a row
+    RowView GetRowView(const IndexType& Row) const
+    {
+        RowView view;
+        view.Size = mRowLengths[Row];
+        view.NumberOfNonzeros = mRowNumberOfNonzeros[Row];
+        view.Indices = view.NumberOfNonzeros ? &mColumnIndices[mRowOffsets[Row]] : NULL;
+        view.Values = view.NumberOfNonzeros ? &mValues[mRowOffsets[Row]] : NULL;
+        return view;
+    }
+
+    /// Get the dense row
+    void GetRow(const IndexType& Row, Vector& rCrow) const
+    {
+        if (rCrow.size() != mRowLengths[Row])
+            rCrow.resize(mRowLengths[Row], false);
+        noalias(rCrow) = ZeroVector(mRowLengths[Row]);
+        for (IndexType k = mRowOffsets[Row]; k < mRowOffsets[Row] + mRowNumberOfNonzeros[Row]; ++k)
+            rCrow[mColumnIndices[k]] = mValues[k];
+    }
+
+    /// Get the memory used by the arena, in bytes
+    std::size_t MemorySize() const
+    {
+        return (mRowOffsets.capacity() + mRowNumberOfNonzeros.capacity() + mColumnIndices.capacity() + mFreeRows.capacity()) * sizeof(IndexType)
+             + mValues.capacity() * sizeof(double)
+             + (mRowLengths.capacity() + mRowReferences.capacity() + mRowHashes.capacity()) * sizeof(std::size_t);
+    }
+
+    /// Remove the storage of the released rows. The indices of the rows alive are not changed, but the views are invalidated.
+    void Compact()
+    {
+        omp_set_lock(&mLock);
+        this->CompactUnlocked();
+        omp_unset_lock(&mLock);
+    }
+
+    /// Clear the arena. The row indices kept by the cells are invalidated.
+    void Clear()
+    {
+        omp_set_lock(&mLock);
+        mRowOffsets.clear();
+        mRowNumberOfNonzeros.clear();
+        mColumnIndices.clear();
+        mValues.clear();
+        mRowLengths.clear();
+        mRowReferences.clear();
+        mRowHashes.clear();
+        mFreeRows.clear();
+        mRowMap.clear();
+        mOperators.clear();
+        mNumberOfReleasedNonzeros = 0;
+        omp_unset_lock(&mLock);
+    }
+
+    /// Information
+    void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "ExtractionOperatorArena: " << NumberOfRows() << " rows, " << NumberOfNonzeros() << " nonzeros";
+    }
+
+private:
+
+    double mTolerance;
+    std::vector<IndexType> mRowOffsets; // the nonzeros of row i are in [mRowOffsets[i], mRowOffsets[i] + mRowNumberOfNonzeros[i])
+    std::vector<IndexType> mRowNumberOfNonzeros;
+    std::vector<IndexType> mColumnIndices;
+    std::vector<double> mValues;
+    std::vector<std::size_t> mRowLengths; // length of each dense row
+    std::vector<std::size_t> mRowReferences; // number of references to each row, zero if the row is released
+    std::vector<std::size_t> mRowHashes; // hash of each row, to remove it from mRowMap
+    std::vector<IndexType> mFreeRows; // indices of the released rows, to be reused
+    std::size_t mNumberOfReleasedNonzeros; // storage of the released rows, reclaimed by Compact
+    MapType mRowMap; // map from the hash of the row to the rows having that hash
+    OperatorMapType mOperators; // dense operators alive, by their rows
+    omp_lock_t mLock;
+
+    /// Destruction of a dense operator: its rows are given back to the arena
+    struct OperatorDeleter
+    {
+        ExtractionOperatorArena::Pointer pArena;
+        std::vector<IndexType> Rows;
+
+        void operator()(const Matrix* pOperator)
+        {
+            omp_set_lock(&pArena->mLock);
+            OperatorMapType::iterator it = pArena->mOperators.find(Rows);
+            if ((it != pArena->mOperators.end()) && it->second.expired())
+                pArena->mOperators.erase(it);
+            for (std::size_t i = 0; i < Rows.size(); ++i)
+                pArena->ReleaseRowUnlocked(Rows[i]);
+            omp_unset_lock(&pArena->mLock);
+            delete pOperator;
+        }
+    };
+
+    /// The arena is not copyable, the cells refer to it by pointer
+    ExtractionOperatorArena(const ExtractionOperatorArena& rOther);
+    ExtractionOperatorArena& operator=(const ExtractionOperatorArena& rOther);
+
+    /// Take over the dense operator made of the rows, taking a reference to them. The lock must be held.
+    OperatorPointerType AdoptOperatorUnlocked(ExtractionOperatorArena::Pointer pArena, const std::vector<IndexType>& Rows, Matrix* pOperator)
+    {
+        for (std::size_t i = 0; i < Rows.size(); ++i)
+            ++mRowReferences[Rows[i]];
+
+        OperatorDeleter deleter;
+        deleter.pArena = pArena;
+        deleter.Rows = Rows;
+        return OperatorPointerType(pOperator, deleter);
+    }
+
+    /// Move the rows alive to the front of the storage. The lock must be held.
+    void CompactUnlocked()
+    {
+        if (mNumberOfReleasedNonzeros == 0)
+            return;
+
+        std::vector<IndexType> column_indices;
+        std::vector<double> values;
+        column_indices.reserve(mValues.size() - mNumberOfReleasedNonzeros);
+        values.reserve(mValues.size() - mNumberOfReleasedNonzeros);
+        for (IndexType row = 0; row < mRowLengths.size(); ++row)
+        {
+            const IndexType offset = values.size();
+            if (mRowReferences[row] != 0)
+            {
+                column_indices.insert(column_indices.end(), mColumnIndices.begin() + mRowOffsets[row],
+                        mColumnIndices.begin() + mRowOffsets[row] + mRowNumberOfNonzeros[row]);
+                values.insert(values.end(), mValues.begin() + mRowOffsets[row],
+                        mValues.begin() + mRowOffsets[row] + mRowNumberOfNonzeros[row]);
+            }
+            mRowOffsets[row] = offset;
+        }
+
+        mColumnIndices.swap(column_indices);
+        mValues.swap(values);
+        mNumberOfReleasedNonzeros = 0;
+    }
+
+    /// Give back a reference to a row. The lock must be held.
+    void ReleaseRowUnlocked(const IndexType& Row)
+    {
+        if ((Row >= mRowReferences.size()) || (mRowReferences[Row] == 0))
+            return;
+
+        if (--mRowReferences[Row] != 0)
+            return;
+
+        MapType::iterator it = mRowMap.find(mRowHashes[Row]);
+        if (it != mRowMap.end())
+        {
+            std::vector<IndexType>& rBucket = it->second;
+            rBucket.erase(std::remove(rBucket.begin(), rBucket.end(), Row), rBucket.end());
+            if (rBucket.empty())
+                mRowMap.erase(it);
+        }
+
+        mNumberOfReleasedNonzeros += mRowNumberOfNonzeros[Row];
+        mRowNumberOfNonzeros[Row] = 0;
+        mRowLengths[Row] = 0;
+        mFreeRows.push_back(Row);
+    }
+
+    /// Compare a stored row with a dense row
+    bool IsEqual(const IndexType& Row, const Vector& Crow) const
+    {
+        if (mRowLengths[Row] != Crow.size())
+            return false;
+
+        IndexType k = mRowOffsets[Row];
+        const IndexType k_end = k + mRowNumberOfNonzeros[Row];
+        for (std::size_t i = 0; i < Crow.size(); ++i)
+        {
+            double v = 0.0;
+            if (k < k_end && mColumnIndices[k] == i)
+                v = mValues[k++];
+            if (std::fabs(v - Crow[i]) > mTolerance)
+                return false;
+        }
+        return true;
+    }
+};
+
+/// output stream function
+inline std::ostream& operator <<(std::ostream& rOStream, const ExtractionOperatorArena& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_EXTRACTION_OPERATOR_ARENA_H_INCLUDED
@@ -0,0 +1,203 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 2026-10-16 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_EXTRACTION_OPERATOR_POOL_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_EXTRACTION_OPERATOR_POOL_H_INCLUDED
+
+// System includes
+#include <map>
+#include <vector>
+#include <cmath>
+#include <iostream>
+
+// External includes
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/functional/hash.hpp>
+
+// Project includes
+#include "includes/define.h"
+#include "includes/ublas_interface.h"
+
+
+namespace Kratos
+{
+
+/**
+ * Content functions of the containers to be stored in the ExtractionOperatorPool. The hash is computed on the values
+ * rounded to a quantum much larger than the comparison tolerance, such that values equal up to the tolerance have the
+ * same hash except in the rare case they are on the two sides of a rounding boundary; in that case the operator is just
+ * stored twice.
+ */
+struct ExtractionOperatorPoolHelper
+{
+    static inline void HashCombine(std::size_t& rSeed, const double& v, const double& Quantum)
+    {
+        boost::hash_combine(rSeed, static_cast<long long>(std::floor(v / Quantum + 0.5)));
+    }
+
+    static std::size_t Hash(const Matrix& rA, const double& Quantum)
+    {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, rA.size1());
+        boost::hash_combine(seed, rA.size2());
+        for(std::size_t i = 0; i < rA.size1(); ++i)
+            for(std::size_t j = 0; j < rA.size2(); ++j)
+                HashCombine(seed, rA(i, j), Quantum);
+        return seed;
+    }
+
+    static bool IsEqual(const Matrix& rA, const Matrix& rB, const double& Tolerance)
+    {
+        if(rA.size1() != rB.size1() || rA.size2() != rB.size2())
+            return false;
+        for(std::size_t i = 0; i < rA.size1(); ++i)
+            for(std::size_t j = 0; j < rA.size2(); ++j)
+                if(std::fabs(rA(i, j) - rB(i, j)) > Tolerance)
+                    return false;
+        return true;
+    }
+};
+
+/**
+ * Pool of extraction operators shared between the geometries which are given their operator as a plain matrix.
+ * The geometries created from cells do not go through the pool, they share the operator of the cell instead (see MultiPatchModelPart::GetExtractionOperators).
+ * The 1D extraction operators of the tensor-product cells are also taken from the pool, see BSplinesFESpace::ConstructCellManager.
+ * Identical operators, up to a tolerance, are stored once. The pool only keeps weak references, hence an operator is
+ * released when the last geometry pointing to it is destroyed.
+ * The pool is thread-safe.
+ */
+template<class TContainerType>
+class ExtractionOperatorPool
+{
+public:
+    /// Type definitions
+    typedef boost::shared_ptr<const TContainerType> PointerType;
+    typedef boost::weak_ptr<const TContainerType> WeakPointerType;
+    typedef std::map<std::size_t, std::vector<WeakPointerType> > MapType;
+
+    /// Get the shared instance of an operator. If no equal operator exists in the pool, a copy of rOperator is added.
+    static PointerType Intern(const TContainerType& rOperator, const double& Tolerance = 1.0e-10)
+    {
+        const std::size_t hash = ExtractionOperatorPoolHelper::Hash(rOperator, 1.0e3 * Tolerance);
+
+        PointerType pOperator;
+        #pragma omp critical(ExtractionOperatorPool_Intern)
+        {
+            ++Statistics().NumberOfRequests;
+
+            std::vector<WeakPointerType>& rBucket = GetMap()[hash];
+            for(std::size_t i = 0; i < rBucket.size(); ++i)
+            {
+                PointerType pExisting = rBucket[i].lock();
+                if(pExisting && ExtractionOperatorPoolHelper::IsEqual(*pExisting, rOperator, Tolerance))
+                {
+                    pOperator = pExisting;
+                    ++Statistics().NumberOfHits;
+                    break;
+                }
+            }
+
+            if(!pOperator)
+            {
+                // reuse an expired slot if any
+                pOperator = PointerType(new TContainerType(rOperator));
+                bool inserted = false;
+                for(std::size_t i = 0; i < rBucket.size(); ++i)
+                {
+                    if(rBucket[i].expired())
+                    {
+                        rBucket[i] = pOperator;
+                        inserted = true;
+                        break;
+                    }
+                }
+                if(!inserted)
+                    rBucket.push_back(pOperator);
+            }
+        }
+
+        return pOperator;
+    }
+
+    /// Get the number of operators alive in the pool
+    static std::size_t Size()
+    {
+        std::size_t cnt = 0;
+        #pragma omp critical(ExtractionOperatorPool_Intern)
+        {
+            for(typename MapType::const_iterator it = GetMap().begin(); it != GetMap().end(); ++it)
+                for(std::size_t i = 0; i < it->second.size(); ++i)
+                    if(!it->second[i].expired())
+                        ++cnt;
+        }
+        return cnt;
+    }
+
+    /// Get the number of calls to Intern
+    static std::size_t NumberOfRequests() {return Statistics().NumberOfRequests;}
+
+    /// Get the number of calls to Intern which returned an existing operator
+    static std::size_t NumberOfHits() {return Statistics().NumberOfHits;}
+
+    /// Remove the released operators from the pool
+    static void Purge()
+    {
+        #pragma omp critical(ExtractionOperatorPool_Intern)
+        {
+            typename MapType::iterator it = GetMap().begin();
+            while(it != GetMap().end())
+            {
+                std::vector<WeakPointerType> alive;
+                for(std::size_t i = 0; i < it->second.size(); ++i)
+                    if(!it->second[i].expired())
+                        alive.push_back(it->second[i]);
+
+                if(alive.empty())
+                    GetMap().erase(it++);
+                else
+                {
+                    it->second.swap(alive);
+                    ++it;
+                }
+            }
+        }
+    }
+
+    /// Information
+    static void PrintInfo(std::ostream& rOStream)
+    {
+        rOStream << "ExtractionOperatorPool: " << Size() << " operators, "
+                 << NumberOfHits() << "/" << NumberOfRequests() << " requests shared";
+    }
+
+private:
+
+    struct StatisticsType
+    {
+        StatisticsType() : NumberOfRequests(0), NumberOfHits(0) {}
+        std::size_t NumberOfRequests;
+        std::size_t NumberOfHits;
+    };
+
+    static MapType& GetMap()
+    {
+        static MapType map;
+        return map;
+    }
+
+    static StatisticsType& Statistics()
+    {
+        static StatisticsType stats;
+        return stats;
+    }
+};
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_EXTRACTION_OPERATOR_POOL_H_INCLUDED
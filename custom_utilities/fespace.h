@@ -160,6 +160,93 @@ public:
         KRATOS_THROW_ERROR(std::logic_error, "Calling base class function", __FUNCTION__)
     }
 
+    ///////////////
+
+    /// Get the values of the basis functions which are nonzero at point xi
+    /// local_ids[k] is the local index (as in GetValue(values, xi)) of the k-th returned function and values[k] its value
+    /// The derived FESpace shall override this function to avoid the evaluation of all the basis functions
+    virtual void GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& values, const std::vector<double>& xi) const
+    {
+        std::vector<double> all_values;
+        this->GetValue(all_values, xi);
+
+        local_ids.clear();
+        values.clear();
+        for (std::size_t i = 0; i < all_values.size(); ++i)
+        {
+            if (all_values[i] != 0.0)
+            {
+                local_ids.push_back(i);
+                values.push_back(all_values[i]);
+            }
+        }
+    }
+
+    /// Get the values and derivatives of the basis functions which are nonzero at point xi
+    /// the output derivatives has the form of derivatives[k][dim_index], k being the position in local_ids
+    /// The derived FESpace shall override this function to avoid the evaluation of all the basis functions
+    virtual void GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+            std::vector<std::vector<double> >& derivatives, const std::vector<double>& xi) const
+    {
+        std::vector<double> all_values;
+        std::vector<std::vector<double> > all_derivatives;
+        this->GetValueAndDerivative(all_values, all_derivatives, xi);
+
+        local_ids.clear();
+        values.clear();
+        derivatives.clear();
+        for (std::size_t i = 0; i < all_values.size(); ++i)
+        {
+            bool is_nonzero = (all_values[i] != 0.0);
+            for (std::size_t dim = 0; dim < all_derivatives[i].size(); ++dim)
+                is_nonzero = is_nonzero || (all_derivatives[i][dim] != 0.0);
+
+            if (is_nonzero)
+            {
+                local_ids.push_back(i);
+                values.push_back(all_values[i]);
+                derivatives.push_back(all_derivatives[i]);
+            }
+        }
+    }
+
+    ///////////////
+
+    /// Check if the basis functions are tensor products of univariate functions (possibly weighted, see Weights()).
+    /// In this case, the local index of the basis function (i_0, i_1, ...) is i_0 + n_0*(i_1 + n_1*(i_2 + ...)),
+    /// n_d being the number of univariate functions in direction d
+    virtual bool IsTensorProduct() const
+    {
+        return false;
+    }
+
+    /// Get the number of univariate functions in direction dim; only for tensor product FESpace
+    virtual std::size_t UnivariateNumber(const std::size_t& dim) const
+    {
+        KRATOS_THROW_ERROR(std::logic_error, "Calling base class function", __FUNCTION__)
+    }
+
+    /// Get the values and derivatives of the univariate functions in direction dim which are nonzero at coordinate t;
+    /// their univariate indices are start, start+1, ...; only for tensor product FESpace
+    virtual void GetUnivariateNonzeroValueAndDerivative(std::size_t& start, std::vector<double>& values,
+            std::vector<double>& derivatives, const std::size_t& dim, const double& t) const
+    {
+        KRATOS_THROW_ERROR(std::logic_error, "Calling base class function", __FUNCTION__)
+    }
+
+    /// Get the weights of the basis functions if the FESpace is a rational one; NULL otherwise
+    virtual const std::vector<double>* pWeights() const
+    {
+        return NULL;
+    }
+
+    /// Get the local knot vectors of the basis function with local index i, which identify the function in the FESpace.
+    /// Return false if the FESpace does not provide them.
+    virtual bool GetLocalKnotVectors(const std::size_t& i, std::vector<std::vector<double> >& rKnots) const
+    {
+        return false;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /// Reset all the dof numbers for each grid function to -1.
@@ -326,6 +413,16 @@ public:
         KRATOS_THROW_ERROR(std::logic_error, "Calling base class function", __FUNCTION__)
     }
 
+    /// Append the equation ids of the basis functions supported on each cell of the FESpace, e.g. to build the graph of the equations.
+    /// By default, the anchors of the cells from ConstructCellManager are taken. The derived FESpace shall provide them without
+    /// constructing the cells if it can.
+    virtual void GetCellSupports(std::vector<std::vector<std::size_t> >& rSupports) const
+    {
+        cell_container_t::Pointer pCellManager = this->ConstructCellManager();
+        for (cell_container_t::iterator it_cell = pCellManager->begin(); it_cell != pCellManager->end(); ++it_cell)
+            rSupports.push_back((*it_cell)->GetSupportedAnchors());
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /// Overload assignment operator
@@ -11,17 +11,31 @@
 
 // System includes
 #include <vector>
+#include <string>
+#include <algorithm>
 
 // External includes
 
 // Project includes
 #include "includes/define.h"
+#include "utilities/openmp_utils.h"
 #include "custom_utilities/fespace.h"
 #include "custom_utilities/control_grid.h"
 
 namespace Kratos
 {
 
+/**
+ * Scratch buffers for the sparse evaluation of the basis functions. The caller may keep one instance (per thread) and
+ * pass it to the GridFunction evaluations, so that repeated evaluations do not allocate.
+ */
+struct GridFunctionBuffer
+{
+    std::vector<std::size_t> local_ids;
+    std::vector<double> values;
+    std::vector<std::vector<double> > derivatives;
+};
+
 template<int TDim, typename TDataType>
 struct GridFunction_GetDerivative_Helper
 {
@@ -32,31 +46,37 @@ struct GridFunction_GetDerivative_Helper
     static void GetDerivative(std::vector<TDataType>& dv, const TCoordinatesType& xi,
         const FESpaceType& rFESpace, const ControlGridType& r_control_grid)
     {
-        // firstly get the values and derivatives of all the basis functions
-        std::vector<std::vector<double> > f_derivatives;
-        rFESpace.GetDerivative(f_derivatives, xi);
-
-        // rFESpace.PrintInfo(std::cout); std::cout << std::endl;
+        GridFunctionBuffer buffer;
+        GetDerivative(dv, xi, rFESpace, r_control_grid, buffer);
+    }
 
-        // for (int i = 0; i < f_derivatives.size(); ++i)
-        // {
-        //     std::cout << "f_derivatives[" << i << "]:";
-        //     for (int j = 0; j < f_derivatives[i].size(); ++j)
-        //         std::cout << " " << f_derivatives[i][j];
-        //     std::cout << std::endl;
-        // }
+    template<typename TCoordinatesType>
+    static void GetDerivative(std::vector<TDataType>& dv, const TCoordinatesType& xi,
+        const FESpaceType& rFESpace, const ControlGridType& r_control_grid, GridFunctionBuffer& buffer)
+    {
+        // firstly get the values and derivatives of the nonzero basis functions
+        rFESpace.GetNonzeroValueAndDerivative(buffer.local_ids, buffer.values, buffer.derivatives, xi);
 
-        // then interpolate the derivative at local coordinates using the control values
+        // then interpolate the derivative at local coordinates using the supported control values
         if (dv.size() != TDim)
             dv.resize(TDim);
 
+        if (buffer.local_ids.size() == 0)
+        {
+            for (int dim = 0; dim < TDim; ++dim)
+                dv[dim] = 0.0 * r_control_grid.GetData(0);
+            return;
+        }
+
+        const TDataType c0 = r_control_grid.GetData(buffer.local_ids[0]);
         for (int dim = 0; dim < TDim; ++dim)
-            dv[dim] = f_derivatives[0][dim] * r_control_grid.GetData(0);
+            dv[dim] = buffer.derivatives[0][dim] * c0;
 
-        for (std::size_t i = 1; i < r_control_grid.size(); ++i)
+        for (std::size_t k = 1; k < buffer.local_ids.size(); ++k)
         {
+            const TDataType c = r_control_grid.GetData(buffer.local_ids[k]);
             for (int dim = 0; dim < TDim; ++dim)
-                dv[dim] += f_derivatives[i][dim] * r_control_grid.GetData(i);
+                dv[dim] += buffer.derivatives[k][dim] * c;
         }
     }
 };
@@ -116,16 +136,30 @@ public:
     template<typename TCoordinatesType>
     void GetValue(TDataType& v, const TCoordinatesType& xi) const
     {
-        // firstly get the values of all the basis functions
-        std::vector<double> f_values;
-        pFESpace()->GetValue(f_values, xi);
+        GridFunctionBuffer buffer;
+        this->GetValue(v, xi, buffer);
+    }
 
-        // then interpolate the value at local coordinates using the control values
+    /// Get the value of the grid at specific local coordinates, using the caller-provided scratch buffers
+    /// Only the control values supported at xi are used.
+    template<typename TCoordinatesType>
+    void GetValue(TDataType& v, const TCoordinatesType& xi, GridFunctionBuffer& buffer) const
+    {
+        // firstly get the values of the nonzero basis functions
+        pFESpace()->GetNonzeroValue(buffer.local_ids, buffer.values, xi);
+
+        // then interpolate the value at local coordinates using the supported control values
         const ControlGridType& r_control_grid = *pControlGrid();
 
-        v = f_values[0] * r_control_grid.GetData(0);
-        for (std::size_t i = 1; i < r_control_grid.size(); ++i)
-            v += f_values[i] * r_control_grid.GetData(i);
+        if (buffer.local_ids.size() == 0)
+        {
+            v = 0.0 * r_control_grid.GetData(0);
+            return;
+        }
+
+        v = buffer.values[0] * r_control_grid.GetData(buffer.local_ids[0]);
+        for (std::size_t k = 1; k < buffer.local_ids.size(); ++k)
+            v += buffer.values[k] * r_control_grid.GetData(buffer.local_ids[k]);
     }
 
     /// Get the value of the grid at specific local coordinates
@@ -149,6 +183,13 @@ public:
         GridFunction_GetDerivative_Helper<TDim, TDataType>::GetDerivative(dv, xi, *pFESpace(), *pControlGrid());
     }
 
+    /// Get the derivatives of the grid at specific local coordinates, using the caller-provided scratch buffers
+    template<typename TCoordinatesType>
+    void GetDerivative(std::vector<TDataType>& dv, const TCoordinatesType& xi, GridFunctionBuffer& buffer) const
+    {
+        GridFunction_GetDerivative_Helper<TDim, TDataType>::GetDerivative(dv, xi, *pFESpace(), *pControlGrid(), buffer);
+    }
+
     /// Get the derivatives of the grid at specific local coordinates
     /// The return values has the form: d_values(xi) / d_xi_0, d_values(xi) / d_xi_1, ...
     template<typename TCoordinatesType>
@@ -159,6 +200,42 @@ public:
         return dv;
     }
 
+    /// Get the values of the grid at a set of points. The points are grouped by coordinates, hence by knot span,
+    /// and evaluated in parallel. values[q] is the value at points[q].
+    template<typename TCoordinatesType>
+    void GetValues(std::vector<TDataType>& values, const std::vector<TCoordinatesType>& points) const
+    {
+        std::vector<TDataType> dummy;
+        this->EvaluatePoints(values, dummy, points, false);
+    }
+
+    /// Get the values and derivatives of the grid at a set of points.
+    /// values[q] is the value at points[q] and derivatives[q*TDim + dim] the derivative d_values / d_xi_dim at points[q].
+    /// The same remark as GetDerivative applies to the weighted data types.
+    template<typename TCoordinatesType>
+    void GetValuesAndDerivatives(std::vector<TDataType>& values, std::vector<TDataType>& derivatives,
+            const std::vector<TCoordinatesType>& points) const
+    {
+        this->EvaluatePoints(values, derivatives, points, true);
+    }
+
+    /// Get the values of the grid at the points of the tensor grid coordinates[0] x coordinates[1] x ...
+    /// The point (i_0, i_1, ...) has index q = i_0 + m_0*(i_1 + m_1*(i_2 + ...)), m_d being the size of coordinates[d].
+    /// For tensor product FESpace, the univariate basis functions are evaluated once per distinct coordinate.
+    void GetValuesOnGrid(std::vector<TDataType>& values, const std::vector<std::vector<double> >& coordinates) const
+    {
+        std::vector<TDataType> dummy;
+        this->EvaluateGrid(values, dummy, coordinates, false);
+    }
+
+    /// Get the values and derivatives of the grid at the points of the tensor grid coordinates[0] x coordinates[1] x ...
+    /// values[q] is the value at the point q and derivatives[q*TDim + dim] the derivative d_values / d_xi_dim at the point q.
+    void GetValuesAndDerivativesOnGrid(std::vector<TDataType>& values, std::vector<TDataType>& derivatives,
+            const std::vector<std::vector<double> >& coordinates) const
+    {
+        this->EvaluateGrid(values, derivatives, coordinates, true);
+    }
+
     /// Check the compatibility between the underlying control grid and fe space.
     bool Validate() const
     {
@@ -211,6 +288,263 @@ private:
     typename FESpaceType::Pointer mpFESpace;
     typename ControlGridType::Pointer mpControlGrid;
 
+    /// Lexicographic comparison of the points, the last direction being the most significant
+    template<typename TCoordinatesType>
+    struct PointCompare
+    {
+        PointCompare(const std::vector<TCoordinatesType>& points) : mrPoints(points) {}
+        bool operator() (const std::size_t& a, const std::size_t& b) const
+        {
+            for (int dim = TDim - 1; dim >= 0; --dim)
+            {
+                if (mrPoints[a][dim] < mrPoints[b][dim]) return true;
+                if (mrPoints[a][dim] > mrPoints[b][dim]) return false;
+            }
+            return false;
+        }
+        const std::vector<TCoordinatesType>& mrPoints;
+    };
+
+    /// Interpolate the value (and derivatives) from the nonzero basis functions in the buffer
+    void Interpolate(TDataType& v, TDataType* dv, const GridFunctionBuffer& buffer, const bool& with_derivatives) const
+    {
+        const ControlGridType& r_control_grid = *pControlGrid();
+
+        if (buffer.local_ids.size() == 0)
+        {
+            v = 0.0 * r_control_grid.GetData(0);
+            if (with_derivatives)
+                for (int dim = 0; dim < TDim; ++dim)
+                    dv[dim] = v;
+            return;
+        }
+
+        for (std::size_t k = 0; k < buffer.local_ids.size(); ++k)
+        {
+            const TDataType c = r_control_grid.GetData(buffer.local_ids[k]);
+            if (k == 0)
+            {
+                v = buffer.values[k] * c;
+                if (with_derivatives)
+                    for (int dim = 0; dim < TDim; ++dim)
+                        dv[dim] = buffer.derivatives[k][dim] * c;
+            }
+            else
+            {
+                v += buffer.values[k] * c;
+                if (with_derivatives)
+                    for (int dim = 0; dim < TDim; ++dim)
+                        dv[dim] += buffer.derivatives[k][dim] * c;
+            }
+        }
+    }
+
+    /// Evaluation at scattered points
+    template<typename TCoordinatesType>
+    void EvaluatePoints(std::vector<TDataType>& values, std::vector<TDataType>& derivatives,
+            const std::vector<TCoordinatesType>& points, const bool& with_derivatives) const
+    {
+        const std::size_t npoints = points.size();
+        if (values.size() != npoints)
+            values.resize(npoints);
+        if (with_derivatives && derivatives.size() != npoints*TDim)
+            derivatives.resize(npoints*TDim);
+
+        // group the points with the same coordinates, hence the same knot span
+        std::vector<std::size_t> order(npoints);
+        for (std::size_t q = 0; q < npoints; ++q)
+            order[q] = q;
+        std::sort(order.begin(), order.end(), PointCompare<TCoordinatesType>(points));
+
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(npoints, number_of_threads, partition);
+        std::vector<std::string> error_messages(number_of_threads);
+
+        const FESpaceType& rFESpace = *pFESpace();
+
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
+        {
+            try
+            {
+                GridFunctionBuffer buffer;
+                std::vector<double> xi(TDim);
+                for (std::size_t i = partition[k]; i < partition[k + 1]; ++i)
+                {
+                    const std::size_t q = order[i];
+                    for (int dim = 0; dim < TDim; ++dim)
+                        xi[dim] = points[q][dim];
+
+                    if (with_derivatives)
+                        rFESpace.GetNonzeroValueAndDerivative(buffer.local_ids, buffer.values, buffer.derivatives, xi);
+                    else
+                        rFESpace.GetNonzeroValue(buffer.local_ids, buffer.values, xi);
+
+                    this->Interpolate(values[q], with_derivatives ? &derivatives[q*TDim] : NULL, buffer, with_derivatives);
+                }
+            }
+            catch (std::exception& e)
+            {
+                error_messages[k] = e.what();
+            }
+        }
+
+        for (int k = 0; k < number_of_threads; ++k)
+            if (!error_messages[k].empty())
+                KRATOS_THROW_ERROR(std::runtime_error, error_messages[k], "")
+    }
+
+    /// Evaluation at the points of a tensor grid
+    void EvaluateGrid(std::vector<TDataType>& values, std::vector<TDataType>& derivatives,
+            const std::vector<std::vector<double> >& coordinates, const bool& with_derivatives) const
+    {
+        if (coordinates.size() != TDim)
+            KRATOS_THROW_ERROR(std::logic_error, "The number of coordinate arrays must be equal to the dimension", TDim)
+
+        std::size_t npoints = 1;
+        std::size_t m[TDim];
+        for (int dim = 0; dim < TDim; ++dim)
+        {
+            m[dim] = coordinates[dim].size();
+            npoints *= m[dim];
+        }
+
+        const FESpaceType& rFESpace = *pFESpace();
+        if (!rFESpace.IsTensorProduct())
+        {
+            // expand the grid and evaluate as scattered points
+            std::vector<std::vector<double> > points(npoints, std::vector<double>(TDim));
+            for (std::size_t q = 0; q < npoints; ++q)
+            {
+                std::size_t r = q;
+                for (int dim = 0; dim < TDim; ++dim)
+                {
+                    points[q][dim] = coordinates[dim][r % m[dim]];
+                    r /= m[dim];
+                }
+            }
+            this->EvaluatePoints(values, derivatives, points, with_derivatives);
+            return;
+        }
+
+        if (values.size() != npoints)
+            values.resize(npoints);
+        if (with_derivatives && derivatives.size() != npoints*TDim)
+            derivatives.resize(npoints*TDim);
+
+        // evaluate the univariate basis functions once per distinct coordinate
+        std::size_t n[TDim], stride[TDim];
+        std::vector<std::size_t> start[TDim];
+        std::vector<std::vector<double> > univariate_values[TDim], univariate_derivatives[TDim];
+        for (int dim = 0; dim < TDim; ++dim)
+        {
+            n[dim] = rFESpace.Order(dim) + 1;
+            stride[dim] = (dim == 0) ? 1 : stride[dim - 1] * rFESpace.UnivariateNumber(dim - 1);
+            start[dim].resize(m[dim]);
+            univariate_values[dim].resize(m[dim]);
+            univariate_derivatives[dim].resize(m[dim]);
+            for (std::size_t i = 0; i < m[dim]; ++i)
+                rFESpace.GetUnivariateNonzeroValueAndDerivative(start[dim][i], univariate_values[dim][i],
+                        univariate_derivatives[dim][i], dim, coordinates[dim][i]);
+        }
+
+        std::size_t nlocal = 1;
+        for (int dim = 0; dim < TDim; ++dim)
+            nlocal *= n[dim];
+
+        const std::vector<double>* pWeights = rFESpace.pWeights();
+
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(npoints, number_of_threads, partition);
+        std::vector<std::string> error_messages(number_of_threads);
+
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
+        {
+            try
+            {
+                GridFunctionBuffer buffer;
+                buffer.local_ids.resize(nlocal);
+                buffer.values.resize(nlocal);
+                if (with_derivatives)
+                    buffer.derivatives.resize(nlocal, std::vector<double>(TDim));
+
+                std::size_t idx[TDim];
+                for (std::size_t q = partition[k]; q < partition[k + 1]; ++q)
+                {
+                    std::size_t r = q;
+                    for (int dim = 0; dim < TDim; ++dim)
+                    {
+                        idx[dim] = r % m[dim];
+                        r /= m[dim];
+                    }
+
+                    // tensor products of the univariate functions
+                    double W = 0.0, dW[TDim];
+                    std::fill(dW, dW + TDim, 0.0);
+                    for (std::size_t a = 0; a < nlocal; ++a)
+                    {
+                        std::size_t b = a, local_id = 0;
+                        double N = 1.0, dN[TDim];
+                        std::fill(dN, dN + TDim, 1.0);
+                        for (int dim = 0; dim < TDim; ++dim)
+                        {
+                            const std::size_t ad = b % n[dim];
+                            b /= n[dim];
+                            local_id += (start[dim][idx[dim]] + ad) * stride[dim];
+                            const double v = univariate_values[dim][idx[dim]][ad];
+                            N *= v;
+                            if (with_derivatives)
+                                for (int dim2 = 0; dim2 < TDim; ++dim2)
+                                    dN[dim2] *= (dim2 == dim) ? univariate_derivatives[dim][idx[dim]][ad] : v;
+                        }
+
+                        if (pWeights != NULL)
+                        {
+                            const double w = (*pWeights)[local_id];
+                            N *= w;
+                            for (int dim = 0; dim < TDim; ++dim)
+                                dN[dim] *= w;
+                            W += N;
+                            for (int dim = 0; dim < TDim; ++dim)
+                                dW[dim] += dN[dim];
+                        }
+
+                        buffer.local_ids[a] = local_id;
+                        buffer.values[a] = N;
+                        if (with_derivatives)
+                            for (int dim = 0; dim < TDim; ++dim)
+                                buffer.derivatives[a][dim] = dN[dim];
+                    }
+
+                    // rational basis functions
+                    if (pWeights != NULL)
+                    {
+                        for (std::size_t a = 0; a < nlocal; ++a)
+                        {
+                            if (with_derivatives)
+                                for (int dim = 0; dim < TDim; ++dim)
+                                    buffer.derivatives[a][dim] = (buffer.derivatives[a][dim] - buffer.values[a]*dW[dim]/W) / W;
+                            buffer.values[a] /= W;
+                        }
+                    }
+
+                    this->Interpolate(values[q], with_derivatives ? &derivatives[q*TDim] : NULL, buffer, with_derivatives);
+                }
+            }
+            catch (std::exception& e)
+            {
+                error_messages[k] = e.what();
+            }
+        }
+
+        for (int k = 0; k < number_of_threads; ++k)
+            if (!error_messages[k].empty())
+                KRATOS_THROW_ERROR(std::runtime_error, error_messages[k], "")
+    }
+
 };
 
 
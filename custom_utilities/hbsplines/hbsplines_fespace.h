@@ -99,6 +99,7 @@ public:
         }
         BaseType::mpBasisFuncs.insert(p_bf);
         BaseType::m_function_map_is_created = false;
+        BaseType::ResetSupportIndex();
 
         return p_bf;
     }
@@ -167,6 +167,22 @@ struct IsogeometricEchoCheck
     }
 };
 
+/// Storage policy of the shape function values and local gradients at the integration points of the isogeometric geometries
+enum ShapeFunctionsPrecomputePolicy
+{
+    _PRECOMPUTE_NEVER_ = 0, // the tables are computed at Initialize and released at Clean
+    _PRECOMPUTE_LAZY_  = 1, // the tables are computed at the first Initialize and kept
+    _PRECOMPUTE_EAGER_ = 2, // the tables are computed as soon as the geometry data is assigned and kept
+    _PRECOMPUTE_LRU_   = 3  // the tables are kept after Clean within a memory budget; the least recently used are released first
+};
+
+/// Point evaluation of the point-based spline spaces (PB-splines, HB-splines, T-splines)
+enum PointEvaluationMode
+{
+    _EVALUATE_COX_DE_BOOR_       = 0, // each supported basis function is evaluated from its local knot vectors
+    _EVALUATE_BEZIER_EXTRACTION_ = 1  // the Bernstein polynomials on the containing cell are mapped by the extraction rows of the cell
+};
+
 enum PreElementType
 {
     _NURBS_ = 0,
@@ -114,6 +114,21 @@ public:
         return i_result;
     }
 
+    /// Create the table to access the items of the KRATOS container directly by their key. The entries of the missing keys are null.
+    /// The table is read-only, therefore it can be used concurrently, contrary to ThisContainer.find, which may sort the container.
+    template<class TContainerType>
+    static void CreateKeyTable(TContainerType& ThisContainer, std::vector<typename TContainerType::pointer>& rTable)
+    {
+        std::size_t max_key = 0;
+        for (typename TContainerType::ptr_iterator it = ThisContainer.ptr_begin(); it != ThisContainer.ptr_end(); ++it)
+            if ((*it)->Id() > max_key)
+                max_key = (*it)->Id();
+
+        rTable.assign(max_key + 1, typename TContainerType::pointer());
+        for (typename TContainerType::ptr_iterator it = ThisContainer.ptr_begin(); it != ThisContainer.ptr_end(); ++it)
+            rTable[(*it)->Id()] = *it;
+    }
+
     /// Create a condition taking the same geometry as the parent element
     static Condition::Pointer CreateConditionFromElement(const std::string& sample_condition_name,
         std::size_t& lastConditionId, Element::Pointer pElement, Properties::Pointer pProperties )
@@ -434,79 +434,145 @@ private:
 
         TEntityType const& r_clone_element = KratosComponents<TEntityType>::Get(element_name);
 
-        // loop through each cell in the space
-        typename TEntityType::NodesArrayType temp_element_nodes;
-        std::size_t cnt = starting_id;
-        Vector dummy;
+        // collect the cells of each cell manager for direct access
+        typedef typename cell_container_t::cell_t cell_t;
+        std::vector<std::vector<cell_t> > cells(pCellManagers.size());
+        for (std::size_t ip = 0; ip < pCellManagers.size(); ++ip)
+            cells[ip].assign(pCellManagers[ip]->begin(), pCellManagers[ip]->end());
+        const std::size_t ncells = cells[0].size();
+
+        // table to access the nodes directly by their id, since rNodes.find is not thread-safe
+        std::vector<typename TNodeContainerType::pointer> node_table;
+        MultiPatchUtility::CreateKeyTable(rNodes, node_table);
+
         int max_integration_method = 1;
         if (p_temp_properties->Has(NUM_IGA_INTEGRATION_METHOD))
             max_integration_method = (*p_temp_properties)[NUM_IGA_INTEGRATION_METHOD];
 
-        std::size_t ic = 0; // this is to mark the location of the iterator
-        for (typename cell_container_t::iterator it_dummy = pCellManagers[0]->begin(); it_dummy != pCellManagers[0]->end(); ++it_dummy)
+        // the extraction operators shared by the geometries
+        std::vector<std::vector<Cell::ExtractionOperatorPointerType> > operators(pFESpaces.size());
+        for (std::size_t ip = 0; ip < pFESpaces.size(); ++ip)
+            MultiPatchModelPart<TDim>::GetExtractionOperators(cells[ip], operators[ip]);
+
+        // create the entities concurrently; the id of the entity is determined by the position of the cell in the cell manager
+        std::vector<typename TEntityType::Pointer> new_entities(ncells);
+
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(ncells, number_of_threads, partition);
+        std::vector<std::string> error_messages(number_of_threads);
+
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
         {
-            std::vector<Element::GeometryType::Pointer> p_temp_geometries;
+            typename TEntityType::NodesArrayType temp_element_nodes;
+            Vector dummy;
 
-            // fill the vector of geometries
-            for (std::size_t ip = 0; ip < pFESpaces.size(); ++ip)
+            for (std::size_t ic = partition[k]; ic < partition[k+1]; ++ic)
             {
-                typename cell_container_t::iterator it_cell = pCellManagers[ip]->begin();
-                std::advance(it_cell, ic);
-                typename cell_container_t::cell_t pcell = *it_cell;
-                // KRATOS_WATCH(*pcell)
-
-                // get new nodes
-                temp_element_nodes.clear();
+                std::vector<Element::GeometryType::Pointer> p_temp_geometries;
 
-                const std::vector<std::size_t>& anchors = pcell->GetSupportedAnchors();
-                Vector weights(anchors.size());
-                for (std::size_t i = 0; i < anchors.size(); ++i)
+                // fill the vector of geometries
+                for (std::size_t ip = 0; ip < pFESpaces.size(); ++ip)
                 {
-                    temp_element_nodes.push_back(( *(MultiPatchUtility::FindKey(rNodes, CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]), "Node").base())));
-                    weights[i] = pControlGrids[ip]->GetData(pFESpaces[ip]->LocalId(anchors[i])).W();
+                    const cell_t& pcell = cells[ip][ic];
+
+                    // get new nodes
+                    temp_element_nodes.clear();
+
+                    const std::vector<std::size_t>& anchors = pcell->GetSupportedAnchors();
+                    Vector weights(anchors.size());
+                    for (std::size_t i = 0; i < anchors.size(); ++i)
+                    {
+                        const std::size_t node_id = CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]);
+                        if ((node_id >= node_table.size()) || (node_table[node_id] == NULL))
+                        {
+                            std::stringstream buffer;
+                            buffer << "Node #" << node_id << " is not found.";
+                            error_messages[k] = buffer.str();
+                            break;
+                        }
+                        temp_element_nodes.push_back(node_table[node_id]);
+                        weights[i] = pControlGrids[ip]->GetData(pFESpaces[ip]->LocalId(anchors[i])).W();
+                    }
+                    if (!error_messages[k].empty())
+                        break;
+
+                    #ifdef DEBUG_GEN_ENTITY
+                    #pragma omp critical(MultiMultiPatchModelPart_DebugGenEntity)
+                    {
+                        std::cout << "anchors:";
+                        for (std::size_t i = 0; i < anchors.size(); ++i)
+                            std::cout << " " << CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]);
+                        std::cout << std::endl;
+                        KRATOS_WATCH(weights)
+                        KRATOS_WATCH(pcell->GetCompressedExtractionOperator())
+                        KRATOS_WATCH(pFESpaces[ip]->Order(0))
+                        KRATOS_WATCH(pFESpaces[ip]->Order(1))
+                        KRATOS_WATCH(pFESpaces[ip]->Order(2))
+                    }
+                    #endif
+
+                    // create the geometry
+                    typename IsogeometricGeometryType::Pointer p_temp_geometry
+                        = boost::dynamic_pointer_cast<IsogeometricGeometryType>(r_clone_element.GetGeometry().Create(temp_element_nodes));
+                    if (p_temp_geometry == NULL)
+                    {
+                        error_messages[k] = "The cast to IsogeometricGeometry is failed.";
+                        break;
+                    }
+
+                    // for tensor-product cell, the extraction operator is passed in factored form; the geometry shares the factors of the cell
+                    const BCell* p_bcell = dynamic_cast<const BCell*>(&(*pcell));
+                    if ((p_bcell != NULL) && (p_bcell->GetExtractionOperatorFactors().size() == 3))
+                    {
+                        const std::vector<BCell::ExtractionOperatorPointerType>& C = p_bcell->GetExtractionOperatorFactors();
+                        p_temp_geometry->AssignGeometryData(dummy,
+                                                            dummy,
+                                                            dummy,
+                                                            weights,
+                                                            C[0],
+                                                            C[1],
+                                                            C[2],
+                                                            static_cast<int>(pFESpaces[ip]->Order(0)),
+                                                            static_cast<int>(pFESpaces[ip]->Order(1)),
+                                                            static_cast<int>(pFESpaces[ip]->Order(2)),
+                                                            max_integration_method);
+                    }
+                    else
+                    {
+                        p_temp_geometry->AssignGeometryData(dummy,
+                                                            dummy,
+                                                            dummy,
+                                                            weights,
+                                                            operators[ip][ic], // the geometry shares the extraction operator of the cell
+                                                            static_cast<int>(pFESpaces[ip]->Order(0)),
+                                                            static_cast<int>(pFESpaces[ip]->Order(1)),
+                                                            static_cast<int>(pFESpaces[ip]->Order(2)),
+                                                            max_integration_method);
+                    }
+                    p_temp_geometries.push_back(p_temp_geometry);
                 }
-
-                #ifdef DEBUG_GEN_ENTITY
-                std::cout << "anchors:";
-                for (std::size_t i = 0; i < anchors.size(); ++i)
-                    std::cout << " " << CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]);
-                std::cout << std::endl;
-                KRATOS_WATCH(weights)
-                // KRATOS_WATCH(pcell->GetExtractionOperator())
-                KRATOS_WATCH(pcell->GetCompressedExtractionOperator())
-                KRATOS_WATCH(pFESpace->Order(0))
-                KRATOS_WATCH(pFESpace->Order(1))
-                KRATOS_WATCH(pFESpace->Order(2))
-                #endif
-
-                // create the geometry
-                typename IsogeometricGeometryType::Pointer p_temp_geometry
-                    = boost::dynamic_pointer_cast<IsogeometricGeometryType>(r_clone_element.GetGeometry().Create(temp_element_nodes));
-                if (p_temp_geometry == NULL)
-                    KRATOS_THROW_ERROR(std::runtime_error, "The cast to IsogeometricGeometry is failed.", "")
-
-                p_temp_geometry->AssignGeometryData(dummy,
-                                                    dummy,
-                                                    dummy,
-                                                    weights,
-                                                    // pcell->GetExtractionOperator(),
-                                                    pcell->GetCompressedExtractionOperator(),
-                                                    static_cast<int>(pFESpaces[ip]->Order(0)),
-                                                    static_cast<int>(pFESpaces[ip]->Order(1)),
-                                                    static_cast<int>(pFESpaces[ip]->Order(2)),
-                                                    max_integration_method);
-                p_temp_geometries.push_back(p_temp_geometry);
+                if (!error_messages[k].empty())
+                    break;
+
+                // create the element
+                typename TEntityType::Pointer pNewElement = r_clone_element.Create(starting_id + ic, p_temp_geometries, p_temp_properties);
+                pNewElement->SetValue(ACTIVATION_LEVEL, 0);
+                pNewElement->SetValue(IS_INACTIVE, false);
+                pNewElement->Set(ACTIVE, true);
+                new_entities[ic] = pNewElement;
             }
+        }
 
-            ++ic;
+        for (int k = 0; k < number_of_threads; ++k)
+            if (!error_messages[k].empty())
+                KRATOS_THROW_ERROR(std::invalid_argument, error_messages[k], "")
 
-            // create the element and add to the list
-            typename TEntityType::Pointer pNewElement = r_clone_element.Create(cnt++, p_temp_geometries, p_temp_properties);
-            pNewElement->SetValue(ACTIVATION_LEVEL, 0);
-            pNewElement->SetValue(IS_INACTIVE, false);
-            pNewElement->Set(ACTIVE, true);
-            pNewElements.push_back(pNewElement);
-        }
+        // add the entities to the container at once; they are in the order of id
+        pNewElements.reserve(ncells);
+        for (std::size_t ic = 0; ic < ncells; ++ic)
+            pNewElements.push_back(new_entities[ic]);
 
         #ifdef ENABLE_PROFILING
         std::cout << "  >> generate entities: " << OpenMPUtils::GetCurrentTime()-start << " s" << std::endl;
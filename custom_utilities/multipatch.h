@@ -12,6 +12,8 @@
 
 #include "custom_utilities/patch.h"
 #include "custom_utilities/patch_interface.h"
+#include "custom_utilities/disjoint_set.h"
+#include "custom_utilities/equation_ordering_utility.h"
 
 namespace Kratos
 {
@@ -36,7 +38,7 @@ public:
     typedef typename Patch<TDim>::volume_t volume_t;
 
     /// Default constructor
-    MultiPatch() : mEquationSystemSize(0) {}
+    MultiPatch() : mEquationSystemSize(0), mFirstEquationId(0), mReorderEquations(false) {}
 
     /// Destructor
     virtual ~MultiPatch() {}
@@ -67,25 +69,28 @@ public:
     /// Get the equation system size
     std::size_t EquationSystemSize() const {return mEquationSystemSize;}
 
+    /// Enable/disable the bandwidth-reducing reordering of the equations at the enumeration
+    void SetEquationReordering(const bool& Flag) {mReorderEquations = Flag;}
+
+    /// Get the permutation of the last enumeration, i.e. the equation id start+i without reordering becomes start+EquationPermutation()[i].
+    /// It is empty if the reordering is disabled.
+    const std::vector<std::size_t>& EquationPermutation() const {return mEquationPermutation;}
+
     /// Locate the patch of the global equation id and the corresponding local id to determine the control value
     /// IMPORTANT: user must make sure that the multipatch is fully enumerated by checking IsEnumerated()
+    /// The lookup is constant time and thread-safe
     std::tuple<std::size_t, std::size_t> EquationIdLocation(const std::size_t& global_id) const
     {
-        std::map<std::size_t, std::size_t>::const_iterator it = mGlobalToPatch.find(global_id);
-        if (it == mGlobalToPatch.end())
+        if ((global_id < mFirstEquationId) || (global_id - mFirstEquationId >= mEquationPatchIds.size()))
         {
             KRATOS_WATCH(global_id)
+            KRATOS_WATCH(mFirstEquationId)
             KRATOS_WATCH(mEquationSystemSize)
-            std::cout << "global_to_patch map:" << std::endl;
-            for (std::map<std::size_t, std::size_t>::const_iterator it2 = mGlobalToPatch.begin(); it2 != mGlobalToPatch.end(); ++it2)
-                std::cout << " " << it2->first << ": " << it2->second << std::endl;
-            KRATOS_THROW_ERROR(std::logic_error, "The global id does not exist in the global_to_patch map.", "")
+            KRATOS_THROW_ERROR(std::logic_error, "The global id does not exist in the global_to_patch index.", "")
         }
 
-        const std::size_t& patch_id = it->second;
-        const std::size_t& local_id = pGetPatch(it->second)->pFESpace()->LocalId(global_id);
-
-        return std::make_tuple(patch_id, local_id);
+        const std::size_t i = global_id - mFirstEquationId;
+        return std::make_tuple(mEquationPatchIds[i], mEquationLocalIds[i]);
     }
 
     /// Validate the MultiPatch
@@ -225,61 +230,135 @@ public:
     }
 
     /// Enumerate all the patches, with the given starting id
+    /// The functions coincident at the interfaces are merged by a disjoint-set over the (patch, local id) pairs, then the
+    /// global ids are assigned consecutively. If the equation reordering is enabled, the ids are permuted to reduce the bandwidth.
+    /// The merged functions do not depend on the order of the interfaces, but the ids follow the order of the patches in the
+    /// container and of the local ids in each patch.
     std::size_t Enumerate(const std::size_t& start)
     {
-        // enumerate each patch
-        std::size_t last = start;
+        // give each function a unique label, i.e. the offset of the patch plus the local id
+        std::size_t number_of_labels = 0;
+        for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
+        {
+            const std::size_t n = (*it)->pFESpace()->TotalNumber();
+            std::vector<std::size_t> labels(n);
+            for (std::size_t i = 0; i < n; ++i)
+                labels[i] = number_of_labels + i;
+            (*it)->pFESpace()->ResetFunctionIndices();
+            (*it)->pFESpace()->ResetFunctionIndices(labels);
+            number_of_labels += n;
+        }
+
+        // merge the labels of the coincident functions. The interfaces overwrite the labels on the boundary of the second patch,
+        // the non-primary patches take the labels of their parents; the overwritten and the new labels are merged.
+        DisjointSet labels_set(number_of_labels);
         for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
         {
             if ((*it)->IsPrimary() == true)
             {
-                last = (*it)->pFESpace()->Enumerate(last);
-                std::cout << "At " << __FUNCTION__ << ", last: " << last << std::endl;
-
-                // enumerate the interface
                 for (std::size_t i = 0; i < (*it)->NumberOfInterfaces(); ++i)
-                    (*it)->pInterface(i)->Enumerate();
+                {
+                    typename PatchInterface<TDim>::Pointer pInterface = (*it)->pInterface(i);
+                    std::vector<std::size_t> old_labels = pInterface->pPatch2()->pFESpace()->ExtractBoundaryFunctionIndices(pInterface->Side2());
+                    pInterface->Enumerate();
+                    std::vector<std::size_t> new_labels = pInterface->pPatch2()->pFESpace()->ExtractBoundaryFunctionIndices(pInterface->Side2());
+                    for (std::size_t j = 0; j < old_labels.size(); ++j)
+                        labels_set.Union(old_labels[j], new_labels[j]);
+                }
             }
         }
 
-        // check if a patch is not a primary patch, then that patch must be enumerated again using the enumeration info from the other patches
         for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
         {
             if ((*it)->IsPrimary() == false)
             {
+                std::vector<std::size_t> old_labels = (*it)->pFESpace()->FunctionIndices();
                 (*it)->Enumerate();
+                std::vector<std::size_t> new_labels = (*it)->pFESpace()->FunctionIndices();
+                for (std::size_t j = 0; j < old_labels.size(); ++j)
+                    labels_set.Union(old_labels[j], new_labels[j]);
             }
         }
 
-        // collect all the enumerated numbers and reassign with new to make it consecutive
-        std::set<std::size_t> all_indices;
+        // assign the consecutive ids to the sets, in the order of the labels
+        const std::size_t undefined = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> set_ids(number_of_labels, undefined);
+        mEquationSystemSize = 0;
+        for (std::size_t i = 0; i < number_of_labels; ++i)
+        {
+            const std::size_t root = labels_set.Find(i);
+            if (set_ids[root] == undefined)
+                set_ids[root] = mEquationSystemSize++;
+        }
+
+        std::vector<std::vector<std::size_t> > patch_ids;
+        std::size_t offset = 0;
         for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
         {
-            std::vector<std::size_t> func_indices = (*it)->pFESpace()->FunctionIndices();
-            all_indices.insert(func_indices.begin(), func_indices.end());
+            const std::size_t n = (*it)->pFESpace()->TotalNumber();
+            patch_ids.push_back(std::vector<std::size_t>(n));
+            for (std::size_t i = 0; i < n; ++i)
+                patch_ids.back()[i] = set_ids[labels_set.Find(offset + i)];
+            offset += n;
         }
-        mEquationSystemSize = all_indices.size();
 
-        std::map<std::size_t, std::size_t> new_indices;
-        std::size_t cnt = start;
-        for (std::set<std::size_t>::iterator it = all_indices.begin(); it != all_indices.end(); ++it)
+        // reorder the equations to reduce the bandwidth, using the connectivity of the cells
+        mEquationPermutation.clear();
+        if (mReorderEquations)
         {
-            new_indices[*it] = cnt++;
+            std::size_t ip = 0;
+            for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it, ++ip)
+            {
+                std::vector<std::size_t> ids(patch_ids[ip]);
+                for (std::size_t i = 0; i < ids.size(); ++i)
+                    ids[i] += start;
+                (*it)->pFESpace()->ResetFunctionIndices();
+                (*it)->pFESpace()->ResetFunctionIndices(ids);
+            }
+
+            // the functions supported on the same knot span are connected; the cells are not constructed
+            std::vector<std::vector<std::size_t> > connectivities;
+            for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
+                (*it)->pFESpace()->GetCellSupports(connectivities);
+            for (std::size_t c = 0; c < connectivities.size(); ++c)
+                for (std::size_t i = 0; i < connectivities[c].size(); ++i)
+                    connectivities[c][i] -= start; // the ids out of range are skipped by CreateGraph
+
+            std::vector<std::size_t> rowPtr, colInd;
+            EquationOrderingUtility::CreateGraph(mEquationSystemSize, connectivities, rowPtr, colInd);
+            EquationOrderingUtility::ReverseCuthillMcKee(rowPtr, colInd, mEquationPermutation);
+
+            std::cout << "At " << __FUNCTION__ << ", bandwidth: " << EquationOrderingUtility::Bandwidth(rowPtr, colInd, std::vector<std::size_t>())
+                      << " -> " << EquationOrderingUtility::Bandwidth(rowPtr, colInd, mEquationPermutation) << std::endl;
+
+            for (std::size_t k = 0; k < patch_ids.size(); ++k)
+                for (std::size_t i = 0; i < patch_ids[k].size(); ++i)
+                    patch_ids[k][i] = mEquationPermutation[patch_ids[k][i]];
         }
 
-        // reassign the new indices to each patch
-        for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
+        // assign the final ids to each patch
+        std::size_t ip = 0;
+        for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it, ++ip)
         {
-            (*it)->pFESpace()->UpdateFunctionIndices(new_indices);
+            for (std::size_t i = 0; i < patch_ids[ip].size(); ++i)
+                patch_ids[ip][i] += start;
+            (*it)->pFESpace()->ResetFunctionIndices();
+            (*it)->pFESpace()->ResetFunctionIndices(patch_ids[ip]);
         }
 
-        // rebuild the global to patch map
-        mGlobalToPatch.clear();
+        // rebuild the global to patch index. The equation ids are consecutive from start, hence the index is a flat array.
+        // For the equation shared by several patches, the last patch is taken.
+        mFirstEquationId = start;
+        mEquationPatchIds.assign(mEquationSystemSize, 0);
+        mEquationLocalIds.assign(mEquationSystemSize, 0);
         for (typename PatchContainerType::ptr_iterator it = Patches().ptr_begin(); it != Patches().ptr_end(); ++it)
         {
             std::vector<std::size_t> global_indices = (*it)->pFESpace()->FunctionIndices();
             for (std::size_t i = 0; i < global_indices.size(); ++i)
-                mGlobalToPatch[global_indices[i]] = (*it)->Id();
+            {
+                mEquationPatchIds[global_indices[i] - start] = (*it)->Id();
+                mEquationLocalIds[global_indices[i] - start] = (*it)->pFESpace()->LocalId(global_indices[i]);
+            }
         }
 
         return start + mEquationSystemSize;
@@ -302,7 +381,11 @@ private:
 
     PatchContainerType mpPatches; // container for all the patches
     std::size_t mEquationSystemSize; // this is the number of equation id in this multipatch
-    std::map<std::size_t, std::size_t> mGlobalToPatch; // this is to map each global id to a patch id
+    std::size_t mFirstEquationId; // the first equation id, given at the enumeration
+    std::vector<std::size_t> mEquationPatchIds; // the patch id of each equation id, offset by mFirstEquationId
+    std::vector<std::size_t> mEquationLocalIds; // the local id in the patch of each equation id, offset by mFirstEquationId
+    bool mReorderEquations; // if true, the equations are reordered by reverse Cuthill-McKee at the enumeration
+    std::vector<std::size_t> mEquationPermutation; // the permutation of the last enumeration, if reordered
 
 };
 
@@ -10,9 +10,13 @@
 #define  KRATOS_ISOGEOMETRIC_APPLICATION_MULTIPATCH_MODEL_PART_H_INCLUDED
 
 // System includes
+#include <map>
 #include <vector>
+#include <cmath>
 
 // External includes
+#include <boost/array.hpp>
+#include <boost/make_shared.hpp>
 
 // Project includes
 #include "includes/define.h"
@@ -89,6 +93,12 @@ public:
 
         // swap the internal model_part with new model_part
         mpModelPart.swap(pNewModelPart);
+
+        // clear the records of the previous model_part
+        mFunctionKeys.clear();
+        mElementRecords.clear();
+        mConditionRecords.clear();
+        mMovedEquationIds.clear();
     }
 
     /// create the nodes from the control points and add to the model_part
@@ -101,22 +111,53 @@ public:
         if (!mpMultiPatch->IsEnumerated())
             KRATOS_THROW_ERROR(std::logic_error, "The multipatch is not enumerated", "")
 
-        // create new nodes from control points
-        for (std::size_t idof = 0; idof < mpMultiPatch->EquationSystemSize(); ++idof)
+        const std::size_t n = mpMultiPatch->EquationSystemSize();
+
+        // control grids and FESpaces of the patches, to be accessed concurrently
+        std::map<std::size_t, typename ControlGrid<ControlPointType>::ConstPointer> control_grids;
+        std::map<std::size_t, typename FESpace<TDim>::ConstPointer> fespaces;
+        for (typename MultiPatch<TDim>::PatchContainerType::iterator it = mpMultiPatch->begin(); it != mpMultiPatch->end(); ++it)
         {
-            std::tuple<std::size_t, std::size_t> loc = mpMultiPatch->EquationIdLocation(idof);
+            control_grids[it->Id()] = it->ControlPointGridFunction().pControlGrid();
+            fespaces[it->Id()] = it->pFESpace();
+        }
 
-            const std::size_t& patch_id = std::get<0>(loc);
-            const std::size_t& local_id = std::get<1>(loc);
-            // KRATOS_WATCH(patch_id)
-            // KRATOS_WATCH(local_id)
+        // create new nodes from control points concurrently
+        std::vector<NodeType::Pointer> new_nodes(n);
+        mFunctionKeys.resize(n);
+
+        VariablesList& rVariablesList = mpModelPart->GetNodalSolutionStepVariablesList();
+        const std::size_t buffer_size = mpModelPart->GetBufferSize();
 
-            const ControlPointType& point = mpMultiPatch->pGetPatch(patch_id)->pControlPointGridFunction()->pControlGrid()->GetData(local_id);
-            // KRATOS_WATCH(point)
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(n, number_of_threads, partition);
 
-            ModelPart::NodeType::Pointer pNewNode = mpModelPart->CreateNewNode(CONVERT_INDEX_IGA_TO_KRATOS(idof), point.X(), point.Y(), point.Z());
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
+        {
+            for (std::size_t idof = partition[k]; idof < partition[k+1]; ++idof)
+            {
+                std::tuple<std::size_t, std::size_t> loc = mpMultiPatch->EquationIdLocation(idof);
+
+                const std::size_t& patch_id = std::get<0>(loc);
+                const std::size_t& local_id = std::get<1>(loc);
+
+                const ControlPointType point = control_grids.find(patch_id)->second->GetData(local_id);
+
+                new_nodes[idof] = boost::make_shared<NodeType>(CONVERT_INDEX_IGA_TO_KRATOS(idof), point.X(), point.Y(), point.Z());
+                new_nodes[idof]->SetSolutionStepVariablesList(&rVariablesList);
+                new_nodes[idof]->SetBufferSize(buffer_size);
+                GetFunctionKey(patch_id, *(fespaces.find(patch_id)->second), local_id, mFunctionKeys[idof]);
+            }
         }
 
+        // add the nodes to the model_part at once; they are in the order of id
+        mpModelPart->Nodes().reserve(mpModelPart->Nodes().size() + n);
+        for (std::size_t idof = 0; idof < n; ++idof)
+            mpModelPart->Nodes().push_back(new_nodes[idof]);
+        mpModelPart->Nodes().Unique();
+
         #ifdef ENABLE_PROFILING
         std::cout << ">>> " << __FUNCTION__ << " completed: " << OpenMPUtils::GetCurrentTime() - start << " s" << std::endl;
         #else
@@ -138,7 +179,9 @@ public:
         const GridFunction<TDim, ControlPointType>& rControlPointGridFunction = pPatch->ControlPointGridFunction();
 
         // create new elements and add to the model_part
-        ModelPart::ElementsContainerType pNewElements = CreateEntitiesFromFESpace<Element, FESpace<TDim>, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(pPatch->pFESpace(), rControlPointGridFunction.pControlGrid(), mpModelPart->Nodes(), element_name, starting_id, pProperties);
+        typename FESpace<TDim>::cell_container_t::Pointer pCellManager;
+        ModelPart::ElementsContainerType pNewElements = CreateEntitiesFromFESpace<Element, FESpace<TDim>, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(pPatch->pFESpace(), rControlPointGridFunction.pControlGrid(), mpModelPart->Nodes(), element_name, starting_id, pProperties, pCellManager);
+        mElementRecords.push_back(CreateRecord<Element>(pPatch->Id(), -1, element_name, starting_id, pProperties, *pCellManager, pNewElements));
 
         for (ModelPart::ElementsContainerType::ptr_iterator it = pNewElements.ptr_begin(); it != pNewElements.ptr_end(); ++it)
         {
@@ -172,7 +215,9 @@ public:
         const GridFunction<TDim, ControlPointType>& rControlPointGridFunction = pPatch->ControlPointGridFunction();
 
         // create new elements and add to the model_part
-        ModelPart::ConditionsContainerType pNewConditions = CreateEntitiesFromFESpace<Condition, FESpace<TDim>, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(pPatch->pFESpace(), rControlPointGridFunction.pControlGrid(), mpModelPart->Nodes(), condition_name, starting_id, pProperties);
+        typename FESpace<TDim>::cell_container_t::Pointer pCellManager;
+        ModelPart::ConditionsContainerType pNewConditions = CreateEntitiesFromFESpace<Condition, FESpace<TDim>, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(pPatch->pFESpace(), rControlPointGridFunction.pControlGrid(), mpModelPart->Nodes(), condition_name, starting_id, pProperties, pCellManager);
+        mConditionRecords.push_back(CreateRecord<Condition>(pPatch->Id(), -1, condition_name, starting_id, pProperties, *pCellManager, pNewConditions));
 
         for (ModelPart::ConditionsContainerType::ptr_iterator it = pNewConditions.ptr_begin(); it != pNewConditions.ptr_end(); ++it)
         {
@@ -210,7 +255,9 @@ public:
         const GridFunction<TDim-1, ControlPointType>& rControlPointGridFunction = pBoundaryPatch->ControlPointGridFunction();
 
         // create new conditions and add to the model_part
-        ModelPart::ConditionsContainerType pNewConditions = CreateEntitiesFromFESpace<Condition, FESpace<TDim-1>, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(pBoundaryPatch->pFESpace(), rControlPointGridFunction.pControlGrid(), mpModelPart->Nodes(), condition_name, starting_id, pProperties);
+        typename FESpace<TDim-1>::cell_container_t::Pointer pCellManager;
+        ModelPart::ConditionsContainerType pNewConditions = CreateEntitiesFromFESpace<Condition, FESpace<TDim-1>, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(pBoundaryPatch->pFESpace(), rControlPointGridFunction.pControlGrid(), mpModelPart->Nodes(), condition_name, starting_id, pProperties, pCellManager);
+        mConditionRecords.push_back(CreateRecord<Condition>(pPatch->Id(), static_cast<int>(side), condition_name, starting_id, pProperties, *pCellManager, pNewConditions));
 
         // std::cout << "model_part nodes:" << std::endl;
         // for(ModelPart::NodeIterator i = mpModelPart->NodesBegin() ; i != mpModelPart->NodesEnd() ; i++)
@@ -249,39 +296,236 @@ public:
         mIsModelPartReady = true;
     }
 
+    /// Update the model_part after the multipatch is refined, instead of creating it again.
+    /// The nodes of the unchanged basis functions and the entities of the unchanged cells are kept, together with their data.
+    /// Only the new nodes/entities are created and the obsolete ones are removed from the model_part.
+    /// A basis function is unchanged if it is on the same patch and has the same local knot vectors. A cell is unchanged if it has
+    /// the same knot range and the same anchors (up to the renumbering of the equations); its extraction operator is then unchanged too.
+    /// The kept nodes take the new equation ids; the equation ids which are changed are given by MovedEquationIds().
+    void UpdateModelPart()
+    {
+        if (!mIsModelPartReady)
+            KRATOS_THROW_ERROR(std::logic_error, "The model_part is not created. BeginModelPart/EndModelPart must be called first.", "")
+
+        #ifdef ENABLE_PROFILING
+        double start = OpenMPUtils::GetCurrentTime();
+        #endif
+
+        const std::size_t invalid = static_cast<std::size_t>(-1);
+
+        // map the old basis functions to their equation ids. The functions without key or with the same key are not matched.
+        std::map<FunctionKeyType, std::size_t> old_functions;
+        for (std::size_t idof = 0; idof < mFunctionKeys.size(); ++idof)
+        {
+            if (mFunctionKeys[idof].empty())
+                continue;
+
+            std::pair<typename std::map<FunctionKeyType, std::size_t>::iterator, bool> res
+                = old_functions.insert(std::make_pair(mFunctionKeys[idof], idof));
+            if (!res.second)
+                res.first->second = invalid;
+        }
+
+        std::vector<NodeType::Pointer> old_nodes;
+        MultiPatchUtility::CreateKeyTable(mpModelPart->Nodes(), old_nodes);
+
+        // enumerate the refined multipatch and identify its basis functions
+        mpMultiPatch->Enumerate();
+        const std::size_t n = mpMultiPatch->EquationSystemSize();
+
+        std::vector<FunctionKeyType> new_function_keys(n);
+        std::map<FunctionKeyType, std::size_t> new_functions;
+        for (std::size_t idof = 0; idof < n; ++idof)
+        {
+            std::tuple<std::size_t, std::size_t> loc = mpMultiPatch->EquationIdLocation(idof);
+            const std::size_t& patch_id = std::get<0>(loc);
+            const std::size_t& local_id = std::get<1>(loc);
+            GetFunctionKey(patch_id, *(mpMultiPatch->pGetPatch(patch_id)->pFESpace()), local_id, new_function_keys[idof]);
+            if (!new_function_keys[idof].empty())
+                ++new_functions[new_function_keys[idof]];
+        }
+
+        // match the new basis functions with the old ones and keep the nodes
+        std::vector<std::size_t> new_to_old(n, invalid);
+        ModelPart::NodesContainerType kept_nodes;
+        mMovedEquationIds.clear();
+        for (std::size_t idof = 0; idof < n; ++idof)
+        {
+            const FunctionKeyType& key = new_function_keys[idof];
+            if (key.empty() || (new_functions[key] != 1))
+                continue;
+
+            typename std::map<FunctionKeyType, std::size_t>::iterator it = old_functions.find(key);
+            if ((it == old_functions.end()) || (it->second == invalid))
+                continue;
+
+            const std::size_t old_node_id = CONVERT_INDEX_IGA_TO_KRATOS(it->second);
+            if ((old_node_id >= old_nodes.size()) || (old_nodes[old_node_id] == NULL))
+                continue;
+
+            new_to_old[idof] = it->second;
+            if (it->second != idof)
+            {
+                old_nodes[old_node_id]->SetId(CONVERT_INDEX_IGA_TO_KRATOS(idof));
+                mMovedEquationIds[it->second] = idof;
+            }
+            kept_nodes.push_back(old_nodes[old_node_id]);
+        }
+        old_nodes.clear();
+
+        // replace the nodes of the model_part and create the new nodes
+        mpModelPart->Nodes().swap(kept_nodes);
+        mpModelPart->Nodes().Unique();
+        for (std::size_t idof = 0; idof < n; ++idof)
+        {
+            if (new_to_old[idof] != invalid)
+                continue;
+
+            std::tuple<std::size_t, std::size_t> loc = mpMultiPatch->EquationIdLocation(idof);
+            const ControlPointType point = mpMultiPatch->pGetPatch(std::get<0>(loc))->pControlPointGridFunction()->pControlGrid()->GetData(std::get<1>(loc));
+            mpModelPart->CreateNewNode(CONVERT_INDEX_IGA_TO_KRATOS(idof), point.X(), point.Y(), point.Z());
+        }
+        mFunctionKeys.swap(new_function_keys);
+
+        // update the entities from each record. The ids of the entities of a record start from its original starting id,
+        // or after the ids of the previous record if they overlap.
+        std::size_t next_id = 0;
+        ModelPart::ElementsContainerType new_elements;
+        for (std::size_t ir = 0; ir < mElementRecords.size(); ++ir)
+        {
+            next_id = std::max(next_id, mElementRecords[ir].StartingId);
+            this->UpdateEntities(mElementRecords[ir], new_to_old, next_id);
+            for (std::size_t i = 0; i < mElementRecords[ir].Entities.size(); ++i)
+                new_elements.push_back(mElementRecords[ir].Entities[i]);
+            next_id += mElementRecords[ir].Entities.size();
+        }
+        mpModelPart->Elements().swap(new_elements);
+        mpModelPart->Elements().Unique();
+
+        ModelPart::ConditionsContainerType new_conditions;
+        next_id = 0;
+        for (std::size_t ir = 0; ir < mConditionRecords.size(); ++ir)
+        {
+            next_id = std::max(next_id, mConditionRecords[ir].StartingId);
+            this->UpdateEntities(mConditionRecords[ir], new_to_old, next_id);
+            for (std::size_t i = 0; i < mConditionRecords[ir].Entities.size(); ++i)
+                new_conditions.push_back(mConditionRecords[ir].Entities[i]);
+            next_id += mConditionRecords[ir].Entities.size();
+        }
+        mpModelPart->Conditions().swap(new_conditions);
+        mpModelPart->Conditions().Unique();
+
+        #ifdef ENABLE_PROFILING
+        std::cout << ">>> " << __FUNCTION__ << " completed: " << OpenMPUtils::GetCurrentTime() - start << " s" << std::endl;
+        #else
+        std::cout << __FUNCTION__ << " completed" << std::endl;
+        #endif
+    }
+
+    /// Get the equation ids changed by the last UpdateModelPart, as a map from the old equation id to the new one
+    const std::map<std::size_t, std::size_t>& MovedEquationIds() const {return mMovedEquationIds;}
+
     /// Synchronize from multipatch to model_part
     template<class TVariableType>
     void SynchronizeForward(const TVariableType& rVariable)
     {
-        if (!IsReady()) return;
+        this->SynchronizeForward(std::vector<const TVariableType*>(1, &rVariable));
+    }
+
+    /// Synchronize a list of variables from multipatch to model_part, in one sweep over the equations
+    template<class TVariableType>
+    void SynchronizeForward(const std::vector<const TVariableType*>& rVariables)
+    {
+        if (!IsReady() || rVariables.empty()) return;
 
         if (!mpMultiPatch->IsEnumerated())
             KRATOS_THROW_ERROR(std::logic_error, "The multipatch is not enumerated", "")
 
+        this->CheckSolutionStepVariables(rVariables);
+
+        const std::size_t n = mpMultiPatch->EquationSystemSize();
+        const std::size_t nvars = rVariables.size();
+
+        // control grids of the variables, resolved once. The grids of patch i are in [i*nvars, (i+1)*nvars); the missing grids are null.
+        typedef typename ControlGrid<typename TVariableType::Type>::ConstPointer ControlGridConstPointerType;
+        std::size_t max_patch_id = 0;
+        for (typename MultiPatch<TDim>::PatchContainerType::iterator it = mpMultiPatch->begin(); it != mpMultiPatch->end(); ++it)
+            if (it->Id() > max_patch_id)
+                max_patch_id = it->Id();
+
+        std::vector<ControlGridConstPointerType> control_grids((max_patch_id + 1) * nvars);
+        for (typename MultiPatch<TDim>::PatchContainerType::iterator it = mpMultiPatch->begin(); it != mpMultiPatch->end(); ++it)
+            for (std::size_t iv = 0; iv < nvars; ++iv)
+                if (it->template HasGridFunction<TVariableType>(*rVariables[iv]))
+                    control_grids[it->Id() * nvars + iv] = it->pGetGridFunction(*rVariables[iv])->pControlGrid();
+
+        std::vector<NodeType::Pointer> nodes;
+        MultiPatchUtility::CreateKeyTable(mpModelPart->Nodes(), nodes);
+        if (nodes.size() < CONVERT_INDEX_IGA_TO_KRATOS(n))
+            KRATOS_THROW_ERROR(std::logic_error, "The model_part does not contain all the nodes of the multipatch. The number of equations is", n)
+
         // transfer data from from control points to nodes
-        for (std::size_t idof = 0; idof < mpMultiPatch->EquationSystemSize(); ++idof)
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(n, number_of_threads, partition);
+        std::vector<int> missing_patches(number_of_threads, -1);
+
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
         {
-            std::tuple<std::size_t, std::size_t> loc = mpMultiPatch->EquationIdLocation(idof);
+            for (std::size_t idof = partition[k]; idof < partition[k+1]; ++idof)
+            {
+                std::tuple<std::size_t, std::size_t> loc = mpMultiPatch->EquationIdLocation(idof);
 
-            const std::size_t& patch_id = std::get<0>(loc);
-            const std::size_t& local_id = std::get<1>(loc);
-            // KRATOS_WATCH(patch_id)
-            // KRATOS_WATCH(local_id)
+                const std::size_t& patch_id = std::get<0>(loc);
+                const std::size_t& local_id = std::get<1>(loc);
 
-            const typename TVariableType::Type& value = mpMultiPatch->pGetPatch(patch_id)->pGetGridFunction(rVariable)->pControlGrid()->GetData(local_id);
-            // KRATOS_WATCH(value)
+                const ControlGridConstPointerType* grids = &control_grids[patch_id * nvars];
+                NodeType& rNode = *nodes[CONVERT_INDEX_IGA_TO_KRATOS(idof)];
 
-            ModelPart::NodeType::Pointer pNode = mpModelPart->pGetNode(CONVERT_INDEX_IGA_TO_KRATOS(idof));
+                for (std::size_t iv = 0; iv < nvars; ++iv)
+                {
+                    if (!grids[iv])
+                    {
+                        missing_patches[k] = static_cast<int>(patch_id);
+                        break;
+                    }
 
-            pNode->GetSolutionStepValue(rVariable) = value;
+                    rNode.FastGetSolutionStepValue(*rVariables[iv]) = (*grids[iv])[local_id];
+                }
+
+                if (missing_patches[k] != -1)
+                    break;
+            }
         }
+
+        for (int k = 0; k < number_of_threads; ++k)
+            if (missing_patches[k] != -1)
+                KRATOS_THROW_ERROR(std::logic_error, "The grid function of the variable does not exist in patch", missing_patches[k])
     }
 
     /// Synchronize from model_part to the multipatch
     template<class TVariableType>
     void SynchronizeBackward(const TVariableType& rVariable)
     {
-        if (!IsReady()) return;
+        this->SynchronizeBackward(std::vector<const TVariableType*>(1, &rVariable));
+    }
+
+    /// Synchronize a list of variables from model_part to the multipatch, in one sweep over the functions of each patch
+    template<class TVariableType>
+    void SynchronizeBackward(const std::vector<const TVariableType*>& rVariables)
+    {
+        if (!IsReady() || rVariables.empty()) return;
+
+        this->CheckSolutionStepVariables(rVariables);
+
+        const std::size_t nvars = rVariables.size();
+
+        // table to access the nodes concurrently
+        std::vector<NodeType::Pointer> nodes;
+        MultiPatchUtility::CreateKeyTable(mpModelPart->Nodes(), nodes);
+        if (nodes.size() < CONVERT_INDEX_IGA_TO_KRATOS(mpMultiPatch->EquationSystemSize()))
+            KRATOS_THROW_ERROR(std::logic_error, "The model_part does not contain all the nodes of the multipatch. The number of equations is", mpMultiPatch->EquationSystemSize())
 
         // loop through each patch, we construct a map from each function id to the patch id
         for (typename MultiPatch<TDim>::PatchContainerType::iterator it = mpMultiPatch->begin();
@@ -289,24 +533,35 @@ public:
         {
             std::vector<std::size_t> func_ids = it->pFESpace()->FunctionIndices();
 
-            // check if the grid function existed in the patch
-            if (!it->template HasGridFunction<TVariableType>(rVariable))
+            // get the control grids, creating the missing grid functions
+            std::vector<typename ControlGrid<typename TVariableType::Type>::Pointer> control_grids(nvars);
+            for (std::size_t iv = 0; iv < nvars; ++iv)
             {
-                // --> if not then create the new grid function
-                typename ControlGrid<typename TVariableType::Type>::Pointer pNewControlGrid = ControlGridUtility::CreateControlGrid<TDim, TVariableType>(it->pFESpace(), rVariable);
-                it->template CreateGridFunction<TVariableType>(rVariable, pNewControlGrid);
+                if (!it->template HasGridFunction<TVariableType>(*rVariables[iv]))
+                {
+                    typename ControlGrid<typename TVariableType::Type>::Pointer pNewControlGrid = ControlGridUtility::CreateControlGrid<TDim, TVariableType>(it->pFESpace(), *rVariables[iv]);
+                    it->template CreateGridFunction<TVariableType>(*rVariables[iv], pNewControlGrid);
+                }
+
+                control_grids[iv] = it->pGetGridFunction(*rVariables[iv])->pControlGrid();
             }
 
-            // get the control grid
-            typename ControlGrid<typename TVariableType::Type>::Pointer pControlGrid = it->pGetGridFunction(rVariable)->pControlGrid();
+            // set the data for the control grids concurrently
+            const std::size_t n = func_ids.size();
+            int number_of_threads = OpenMPUtils::GetNumThreads();
+            OpenMPUtils::PartitionVector partition;
+            OpenMPUtils::DivideInPartitions(n, number_of_threads, partition);
 
-            // set the data for the control grid
-            for (std::size_t i = 0; i < pControlGrid->size(); ++i)
+            #pragma omp parallel for
+            for (int k = 0; k < number_of_threads; ++k)
             {
-                std::size_t global_id = func_ids[i];
-                std::size_t node_id = CONVERT_INDEX_IGA_TO_KRATOS(global_id);
+                for (std::size_t i = partition[k]; i < partition[k+1]; ++i)
+                {
+                    NodeType& rNode = *nodes[CONVERT_INDEX_IGA_TO_KRATOS(func_ids[i])];
 
-                pControlGrid->SetData(i, mpModelPart->Nodes()[node_id].GetSolutionStepValue(rVariable));
+                    for (std::size_t iv = 0; iv < nvars; ++iv)
+                        control_grids[iv]->SetData(i, rNode.FastGetSolutionStepValue(*rVariables[iv]));
+                }
             }
         }
     }
@@ -323,6 +578,20 @@ public:
         typename TControlGridType::ConstPointer pControlPointGrid,
         TNodeContainerType& rNodes, const std::string& element_name,
         const std::size_t& starting_id, Properties::Pointer p_temp_properties)
+    {
+        typename TFESpace::cell_container_t::Pointer pCellManager;
+        return CreateEntitiesFromFESpace<TEntityType, TFESpace, TControlGridType, TNodeContainerType>(pFESpace,
+            pControlPointGrid, rNodes, element_name, starting_id, p_temp_properties, pCellManager);
+    }
+
+    /// Create entities (elements/conditions) from FESpace, and return the cell manager used to create them
+    /// The i-th entity in the returned container is created from the i-th cell of pCellManager
+    template<class TEntityType, class TFESpace, class TControlGridType, class TNodeContainerType>
+    static PointerVectorSet<TEntityType, IndexedObject> CreateEntitiesFromFESpace(typename TFESpace::ConstPointer pFESpace,
+        typename TControlGridType::ConstPointer pControlPointGrid,
+        TNodeContainerType& rNodes, const std::string& element_name,
+        const std::size_t& starting_id, Properties::Pointer p_temp_properties,
+        typename TFESpace::cell_container_t::Pointer& pCellManager)
     {
         #ifdef ENABLE_PROFILING
         double start = OpenMPUtils::GetCurrentTime();
@@ -330,146 +599,359 @@ public:
 
         // construct the cell manager out from the FESpace
         typedef typename TFESpace::cell_container_t cell_container_t;
-        typename cell_container_t::Pointer pCellManager = pFESpace->ConstructCellManager();
+        pCellManager = pFESpace->ConstructCellManager();
 
         #ifdef ENABLE_PROFILING
         std::cout << "  >> ConstructCellManager: " << OpenMPUtils::GetCurrentTime()-start << " s" << std::endl;
         start = OpenMPUtils::GetCurrentTime();
         #endif
 
-        // container for newly created elements
+        // collect the cells for direct access
+        std::vector<typename cell_container_t::cell_t> cells(pCellManager->begin(), pCellManager->end());
+        std::vector<std::size_t> ids(cells.size());
+        for (std::size_t ic = 0; ic < cells.size(); ++ic)
+            ids[ic] = starting_id + ic;
+
+        std::vector<typename TEntityType::Pointer> new_entities;
+        CreateEntitiesFromCells<TEntityType, TFESpace, TControlGridType, TNodeContainerType>(new_entities, cells, ids,
+            pFESpace, pControlPointGrid, rNodes, element_name, p_temp_properties);
+
+        // add the entities to the container at once; they are in the order of id
         PointerVectorSet<TEntityType, IndexedObject> pNewElements;
+        pNewElements.reserve(new_entities.size());
+        for (std::size_t ic = 0; ic < new_entities.size(); ++ic)
+            pNewElements.push_back(new_entities[ic]);
+
+        #ifdef ENABLE_PROFILING
+        std::cout << "  >> generate entities: " << OpenMPUtils::GetCurrentTime()-start << " s" << std::endl;
+        start = OpenMPUtils::GetCurrentTime();
+        #endif
+
+        return pNewElements;
+    }
 
+    /// Create entities (elements/conditions) from a list of cells of the FESpace. The entities are created concurrently.
+    /// @param rNewEntities the created entities; the i-th entity is created from cells[i] and has the id ids[i]
+    /// @param cells the cells to create the entities
+    /// @param ids the ids of the entities
+    /// @param pFESpace the finite element space of the cells
+    /// @param pControlPointGrid control grid to provide control points
+    /// @param rNodes model_part Nodes to look up for when creating elements
+    /// @param element_name name of the sample element
+    /// @param p_temp_properties the Properties to create new entities
+    template<class TEntityType, class TFESpace, class TControlGridType, class TNodeContainerType, class TCellPointerType>
+    static void CreateEntitiesFromCells(std::vector<typename TEntityType::Pointer>& rNewEntities,
+        const std::vector<TCellPointerType>& cells, const std::vector<std::size_t>& ids,
+        typename TFESpace::ConstPointer pFESpace,
+        typename TControlGridType::ConstPointer pControlPointGrid,
+        TNodeContainerType& rNodes, const std::string& element_name,
+        Properties::Pointer p_temp_properties)
+    {
         // get the sample element
         if(!KratosComponents<TEntityType>::Has(element_name))
         {
             std::stringstream buffer;
             buffer << "Entity (Element/Condition) " << element_name << " is not registered in Kratos.";
             KRATOS_THROW_ERROR(std::invalid_argument, buffer.str(), "");
-            return pNewElements;
         }
 
         TEntityType const& r_clone_element = KratosComponents<TEntityType>::Get(element_name);
 
-        // loop through each cell in the space
-        typename TEntityType::NodesArrayType temp_element_nodes;
-        typename IsogeometricGeometryType::Pointer p_temp_geometry;
-        std::size_t cnt = starting_id;
-        Vector dummy;
+        const std::size_t ncells = cells.size();
+
+        // table to access the nodes directly by their id, since rNodes.find is not thread-safe
+        std::vector<typename TNodeContainerType::pointer> node_table;
+        MultiPatchUtility::CreateKeyTable(rNodes, node_table);
+
         int max_integration_method = 1;
         if (p_temp_properties->Has(NUM_IGA_INTEGRATION_METHOD))
             max_integration_method = (*p_temp_properties)[NUM_IGA_INTEGRATION_METHOD];
 
-        for (typename cell_container_t::iterator it_cell = pCellManager->begin(); it_cell != pCellManager->end(); ++it_cell)
+        // the extraction operators shared by the geometries
+        std::vector<Cell::ExtractionOperatorPointerType> operators;
+        GetExtractionOperators(cells, operators);
+
+        // create the entities concurrently
+        rNewEntities.resize(ncells);
+
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(ncells, number_of_threads, partition);
+        std::vector<std::string> error_messages(number_of_threads);
+
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
         {
-            // KRATOS_WATCH(*(*it_cell))
-            // get new nodes
-            temp_element_nodes.clear();
+            typename TEntityType::NodesArrayType temp_element_nodes;
+            Vector dummy;
 
-            const std::vector<std::size_t>& anchors = (*it_cell)->GetSupportedAnchors();
-            Vector weights(anchors.size());
-            for (std::size_t i = 0; i < anchors.size(); ++i)
+            for (std::size_t ic = partition[k]; ic < partition[k+1]; ++ic)
             {
-                temp_element_nodes.push_back(( *(MultiPatchUtility::FindKey(rNodes, CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]), "Node").base())));
-                weights[i] = pControlPointGrid->GetData(pFESpace->LocalId(anchors[i])).W();
+                const TCellPointerType& p_cell = cells[ic];
+
+                // get new nodes
+                temp_element_nodes.clear();
+
+                const std::vector<std::size_t>& anchors = p_cell->GetSupportedAnchors();
+                Vector weights(anchors.size());
+                for (std::size_t i = 0; i < anchors.size(); ++i)
+                {
+                    const std::size_t node_id = CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]);
+                    if ((node_id >= node_table.size()) || (node_table[node_id] == NULL))
+                    {
+                        std::stringstream buffer;
+                        buffer << "Node #" << node_id << " is not found.";
+                        error_messages[k] = buffer.str();
+                        break;
+                    }
+                    temp_element_nodes.push_back(node_table[node_id]);
+                    weights[i] = pControlPointGrid->GetData(pFESpace->LocalId(anchors[i])).W();
+                }
+                if (!error_messages[k].empty())
+                    break;
+
+                #ifdef DEBUG_GEN_ENTITY
+                #pragma omp critical(MultiPatchModelPart_DebugGenEntity)
+                {
+                    std::cout << "anchors:";
+                    for (std::size_t i = 0; i < anchors.size(); ++i)
+                        std::cout << " " << CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]);
+                    std::cout << std::endl;
+                    KRATOS_WATCH(weights)
+                    KRATOS_WATCH(p_cell->GetCompressedExtractionOperator())
+                    KRATOS_WATCH(pFESpace->Order(0))
+                    KRATOS_WATCH(pFESpace->Order(1))
+                    KRATOS_WATCH(pFESpace->Order(2))
+                }
+                #endif
+
+                // create the geometry
+                typename IsogeometricGeometryType::Pointer p_temp_geometry
+                    = boost::dynamic_pointer_cast<IsogeometricGeometryType>(r_clone_element.GetGeometry().Create(temp_element_nodes));
+                if (p_temp_geometry == NULL)
+                {
+                    error_messages[k] = "The cast to IsogeometricGeometry is failed.";
+                    break;
+                }
+
+                // for tensor-product cell, the extraction operator is passed in factored form; the geometry shares the factors of the cell
+                const BCell* p_bcell = dynamic_cast<const BCell*>(&(*p_cell));
+                if ((p_bcell != NULL) && (p_bcell->GetExtractionOperatorFactors().size() == 3))
+                {
+                    const std::vector<BCell::ExtractionOperatorPointerType>& C = p_bcell->GetExtractionOperatorFactors();
+                    p_temp_geometry->AssignGeometryData(dummy,
+                                                        dummy,
+                                                        dummy,
+                                                        weights,
+                                                        C[0],
+                                                        C[1],
+                                                        C[2],
+                                                        static_cast<int>(pFESpace->Order(0)),
+                                                        static_cast<int>(pFESpace->Order(1)),
+                                                        static_cast<int>(pFESpace->Order(2)),
+                                                        max_integration_method);
+                }
+                else
+                {
+                    p_temp_geometry->AssignGeometryData(dummy,
+                                                        dummy,
+                                                        dummy,
+                                                        weights,
+                                                        operators[ic], // the geometry shares the extraction operator of the cell
+                                                        static_cast<int>(pFESpace->Order(0)),
+                                                        static_cast<int>(pFESpace->Order(1)),
+                                                        static_cast<int>(pFESpace->Order(2)),
+                                                        max_integration_method);
+                }
+
+                #ifdef DEBUG_GEN_ENTITY
+                #pragma omp critical(MultiPatchModelPart_DebugGenEntity)
+                for (int irule = 0; irule < max_integration_method; ++irule)
+                {
+                    std::cout << "integration points for rule " << irule << ":" << std::endl;
+                    typedef typename IsogeometricGeometryType::IntegrationPointsArrayType IntegrationPointsArrayType;
+                    const IntegrationPointsArrayType& integration_points = p_temp_geometry->IntegrationPoints((GeometryData::IntegrationMethod) irule);
+                    for (std::size_t i = 0; i < integration_points.size(); ++i)
+                        std::cout << " " << i << ": " << integration_points[i] << std::endl;
+                }
+                #endif
+
+                // create the element
+                typename TEntityType::Pointer pNewElement = r_clone_element.Create(ids[ic], p_temp_geometry, p_temp_properties);
+                pNewElement->SetValue(ACTIVATION_LEVEL, 0);
+                #ifdef IS_INACTIVE
+                pNewElement->SetValue(IS_INACTIVE, false);
+                #endif
+                pNewElement->Set(ACTIVE, true);
+
+                // assign the knot range of the cell
+                if (p_bcell != NULL)
+                    AssignKnotRange(*pNewElement, *p_bcell);
+                else
+                {
+                    const TCell* p_tcell = dynamic_cast<const TCell*>(&(*p_cell));
+                    if (p_tcell != NULL)
+                        AssignKnotRange(*pNewElement, *p_tcell);
+                }
+
+                #ifdef DEBUG_GEN_ENTITY
+                #pragma omp critical(MultiPatchModelPart_DebugGenEntity)
+                {
+                    std::cout << "Entity " << element_name << " " << pNewElement->Id() << " is created" << std::endl;
+                    std::cout << "  Connectivity:";
+                    for (unsigned int i = 0; i < p_temp_geometry->size(); ++i)
+                        std::cout << " " << (*p_temp_geometry)[i].Id();
+                    std::cout << std::endl;
+                }
+                #endif
+
+                rNewEntities[ic] = pNewElement;
             }
+        }
 
-            #ifdef DEBUG_GEN_ENTITY
-            std::cout << "anchors:";
-            for (std::size_t i = 0; i < anchors.size(); ++i)
-                std::cout << " " << CONVERT_INDEX_IGA_TO_KRATOS(anchors[i]);
-            std::cout << std::endl;
-            KRATOS_WATCH(weights)
-            // KRATOS_WATCH((*it_cell)->GetExtractionOperator())
-            KRATOS_WATCH((*it_cell)->GetCompressedExtractionOperator())
-            KRATOS_WATCH(pFESpace->Order(0))
-            KRATOS_WATCH(pFESpace->Order(1))
-            KRATOS_WATCH(pFESpace->Order(2))
-            #endif
-
-            // create the geometry
-            p_temp_geometry = boost::dynamic_pointer_cast<IsogeometricGeometryType>(r_clone_element.GetGeometry().Create(temp_element_nodes));
-            if (p_temp_geometry == NULL)
-                KRATOS_THROW_ERROR(std::runtime_error, "The cast to IsogeometricGeometry is failed.", "")
-
-            p_temp_geometry->AssignGeometryData(dummy,
-                                                dummy,
-                                                dummy,
-                                                weights,
-                                                // (*it_cell)->GetExtractionOperator(),
-                                                (*it_cell)->GetCompressedExtractionOperator(),
-                                                static_cast<int>(pFESpace->Order(0)),
-                                                static_cast<int>(pFESpace->Order(1)),
-                                                static_cast<int>(pFESpace->Order(2)),
-                                                max_integration_method);
-
-            #ifdef DEBUG_GEN_ENTITY
-            for (int irule = 0; irule < max_integration_method; ++irule)
-            {
-                std::cout << "integration points for rule " << irule << ":" << std::endl;
-                typedef typename IsogeometricGeometryType::IntegrationPointsArrayType IntegrationPointsArrayType;
-                const IntegrationPointsArrayType& integration_points = p_temp_geometry->IntegrationPoints((GeometryData::IntegrationMethod) irule);
-                for (std::size_t i = 0; i < integration_points.size(); ++i)
-                    std::cout << " " << i << ": " << integration_points[i] << std::endl;
-            }
-            #endif
-
-            // create the element and add to the list
-            typename TEntityType::Pointer pNewElement = r_clone_element.Create(cnt++, p_temp_geometry, p_temp_properties);
-            pNewElement->SetValue(ACTIVATION_LEVEL, 0);
-            #ifdef IS_INACTIVE
-            pNewElement->SetValue(IS_INACTIVE, false);
-            #endif
-            pNewElement->Set(ACTIVE, true);
-            pNewElements.push_back(pNewElement);
-
-            //////////
-            try
-            {
-                BCell& c = dynamic_cast<BCell&>(**it_cell);
-                pNewElement->SetValue( KNOT_LEFT, c.XiMinValue() );
-                pNewElement->SetValue( KNOT_RIGHT, c.XiMaxValue() );
-                pNewElement->SetValue( KNOT_BOTTOM, c.EtaMinValue() );
-                pNewElement->SetValue( KNOT_TOP, c.EtaMaxValue() );
-                pNewElement->SetValue( KNOT_FRONT, c.ZetaMinValue() );
-                pNewElement->SetValue( KNOT_BACK, c.ZetaMaxValue() );
-            }
-            catch (std::bad_cast& bc)
-            {
-                std::cout << "WARNING: cell " << (*it_cell)->Id() << " cannot be casted to BCell" << std::endl;
-            }
+        for (int k = 0; k < number_of_threads; ++k)
+            if (!error_messages[k].empty())
+                KRATOS_THROW_ERROR(std::invalid_argument, error_messages[k], "")
+    }
+
+    /// Get the extraction operator to be given to the geometry created from each cell. The cells having the same operator share
+    /// the same instance. The tensor-product cell in 3D passes its factors to the geometry instead, hence its operator is left empty.
+    /// The operators are built concurrently without locking, each thread deduplicating its own; they are merged afterward, with one lock per arena.
+    template<class TCellPointerType>
+    static void GetExtractionOperators(const std::vector<TCellPointerType>& cells, std::vector<Cell::ExtractionOperatorPointerType>& rOperators)
+    {
+        typedef ExtractionOperatorArena::IndexType IndexType;
+        typedef std::pair<ExtractionOperatorArena*, std::vector<IndexType> > RowsKeyType;
+        typedef std::vector<const Matrix*> FactorsKeyType;
 
-            try
+        const std::size_t ncells = cells.size();
+        rOperators.resize(ncells);
+
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(ncells, number_of_threads, partition);
+
+        // the distinct operators built by each thread, and the position of the operator of each cell in there
+        std::vector<std::vector<OperatorEntry> > local_operators(number_of_threads);
+        std::vector<int> positions(ncells, -1);
+
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
+        {
+            std::map<RowsKeyType, std::size_t> rows_positions;
+            std::map<FactorsKeyType, std::size_t> factors_positions;
+            std::vector<OperatorEntry>& r_operators = local_operators[k];
+
+            for (std::size_t ic = partition[k]; ic < partition[k+1]; ++ic)
             {
-                TCell& c = dynamic_cast<TCell&>(**it_cell);
-                pNewElement->SetValue( KNOT_LEFT, c.XiMinValue() );
-                pNewElement->SetValue( KNOT_RIGHT, c.XiMaxValue() );
-                pNewElement->SetValue( KNOT_BOTTOM, c.EtaMinValue() );
-                pNewElement->SetValue( KNOT_TOP, c.EtaMaxValue() );
-                pNewElement->SetValue( KNOT_FRONT, c.ZetaMinValue() );
-                pNewElement->SetValue( KNOT_BACK, c.ZetaMaxValue() );
+                const TCellPointerType& p_cell = cells[ic];
+
+                if (!p_cell->HasCrowsInArena())
+                {
+                    const std::vector<BCell::ExtractionOperatorPointerType>& factors
+                        = dynamic_cast<const BCell&>(*p_cell).GetExtractionOperatorFactors();
+                    if (factors.size() == 3)
+                        continue;
+
+                    FactorsKeyType key(factors.size());
+                    for (std::size_t dim = 0; dim < factors.size(); ++dim)
+                        key[dim] = factors[dim].get();
+
+                    typename std::map<FactorsKeyType, std::size_t>::iterator it = factors_positions.find(key);
+                    if (it == factors_positions.end())
+                    {
+                        it = factors_positions.insert(std::make_pair(key, r_operators.size())).first;
+                        r_operators.push_back(OperatorEntry());
+                        r_operators.back().Factors = key;
+                        r_operators.back().pOperator = new Matrix(p_cell->GetExtractionOperator());
+                    }
+                    positions[ic] = it->second;
+                }
+                else
+                {
+                    RowsKeyType key(p_cell->pGetExtractionOperatorArena().get(), p_cell->GetCrowIds());
+
+                    typename std::map<RowsKeyType, std::size_t>::iterator it = rows_positions.find(key);
+                    if (it == rows_positions.end())
+                    {
+                        it = rows_positions.insert(std::make_pair(key, r_operators.size())).first;
+                        r_operators.push_back(OperatorEntry());
+                        r_operators.back().pArena = p_cell->pGetExtractionOperatorArena();
+                        r_operators.back().Rows = key.second;
+                        r_operators.back().pOperator = new Matrix(p_cell->GetExtractionOperator());
+                    }
+                    positions[ic] = it->second;
+                }
             }
-            catch (std::bad_cast& bc)
+        }
+
+        // merge the operators of the threads; the ones from the same arena are merged at once
+        std::map<FactorsKeyType, Cell::ExtractionOperatorPointerType> factored_operators;
+        std::map<ExtractionOperatorArena*, std::vector<OperatorEntry*> > arena_operators;
+        for (int k = 0; k < number_of_threads; ++k)
+        {
+            for (std::size_t i = 0; i < local_operators[k].size(); ++i)
             {
-                std::cout << "WARNING: cell " << (*it_cell)->Id() << " cannot be casted to TCell" << std::endl;
+                OperatorEntry& r_entry = local_operators[k][i];
+                if (r_entry.pArena != NULL)
+                {
+                    arena_operators[r_entry.pArena.get()].push_back(&r_entry);
+                    continue;
+                }
+
+                if (!r_entry.Factors.empty())
+                {
+                    typename std::map<FactorsKeyType, Cell::ExtractionOperatorPointerType>::iterator it = factored_operators.find(r_entry.Factors);
+                    if (it != factored_operators.end())
+                    {
+                        delete r_entry.pOperator;
+                        r_entry.pSharedOperator = it->second;
+                        continue;
+                    }
+                }
+
+                // the cell without arena owns its operator
+                r_entry.pSharedOperator = Cell::ExtractionOperatorPointerType(r_entry.pOperator);
+                if (!r_entry.Factors.empty())
+                    factored_operators[r_entry.Factors] = r_entry.pSharedOperator;
             }
-            //////////
+        }
 
-            std::cout << "Entity " << element_name << " " << pNewElement->Id() << " is created" << std::endl;
-            std::cout << "  Connectivity:";
-            for (unsigned int i = 0; i < p_temp_geometry->size(); ++i)
+        for (typename std::map<ExtractionOperatorArena*, std::vector<OperatorEntry*> >::iterator it = arena_operators.begin();
+                it != arena_operators.end(); ++it)
+        {
+            const std::vector<OperatorEntry*>& r_entries = it->second;
+            std::vector<const std::vector<IndexType>*> rows_list(r_entries.size());
+            std::vector<Matrix*> matrices(r_entries.size());
+            for (std::size_t i = 0; i < r_entries.size(); ++i)
             {
-                std::cout << " " << (*p_temp_geometry)[i].Id();
+                rows_list[i] = &(r_entries[i]->Rows);
+                matrices[i] = r_entries[i]->pOperator;
             }
-            std::cout << std::endl;
+
+            std::vector<Cell::ExtractionOperatorPointerType> shared_operators;
+            ExtractionOperatorArena::MergeOperators(r_entries[0]->pArena, rows_list, matrices, shared_operators);
+            for (std::size_t i = 0; i < r_entries.size(); ++i)
+                r_entries[i]->pSharedOperator = shared_operators[i];
         }
 
-        #ifdef ENABLE_PROFILING
-        std::cout << "  >> generate entities: " << OpenMPUtils::GetCurrentTime()-start << " s" << std::endl;
-        start = OpenMPUtils::GetCurrentTime();
-        #endif
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
+            for (std::size_t ic = partition[k]; ic < partition[k+1]; ++ic)
+                if (positions[ic] >= 0)
+                    rOperators[ic] = local_operators[k][positions[ic]].pSharedOperator;
+    }
 
-        return pNewElements;
+    /// Assign the knot range of the cell to the entity
+    template<class TEntityType, class TCellType>
+    static void AssignKnotRange(TEntityType& rEntity, const TCellType& rCell)
+    {
+        rEntity.SetValue( KNOT_LEFT, rCell.XiMinValue() );
+        rEntity.SetValue( KNOT_RIGHT, rCell.XiMaxValue() );
+        rEntity.SetValue( KNOT_BOTTOM, rCell.EtaMinValue() );
+        rEntity.SetValue( KNOT_TOP, rCell.EtaMaxValue() );
+        rEntity.SetValue( KNOT_FRONT, rCell.ZetaMinValue() );
+        rEntity.SetValue( KNOT_BACK, rCell.ZetaMaxValue() );
     }
 
     /// Information
@@ -488,11 +970,221 @@ public:
 
 private:
 
+    /// Extraction operator built by a thread, see GetExtractionOperators
+    struct OperatorEntry
+    {
+        ExtractionOperatorArena::Pointer pArena; // the arena of the rows, if the operator is made of rows
+        std::vector<ExtractionOperatorArena::IndexType> Rows;
+        std::vector<const Matrix*> Factors; // the factors, if the operator is the Kronecker product of 1D operators
+        Matrix* pOperator; // the operator built by the thread
+        Cell::ExtractionOperatorPointerType pSharedOperator; // the operator shared after merging
+    };
+
+    typedef std::vector<long long> FunctionKeyType; // the patch id and the quantized local knot vectors of a basis function
+    typedef boost::array<long long, 6> CellKeyType;
+
+    /// Snapshot of a cell used to create an entity, to find the unchanged cells after refinement.
+    /// The extraction operator is not kept: it is determined by the knot range and the local knot vectors of the anchors.
+    struct CellSnapshot
+    {
+        bool HasKey;
+        CellKeyType Key; // the knot range
+        std::vector<std::size_t> Anchors;
+    };
+
+    /// Record of the entities created by AddElements/AddConditions, in the order of the cells
+    template<class TEntityType>
+    struct EntityRecord
+    {
+        std::size_t PatchId;
+        int Side; // the boundary side if the entities are created on the boundary of the patch, otherwise -1
+        std::string Name;
+        std::size_t StartingId;
+        Properties::Pointer pProperties;
+        std::vector<CellSnapshot> Cells;
+        std::vector<typename TEntityType::Pointer> Entities;
+    };
+
     bool mIsModelPartReady;
 
     ModelPart::Pointer mpModelPart;
     typename MultiPatch<TDim>::Pointer mpMultiPatch;
 
+    std::vector<FunctionKeyType> mFunctionKeys; // the key of the basis function of each equation, empty if it is not provided
+    std::vector<EntityRecord<Element> > mElementRecords;
+    std::vector<EntityRecord<Condition> > mConditionRecords;
+    std::map<std::size_t, std::size_t> mMovedEquationIds;
+
+    /// Check that the variables are in the nodal solution step variables list, to access the nodal values without check
+    template<class TVariableType>
+    void CheckSolutionStepVariables(const std::vector<const TVariableType*>& rVariables) const
+    {
+        for (std::size_t iv = 0; iv < rVariables.size(); ++iv)
+            if (!mpModelPart->GetNodalSolutionStepVariablesList().Has(*rVariables[iv]))
+                KRATOS_THROW_ERROR(std::logic_error, "The variable is not in the nodal solution step variables list of the model_part:", rVariables[iv]->Name())
+    }
+
+    /// Quantize the value to compare the values up to the tolerance
+    static long long Quantize(const double& v)
+    {
+        return static_cast<long long>(std::floor(v / 1.0e-10 + 0.5));
+    }
+
+    /// Get the key of a basis function from its patch and its local knot vectors; the key is empty if the FESpace does not provide them
+    static void GetFunctionKey(const std::size_t& PatchId, const FESpace<TDim>& rFESpace, const std::size_t& LocalId, FunctionKeyType& rKey)
+    {
+        rKey.clear();
+
+        std::vector<std::vector<double> > knots;
+        if (!rFESpace.GetLocalKnotVectors(LocalId, knots))
+            return;
+
+        rKey.push_back(static_cast<long long>(PatchId));
+        for (std::size_t dim = 0; dim < knots.size(); ++dim)
+        {
+            rKey.push_back(static_cast<long long>(knots[dim].size()));
+            for (std::size_t i = 0; i < knots[dim].size(); ++i)
+                rKey.push_back(Quantize(knots[dim][i]));
+        }
+    }
+
+    /// Get the knot range of the cell; return false if the cell does not provide it
+    static bool GetCellKey(const Cell& rCell, CellKeyType& rKey)
+    {
+        if (const BCell* p_bcell = dynamic_cast<const BCell*>(&rCell))
+            return GetKnotRangeKey(*p_bcell, rKey);
+        if (const TCell* p_tcell = dynamic_cast<const TCell*>(&rCell))
+            return GetKnotRangeKey(*p_tcell, rKey);
+        return false;
+    }
+
+    template<class TCellType>
+    static bool GetKnotRangeKey(const TCellType& rCell, CellKeyType& rKey)
+    {
+        rKey[0] = Quantize(rCell.XiMinValue());
+        rKey[1] = Quantize(rCell.XiMaxValue());
+        rKey[2] = Quantize(rCell.EtaMinValue());
+        rKey[3] = Quantize(rCell.EtaMaxValue());
+        rKey[4] = Quantize(rCell.ZetaMinValue());
+        rKey[5] = Quantize(rCell.ZetaMaxValue());
+        return true;
+    }
+
+    static CellSnapshot TakeSnapshot(const Cell& rCell)
+    {
+        CellSnapshot snapshot;
+        snapshot.HasKey = GetCellKey(rCell, snapshot.Key);
+        snapshot.Anchors = rCell.GetSupportedAnchors();
+        return snapshot;
+    }
+
+    /// Check if the cell is the same as the snapshot, up to the renumbering of the anchors. The anchors are matched by their
+    /// local knot vectors, hence the extraction operator of the cell is unchanged if its anchors are.
+    static bool IsSameCell(const Cell& rCell, const CellSnapshot& rSnapshot, const std::vector<std::size_t>& new_to_old)
+    {
+        const std::vector<std::size_t>& anchors = rCell.GetSupportedAnchors();
+        if (anchors.size() != rSnapshot.Anchors.size())
+            return false;
+
+        for (std::size_t i = 0; i < anchors.size(); ++i)
+            if ((anchors[i] >= new_to_old.size()) || (new_to_old[anchors[i]] != rSnapshot.Anchors[i]))
+                return false;
+
+        return true;
+    }
+
+    template<class TEntityType, class TCellContainerType>
+    static EntityRecord<TEntityType> CreateRecord(const std::size_t& PatchId, const int& Side, const std::string& Name,
+        const std::size_t& StartingId, Properties::Pointer pProperties, const TCellContainerType& rCells,
+        const PointerVectorSet<TEntityType, IndexedObject>& rEntities)
+    {
+        EntityRecord<TEntityType> record;
+        record.PatchId = PatchId;
+        record.Side = Side;
+        record.Name = Name;
+        record.StartingId = StartingId;
+        record.pProperties = pProperties;
+        for (typename TCellContainerType::const_iterator it = rCells.begin(); it != rCells.end(); ++it)
+            record.Cells.push_back(TakeSnapshot(**it));
+        record.Entities.assign(rEntities.ptr_begin(), rEntities.ptr_end());
+        return record;
+    }
+
+    /// Update the entities of a record from the refined patch, keeping the entities of the unchanged cells
+    /// @return the number of kept entities
+    template<class TEntityType>
+    std::size_t UpdateEntities(EntityRecord<TEntityType>& rRecord, const std::vector<std::size_t>& new_to_old, const std::size_t& starting_id)
+    {
+        typename Patch<TDim>::Pointer pPatch = mpMultiPatch->pGetPatch(rRecord.PatchId);
+
+        if (rRecord.Side < 0)
+        {
+            return this->template UpdateEntities<TEntityType, FESpace<TDim> >(rRecord, pPatch->pFESpace(),
+                pPatch->ControlPointGridFunction().pControlGrid(), new_to_old, starting_id);
+        }
+        else
+        {
+            typename Patch<TDim-1>::Pointer pBoundaryPatch = pPatch->ConstructBoundaryPatch(static_cast<BoundarySide>(rRecord.Side));
+            return this->template UpdateEntities<TEntityType, FESpace<TDim-1> >(rRecord, pBoundaryPatch->pFESpace(),
+                pBoundaryPatch->ControlPointGridFunction().pControlGrid(), new_to_old, starting_id);
+        }
+    }
+
+    template<class TEntityType, class TFESpace>
+    std::size_t UpdateEntities(EntityRecord<TEntityType>& rRecord, typename TFESpace::ConstPointer pFESpace,
+        typename ControlGrid<ControlPointType>::ConstPointer pControlPointGrid,
+        const std::vector<std::size_t>& new_to_old, const std::size_t& starting_id)
+    {
+        typedef typename TFESpace::cell_container_t cell_container_t;
+        typedef typename cell_container_t::cell_t cell_t;
+
+        typename cell_container_t::Pointer pCellManager = pFESpace->ConstructCellManager();
+        std::vector<cell_t> cells(pCellManager->begin(), pCellManager->end());
+
+        // index the old cells by their knot range
+        std::map<CellKeyType, std::size_t> old_cells;
+        for (std::size_t i = 0; i < rRecord.Cells.size(); ++i)
+            if (rRecord.Cells[i].HasKey)
+                old_cells[rRecord.Cells[i].Key] = i;
+
+        // keep the entities of the unchanged cells and collect the cells to create the new entities
+        std::vector<typename TEntityType::Pointer> entities(cells.size());
+        std::vector<cell_t> new_cells;
+        std::vector<std::size_t> new_ids, new_positions;
+        for (std::size_t ic = 0; ic < cells.size(); ++ic)
+        {
+            CellKeyType key;
+            if (GetCellKey(*cells[ic], key))
+            {
+                typename std::map<CellKeyType, std::size_t>::iterator it = old_cells.find(key);
+                if ((it != old_cells.end()) && IsSameCell(*cells[ic], rRecord.Cells[it->second], new_to_old))
+                {
+                    entities[ic] = rRecord.Entities[it->second];
+                    entities[ic]->SetId(starting_id + ic);
+                    continue;
+                }
+            }
+
+            new_cells.push_back(cells[ic]);
+            new_ids.push_back(starting_id + ic);
+            new_positions.push_back(ic);
+        }
+
+        std::vector<typename TEntityType::Pointer> new_entities;
+        CreateEntitiesFromCells<TEntityType, TFESpace, ControlGrid<ControlPointType>, ModelPart::NodesContainerType>(new_entities,
+            new_cells, new_ids, pFESpace, pControlPointGrid, mpModelPart->Nodes(), rRecord.Name, rRecord.pProperties);
+        for (std::size_t i = 0; i < new_entities.size(); ++i)
+            entities[new_positions[i]] = new_entities[i];
+
+        // refresh the record
+        rRecord.Cells.resize(cells.size());
+        for (std::size_t ic = 0; ic < cells.size(); ++ic)
+            rRecord.Cells[ic] = TakeSnapshot(*cells[ic]);
+        rRecord.Entities.swap(entities);
+
+        return cells.size() - new_cells.size();
+    }
+
 };
 
 /// output stream function
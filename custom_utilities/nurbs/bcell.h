@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <algorithm>
 
 // External includes
 
@@ -92,6 +93,181 @@ public:
     int ZetaMinIndex() const {return mpZetaMin->Index();}
     double ZetaMinValue() const {return mpZetaMin->Value();}
 
+    /// Clear internal data of this cell
+    virtual void Reset()
+    {
+        BaseType::Reset();
+        mExtractionOperatorFactors.clear();
+    }
+
+    /// Add supported anchor and the respective extraction operator of this cell to the anchor.
+    /// The factored extraction operator is not valid anymore if a row is given, hence it is expanded to the arena before.
+    virtual void AddAnchor(const std::size_t& Id, const double& W, const Vector& Crow)
+    {
+        if (this->HasExtractionOperatorFactors())
+            this->ExpandExtractionOperatorFactors();
+        BaseType::AddAnchor(Id, W, Crow);
+    }
+
+    /// Add supported anchor without the extraction operator. This is only applicable for the tensor-product cell,
+    /// for which the row of the extraction operator is given by the factors, following the order of the anchors.
+    void AddAnchor(const std::size_t& Id, const double& W)
+    {
+        if (!this->HasExtractionOperatorFactors())
+            KRATOS_THROW_ERROR(std::logic_error, "The extraction operator factors must be set before adding anchor without extraction operator row to cell", this->Id())
+
+        mSupportedAnchors.push_back(Id);
+        mAnchorWeights.push_back(W);
+    }
+
+    /// Absorb the information from the other cell. The factored extraction operator is not valid anymore if new anchors are added,
+    /// hence it is expanded to the arena before.
+    virtual void Absorb(Cell::Pointer pOther)
+    {
+        if (this->HasExtractionOperatorFactors())
+        {
+            for (std::size_t i = 0; i < pOther->NumberOfAnchors(); ++i)
+            {
+                if (std::find(mSupportedAnchors.begin(), mSupportedAnchors.end(), pOther->GetSupportedAnchors()[i]) == mSupportedAnchors.end())
+                {
+                    this->ExpandExtractionOperatorFactors();
+                    break;
+                }
+            }
+        }
+
+        BaseType::Absorb(pOther);
+    }
+
+    /// Set the 1D extraction operators on each parametric direction. This is only applicable for tensor-product cell,
+    /// for which the extraction operator is the Kronecker product C1 x C2 (x C3), with the first direction varying slowest.
+    /// Only the factors are kept, shared with the other cells on the same knot span; the rows of the extraction operator are computed on demand.
+    void SetExtractionOperatorFactors(ExtractionOperatorPointerType pC1)
+    {
+        mExtractionOperatorFactors.resize(1);
+        mExtractionOperatorFactors[0] = pC1;
+        this->ReleaseCrows();
+    }
+
+    /// Set the 1D extraction operators on each parametric direction. See above.
+    void SetExtractionOperatorFactors(ExtractionOperatorPointerType pC1, ExtractionOperatorPointerType pC2)
+    {
+        mExtractionOperatorFactors.resize(2);
+        mExtractionOperatorFactors[0] = pC1;
+        mExtractionOperatorFactors[1] = pC2;
+        this->ReleaseCrows();
+    }
+
+    /// Set the 1D extraction operators on each parametric direction. See above.
+    void SetExtractionOperatorFactors(ExtractionOperatorPointerType pC1, ExtractionOperatorPointerType pC2, ExtractionOperatorPointerType pC3)
+    {
+        mExtractionOperatorFactors.resize(3);
+        mExtractionOperatorFactors[0] = pC1;
+        mExtractionOperatorFactors[1] = pC2;
+        mExtractionOperatorFactors[2] = pC3;
+        this->ReleaseCrows();
+    }
+
+    /// Check if the factored form of the extraction operator is available
+    bool HasExtractionOperatorFactors() const {return !mExtractionOperatorFactors.empty();}
+
+    /// Get the 1D extraction operators on each parametric direction
+    const std::vector<ExtractionOperatorPointerType>& GetExtractionOperatorFactors() const {return mExtractionOperatorFactors;}
+
+    /// Get row i of the extraction operator
+    virtual void GetCrow(const std::size_t& i, Vector& rCrow) const
+    {
+        if (!this->HasExtractionOperatorFactors())
+            return BaseType::GetCrow(i, rCrow);
+
+        std::size_t size = 1;
+        for (std::size_t dim = 0; dim < mExtractionOperatorFactors.size(); ++dim)
+            size *= mExtractionOperatorFactors[dim]->size2();
+        if (rCrow.size() != size)
+            rCrow.resize(size, false);
+
+        // local index of the row on each direction; the first direction is the outermost
+        std::size_t u[3];
+        std::size_t tmp = i;
+        for (int dim = mExtractionOperatorFactors.size()-1; dim >= 0; --dim)
+        {
+            u[dim] = tmp % mExtractionOperatorFactors[dim]->size1();
+            tmp /= mExtractionOperatorFactors[dim]->size1();
+        }
+
+        // row i of the Kronecker product C1 x C2 (x C3). The entries are expanded in place from the back, so that they are read before being overwritten.
+        rCrow[0] = 1.0;
+        size = 1;
+        for (std::size_t dim = 0; dim < mExtractionOperatorFactors.size(); ++dim)
+        {
+            const Matrix& rC = *mExtractionOperatorFactors[dim];
+            const std::size_t m = rC.size2();
+            for (std::size_t j = size; j > 0; --j)
+            {
+                const double v = rCrow[j-1];
+                for (std::size_t a = m; a > 0; --a)
+                    rCrow[(j-1)*m + a-1] = v * rC(u[dim], a-1);
+            }
+            size *= m;
+        }
+    }
+
+    /// Check if the extraction operator of this cell is stored row by row in the arena
+    virtual bool HasCrowsInArena() const {return !this->HasExtractionOperatorFactors();}
+
+    /// Get the extraction operator matrix
+    virtual Matrix GetExtractionOperator() const
+    {
+        if (!this->HasExtractionOperatorFactors())
+            return BaseType::GetExtractionOperator();
+
+        Matrix M;
+        this->ComputeExtractionOperator(M);
+        return M;
+    }
+
+    /// Get the extraction as compressed matrix
+    virtual CompressedMatrix GetCompressedExtractionOperator() const
+    {
+        if (!this->HasExtractionOperatorFactors())
+            return BaseType::GetCompressedExtractionOperator();
+
+        Matrix M;
+        this->ComputeExtractionOperator(M);
+        CompressedMatrix CM(M.size1(), M.size2());
+        for (std::size_t i = 0; i < M.size1(); ++i)
+            for (std::size_t j = 0; j < M.size2(); ++j)
+                if (M(i, j) != 0.0)
+                    CM.push_back(i, j, M(i, j));
+        CM.complete_index1_data();
+        return CM;
+    }
+
+    /// Get the extraction operator as CSR triplet
+    virtual void GetExtractionOperator(std::vector<int>& rowPtr, std::vector<int>& colInd, std::vector<double>& values) const
+    {
+        if (!this->HasExtractionOperatorFactors())
+            return BaseType::GetExtractionOperator(rowPtr, colInd, values);
+
+        int cnt = 0;
+        rowPtr.push_back(cnt);
+        Vector Crow;
+        for (std::size_t i = 0; i < this->NumberOfAnchors(); ++i)
+        {
+            this->GetCrow(i, Crow);
+            for (std::size_t k = 0; k < Crow.size(); ++k)
+            {
+                if (Crow[k] != 0.0)
+                {
+                    colInd.push_back(k);
+                    values.push_back(Crow[k]);
+                    ++cnt;
+                }
+            }
+            rowPtr.push_back(cnt);
+        }
+    }
+
     /// Check if the cell is covered by knot spans; the comparison is based on indexing, so the knot vectors must be sorted a priori
     template<typename TIndexType>
     bool IsCovered(const std::vector<TIndexType>& rKnotsIndex1) const
@@ -215,6 +391,49 @@ private:
     knot_t mpEtaMin;
     knot_t mpZetaMax;
     knot_t mpZetaMin;
+
+    std::vector<ExtractionOperatorPointerType> mExtractionOperatorFactors; // 1D extraction operators on each parametric direction, empty if not tensor-product
+
+    /// Compute the extraction operator from the factors
+    void ComputeExtractionOperator(Matrix& rC) const
+    {
+        std::size_t size = 1;
+        for (std::size_t dim = 0; dim < mExtractionOperatorFactors.size(); ++dim)
+            size *= mExtractionOperatorFactors[dim]->size2();
+        rC.resize(this->NumberOfAnchors(), size, false);
+
+        Vector Crow;
+        for (std::size_t i = 0; i < this->NumberOfAnchors(); ++i)
+        {
+            this->GetCrow(i, Crow);
+            noalias(row(rC, i)) = Crow;
+        }
+    }
+
+    /// Give the rows in the arena back, if any. They are superseded by the factors.
+    void ReleaseCrows()
+    {
+        if (mpArena != NULL)
+            mpArena->ReleaseRows(mCrowIds);
+        mCrowIds.clear();
+    }
+
+    /// Move the rows of the factored extraction operator to the arena, and discard the factors
+    void ExpandExtractionOperatorFactors()
+    {
+        if (mpArena == NULL)
+            mpArena = ArenaType::Pointer(new ArenaType());
+
+        Vector Crow;
+        mCrowIds.resize(this->NumberOfAnchors());
+        for (std::size_t i = 0; i < this->NumberOfAnchors(); ++i)
+        {
+            this->GetCrow(i, Crow);
+            mCrowIds[i] = mpArena->AddRow(Crow);
+        }
+
+        mExtractionOperatorFactors.clear();
+    }
 };
 
 template<>
@@ -83,6 +83,13 @@ public:
         KRATOS_THROW_ERROR(std::logic_error, "Calling the virtual function", __FUNCTION__)
     }
 
+    /// Insert a list of cells to the container at once
+    virtual void insert(const std::vector<cell_t>& p_cells)
+    {
+        for (std::size_t i = 0; i < p_cells.size(); ++i)
+            this->insert(p_cells[i]);
+    }
+
     /// Iterators
     iterator begin() {return mpCells.begin();}
     const_iterator begin() const {return mpCells.begin();}
@@ -303,14 +310,11 @@ public:
     /// Insert a cell to the container. If the cell is existed in the container, the iterator of the existed one will be returned.
     virtual iterator insert(cell_t p_cell)
     {
-        // search in the list of cell if any cell has the same knot span
-        // Currently I use the brute-force approach. I know it is not efficient. I will improve it in the future. TODO
-        for(iterator it = BaseType::mpCells.begin(); it != BaseType::mpCells.end(); ++it)
-            if(*it == p_cell)
-                return it;
-
-        // otherwise insert new cell
-        iterator it = BaseType::mpCells.insert(p_cell).first;
+        // if the cell is existed in the container, return it; otherwise insert new cell
+        std::pair<iterator, bool> res = BaseType::mpCells.insert(p_cell);
+        if (!res.second)
+            return res.first;
+        iterator it = res.first;
         SuperType::insert(&(*p_cell));
         BaseType::cell_map_is_created = false;
 
@@ -324,6 +328,36 @@ public:
         return it;
     }
 
+    /// Insert a list of cells to the container at once, e.g. all the cells of a patch.
+    /// The cells are appended with hint, hence it is linear if the Ids are increasing. The search tree is updated at the end.
+    virtual void insert(const std::vector<cell_t>& p_cells)
+    {
+        std::vector<cell_t> new_cells;
+        new_cells.reserve(p_cells.size());
+        for (std::size_t i = 0; i < p_cells.size(); ++i)
+        {
+            const std::size_t size = BaseType::mpCells.size();
+            BaseType::mpCells.insert(BaseType::mpCells.end(), p_cells[i]);
+            if (BaseType::mpCells.size() != size)
+            {
+                SuperType::insert(&(*p_cells[i]));
+                new_cells.push_back(p_cells[i]);
+            }
+        }
+        BaseType::cell_map_is_created = false;
+
+        #ifdef USE_R_TREE_TO_SEARCH_FOR_CELLS
+        // update the r-tree
+        for (std::size_t i = 0; i < new_cells.size(); ++i)
+        {
+            cell_t p_cell = new_cells[i];
+            double cmin[] = {p_cell->XiMinValue()};
+            double cmax[] = {p_cell->XiMaxValue()};
+            rtree_cells.Insert(cmin, cmax, p_cell->Id());
+        }
+        #endif
+    }
+
     /// Remove a cell by its Id from the set
     virtual void erase(cell_t p_cell)
     {
@@ -462,14 +496,11 @@ public:
     /// Insert a cell to the container. If the cell is existed in the container, the iterator of the existed one will be returned.
     virtual iterator insert(cell_t p_cell)
     {
-        // search in the list of cell if any cell has the same knot span
-        // Currently I use the brute-force approach. I know it is not efficient. I will improve it in the future. TODO
-        for(iterator it = BaseType::mpCells.begin(); it != BaseType::mpCells.end(); ++it)
-            if(*it == p_cell)
-                return it;
-
-        // otherwise insert new cell
-        iterator it = BaseType::mpCells.insert(p_cell).first;
+        // if the cell is existed in the container, return it; otherwise insert new cell
+        std::pair<iterator, bool> res = BaseType::mpCells.insert(p_cell);
+        if (!res.second)
+            return res.first;
+        iterator it = res.first;
         SuperType::insert(&(*p_cell));
         BaseType::cell_map_is_created = false;
 
@@ -483,6 +514,36 @@ public:
         return it;
     }
 
+    /// Insert a list of cells to the container at once, e.g. all the cells of a patch.
+    /// The cells are appended with hint, hence it is linear if the Ids are increasing. The search tree is updated at the end.
+    virtual void insert(const std::vector<cell_t>& p_cells)
+    {
+        std::vector<cell_t> new_cells;
+        new_cells.reserve(p_cells.size());
+        for (std::size_t i = 0; i < p_cells.size(); ++i)
+        {
+            const std::size_t size = BaseType::mpCells.size();
+            BaseType::mpCells.insert(BaseType::mpCells.end(), p_cells[i]);
+            if (BaseType::mpCells.size() != size)
+            {
+                SuperType::insert(&(*p_cells[i]));
+                new_cells.push_back(p_cells[i]);
+            }
+        }
+        BaseType::cell_map_is_created = false;
+
+        #ifdef USE_R_TREE_TO_SEARCH_FOR_CELLS
+        // update the r-tree
+        for (std::size_t i = 0; i < new_cells.size(); ++i)
+        {
+            cell_t p_cell = new_cells[i];
+            double cmin[] = {p_cell->XiMinValue(), p_cell->EtaMinValue()};
+            double cmax[] = {p_cell->XiMaxValue(), p_cell->EtaMaxValue()};
+            rtree_cells.Insert(cmin, cmax, p_cell->Id());
+        }
+        #endif
+    }
+
     /// Remove a cell by its Id from the set
     virtual void erase(cell_t p_cell)
     {
@@ -623,14 +684,11 @@ public:
     /// Insert a cell to the container. If the cell is existed in the container, the iterator of the existed one will be returned.
     virtual iterator insert(cell_t p_cell)
     {
-        // search in the list of cell if any cell has the same knot span
-        // Currently I use the brute-force approach. I know it is not efficient. I will improve it in the future. TODO
-        for(iterator it = BaseType::mpCells.begin(); it != BaseType::mpCells.end(); ++it)
-            if(*it == p_cell)
-                return it;
-
-        // otherwise insert new cell
-        iterator it = BaseType::mpCells.insert(p_cell).first;
+        // if the cell is existed in the container, return it; otherwise insert new cell
+        std::pair<iterator, bool> res = BaseType::mpCells.insert(p_cell);
+        if (!res.second)
+            return res.first;
+        iterator it = res.first;
         SuperType::insert(&(*p_cell));
         BaseType::cell_map_is_created = false;
 
@@ -644,6 +702,36 @@ public:
         return it;
     }
 
+    /// Insert a list of cells to the container at once, e.g. all the cells of a patch.
+    /// The cells are appended with hint, hence it is linear if the Ids are increasing. The search tree is updated at the end.
+    virtual void insert(const std::vector<cell_t>& p_cells)
+    {
+        std::vector<cell_t> new_cells;
+        new_cells.reserve(p_cells.size());
+        for (std::size_t i = 0; i < p_cells.size(); ++i)
+        {
+            const std::size_t size = BaseType::mpCells.size();
+            BaseType::mpCells.insert(BaseType::mpCells.end(), p_cells[i]);
+            if (BaseType::mpCells.size() != size)
+            {
+                SuperType::insert(&(*p_cells[i]));
+                new_cells.push_back(p_cells[i]);
+            }
+        }
+        BaseType::cell_map_is_created = false;
+
+        #ifdef USE_R_TREE_TO_SEARCH_FOR_CELLS
+        // update the r-tree
+        for (std::size_t i = 0; i < new_cells.size(); ++i)
+        {
+            cell_t p_cell = new_cells[i];
+            double cmin[] = {p_cell->XiMinValue(), p_cell->EtaMinValue(), p_cell->ZetaMinValue()};
+            double cmax[] = {p_cell->XiMaxValue(), p_cell->EtaMaxValue(), p_cell->ZetaMaxValue()};
+            rtree_cells.Insert(cmin, cmax, p_cell->Id());
+        }
+        #endif
+    }
+
     /// Remove a cell by its Id from the set
     virtual void erase(cell_t p_cell)
     {
@@ -23,7 +23,7 @@ void BSplinesFESpace<1>::GetValue(std::vector<double>& values, const std::vector
 {
     // locate the knot span
     int Span;
-    Span = BSplineUtils::FindSpan(this->Number(0), this->Order(0), xi[0], this->KnotVector(0));
+    Span = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
 
     // compute the non-zero shape function values
     std::vector<double> ShapeFunctionValues(this->Order(0) + 1);
@@ -56,7 +56,7 @@ void BSplinesFESpace<1>::GetValueAndDerivative(std::vector<double>& values, std:
 {
     // locate the knot span
     int Span;
-    Span = BSplineUtils::FindSpan(this->Number(0), this->Order(0), xi[0], this->KnotVector(0));
+    Span = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
 
     // compute the non-zero shape function values and derivatives
     const int NumberOfDerivatives = 1;
@@ -113,8 +113,8 @@ void BSplinesFESpace<2>::GetValue(std::vector<double>& values, const std::vector
 {
     // locate the knot span
     int Span[2];
-    Span[0] = BSplineUtils::FindSpan(this->Number(0), this->Order(0), xi[0], this->KnotVector(0));
-    Span[1] = BSplineUtils::FindSpan(this->Number(1), this->Order(1), xi[1], this->KnotVector(1));
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
 
     // compute the non-zero shape function values
     std::vector<double> ShapeFunctionValues1(this->Order(0) + 1);
@@ -154,8 +154,8 @@ void BSplinesFESpace<2>::GetValueAndDerivative(std::vector<double>& values, std:
 {
     // locate the knot span
     int Span[2];
-    Span[0] = BSplineUtils::FindSpan(this->Number(0), this->Order(0), xi[0], this->KnotVector(0));
-    Span[1] = BSplineUtils::FindSpan(this->Number(1), this->Order(1), xi[1], this->KnotVector(1));
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
 
     // compute the non-zero shape function values and derivatives
     const int NumberOfDerivatives = 1;
@@ -214,9 +214,9 @@ void BSplinesFESpace<3>::GetValue(std::vector<double>& values, const std::vector
 {
     // locate the knot span
     int Span[3];
-    Span[0] = BSplineUtils::FindSpan(this->Number(0), this->Order(0), xi[0], this->KnotVector(0));
-    Span[1] = BSplineUtils::FindSpan(this->Number(1), this->Order(1), xi[1], this->KnotVector(1));
-    Span[2] = BSplineUtils::FindSpan(this->Number(2), this->Order(2), xi[2], this->KnotVector(2));
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
+    Span[2] = this->KnotVector(2).FindSpan(this->Number(2), this->Order(2), xi[2]);
 
     // compute the non-zero shape function values
     std::vector<double> ShapeFunctionValues1(this->Order(0) + 1);
@@ -263,9 +263,9 @@ void BSplinesFESpace<3>::GetValueAndDerivative(std::vector<double>& values, std:
 {
     // locate the knot span
     int Span[3];
-    Span[0] = BSplineUtils::FindSpan(this->Number(0), this->Order(0), xi[0], this->KnotVector(0));
-    Span[1] = BSplineUtils::FindSpan(this->Number(1), this->Order(1), xi[1], this->KnotVector(1));
-    Span[2] = BSplineUtils::FindSpan(this->Number(2), this->Order(2), xi[2], this->KnotVector(2));
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
+    Span[2] = this->KnotVector(2).FindSpan(this->Number(2), this->Order(2), xi[2]);
 
     // compute the non-zero shape function values and derivatives
     const int NumberOfDerivatives = 1;
@@ -329,5 +329,258 @@ void BSplinesFESpace<3>::GetValueAndDerivative(std::vector<double>& values, std:
     }
 }
 
+template<>
+void BSplinesFESpace<1>::GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& values, const std::vector<double>& xi) const
+{
+    // locate the knot span
+    int Span;
+    Span = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+
+    // compute the non-zero shape function values
+    const std::size_t n = this->Order(0) + 1;
+    if (values.size() != n)
+        values.resize(n);
+    if (local_ids.size() != n)
+        local_ids.resize(n);
+
+    BSplineUtils::BasisFuns(values, Span, xi[0], this->Order(0), this->KnotVector(0));
+
+    int Start;
+    Start = Span - this->Order(0);
+
+    for(std::size_t i = 0; i < n; ++i)
+        local_ids[i] = BSplinesIndexingUtility_Helper::Index1D(Start+i+1, this->Number(0));
+}
+
+template<>
+void BSplinesFESpace<1>::GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+        std::vector<std::vector<double> >& derivatives, const std::vector<double>& xi) const
+{
+    // locate the knot span
+    int Span;
+    Span = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+
+    // compute the non-zero shape function values and derivatives
+    const int NumberOfDerivatives = 1;
+    std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives;
+
+    BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives, Span, xi[0], this->Order(0), this->KnotVector(0), NumberOfDerivatives, BSplineUtils::StdVector2DOp<double>());
+
+    const std::size_t n = this->Order(0) + 1;
+    if (local_ids.size() != n)
+        local_ids.resize(n);
+    if (values.size() != n)
+        values.resize(n);
+    if (derivatives.size() != n)
+        derivatives.resize(n);
+
+    int Start;
+    Start = Span - this->Order(0);
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        local_ids[i] = BSplinesIndexingUtility_Helper::Index1D(Start+i+1, this->Number(0));
+        values[i] = ShapeFunctionsValuesAndDerivatives[0][i];
+        if (derivatives[i].size() != 1)
+            derivatives[i].resize(1);
+        derivatives[i][0] = ShapeFunctionsValuesAndDerivatives[1][i];
+    }
+}
+
+template<>
+void BSplinesFESpace<2>::GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& values, const std::vector<double>& xi) const
+{
+    // locate the knot span
+    int Span[2];
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
+
+    // compute the non-zero shape function values
+    std::vector<double> ShapeFunctionValues1(this->Order(0) + 1);
+    std::vector<double> ShapeFunctionValues2(this->Order(1) + 1);
+
+    BSplineUtils::BasisFuns(ShapeFunctionValues1, Span[0], xi[0], this->Order(0), this->KnotVector(0));
+    BSplineUtils::BasisFuns(ShapeFunctionValues2, Span[1], xi[1], this->Order(1), this->KnotVector(1));
+
+    const std::size_t n = (this->Order(0) + 1) * (this->Order(1) + 1);
+    if (local_ids.size() != n)
+        local_ids.resize(n);
+    if (values.size() != n)
+        values.resize(n);
+
+    int Start[2];
+    Start[0] = Span[0] - this->Order(0);
+    Start[1] = Span[1] - this->Order(1);
+
+    unsigned int i, j, cnt = 0;
+    for(i = Start[0]; i <= Span[0]; ++i)
+    {
+        for(j = Start[1]; j <= Span[1]; ++j)
+        {
+            local_ids[cnt] = BSplinesIndexingUtility_Helper::Index2D(i+1, j+1, this->Number(0), this->Number(1));
+            values[cnt] = ShapeFunctionValues1[i - Start[0]] * ShapeFunctionValues2[j - Start[1]];
+            ++cnt;
+        }
+    }
+}
+
+template<>
+void BSplinesFESpace<2>::GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+        std::vector<std::vector<double> >& derivatives, const std::vector<double>& xi) const
+{
+    // locate the knot span
+    int Span[2];
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
+
+    // compute the non-zero shape function values and derivatives
+    const int NumberOfDerivatives = 1;
+    std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives1;
+    std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives2;
+
+    BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives1, Span[0], xi[0], this->Order(0), this->KnotVector(0), NumberOfDerivatives, BSplineUtils::StdVector2DOp<double>());
+    BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives2, Span[1], xi[1], this->Order(1), this->KnotVector(1), NumberOfDerivatives, BSplineUtils::StdVector2DOp<double>());
+
+    const std::size_t n = (this->Order(0) + 1) * (this->Order(1) + 1);
+    if (local_ids.size() != n)
+        local_ids.resize(n);
+    if (values.size() != n)
+        values.resize(n);
+    if (derivatives.size() != n)
+        derivatives.resize(n);
+
+    int Start[2];
+    Start[0] = Span[0] - this->Order(0);
+    Start[1] = Span[1] - this->Order(1);
+
+    double N1, N2, dN1, dN2;
+
+    unsigned int i, j, cnt = 0;
+    for(i = Start[0]; i <= Span[0]; ++i)
+    {
+        for(j = Start[1]; j <= Span[1]; ++j)
+        {
+            N1 = ShapeFunctionsValuesAndDerivatives1[0][i - Start[0]];
+            dN1 = ShapeFunctionsValuesAndDerivatives1[1][i - Start[0]];
+            N2 = ShapeFunctionsValuesAndDerivatives2[0][j - Start[1]];
+            dN2 = ShapeFunctionsValuesAndDerivatives2[1][j - Start[1]];
+
+            local_ids[cnt] = BSplinesIndexingUtility_Helper::Index2D(i+1, j+1, this->Number(0), this->Number(1));
+            values[cnt] = N1 * N2;
+            if (derivatives[cnt].size() != 2)
+                derivatives[cnt].resize(2);
+            derivatives[cnt][0] = dN1 * N2;
+            derivatives[cnt][1] = N1 * dN2;
+            ++cnt;
+        }
+    }
+}
+
+template<>
+void BSplinesFESpace<3>::GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& values, const std::vector<double>& xi) const
+{
+    // locate the knot span
+    int Span[3];
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
+    Span[2] = this->KnotVector(2).FindSpan(this->Number(2), this->Order(2), xi[2]);
+
+    // compute the non-zero shape function values
+    std::vector<double> ShapeFunctionValues1(this->Order(0) + 1);
+    std::vector<double> ShapeFunctionValues2(this->Order(1) + 1);
+    std::vector<double> ShapeFunctionValues3(this->Order(2) + 1);
+
+    BSplineUtils::BasisFuns(ShapeFunctionValues1, Span[0], xi[0], this->Order(0), this->KnotVector(0));
+    BSplineUtils::BasisFuns(ShapeFunctionValues2, Span[1], xi[1], this->Order(1), this->KnotVector(1));
+    BSplineUtils::BasisFuns(ShapeFunctionValues3, Span[2], xi[2], this->Order(2), this->KnotVector(2));
+
+    const std::size_t n = (this->Order(0) + 1) * (this->Order(1) + 1) * (this->Order(2) + 1);
+    if (local_ids.size() != n)
+        local_ids.resize(n);
+    if (values.size() != n)
+        values.resize(n);
+
+    int Start[3];
+    Start[0] = Span[0] - this->Order(0);
+    Start[1] = Span[1] - this->Order(1);
+    Start[2] = Span[2] - this->Order(2);
+
+    unsigned int i, j, k, cnt = 0;
+    for(i = Start[0]; i <= Span[0]; ++i)
+    {
+        for(j = Start[1]; j <= Span[1]; ++j)
+        {
+            for(k = Start[2]; k <= Span[2]; ++k)
+            {
+                local_ids[cnt] = BSplinesIndexingUtility_Helper::Index3D(i+1, j+1, k+1, this->Number(0), this->Number(1), this->Number(2));
+                values[cnt] = ShapeFunctionValues1[i - Start[0]] * ShapeFunctionValues2[j - Start[1]] * ShapeFunctionValues3[k - Start[2]];
+                ++cnt;
+            }
+        }
+    }
+}
+
+template<>
+void BSplinesFESpace<3>::GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+        std::vector<std::vector<double> >& derivatives, const std::vector<double>& xi) const
+{
+    // locate the knot span
+    int Span[3];
+    Span[0] = this->KnotVector(0).FindSpan(this->Number(0), this->Order(0), xi[0]);
+    Span[1] = this->KnotVector(1).FindSpan(this->Number(1), this->Order(1), xi[1]);
+    Span[2] = this->KnotVector(2).FindSpan(this->Number(2), this->Order(2), xi[2]);
+
+    // compute the non-zero shape function values and derivatives
+    const int NumberOfDerivatives = 1;
+    std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives1;
+    std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives2;
+    std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives3;
+
+    BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives1, Span[0], xi[0], this->Order(0), this->KnotVector(0), NumberOfDerivatives, BSplineUtils::StdVector2DOp<double>());
+    BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives2, Span[1], xi[1], this->Order(1), this->KnotVector(1), NumberOfDerivatives, BSplineUtils::StdVector2DOp<double>());
+    BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives3, Span[2], xi[2], this->Order(2), this->KnotVector(2), NumberOfDerivatives, BSplineUtils::StdVector2DOp<double>());
+
+    const std::size_t n = (this->Order(0) + 1) * (this->Order(1) + 1) * (this->Order(2) + 1);
+    if (local_ids.size() != n)
+        local_ids.resize(n);
+    if (values.size() != n)
+        values.resize(n);
+    if (derivatives.size() != n)
+        derivatives.resize(n);
+
+    int Start[3];
+    Start[0] = Span[0] - this->Order(0);
+    Start[1] = Span[1] - this->Order(1);
+    Start[2] = Span[2] - this->Order(2);
+
+    double N1, N2, N3, dN1, dN2, dN3;
+
+    unsigned int i, j, k, cnt = 0;
+    for(i = Start[0]; i <= Span[0]; ++i)
+    {
+        for(j = Start[1]; j <= Span[1]; ++j)
+        {
+            for(k = Start[2]; k <= Span[2]; ++k)
+            {
+                N1 = ShapeFunctionsValuesAndDerivatives1[0][i - Start[0]];
+                dN1 = ShapeFunctionsValuesAndDerivatives1[1][i - Start[0]];
+                N2 = ShapeFunctionsValuesAndDerivatives2[0][j - Start[1]];
+                dN2 = ShapeFunctionsValuesAndDerivatives2[1][j - Start[1]];
+                N3 = ShapeFunctionsValuesAndDerivatives3[0][k - Start[2]];
+                dN3 = ShapeFunctionsValuesAndDerivatives3[1][k - Start[2]];
+
+                local_ids[cnt] = BSplinesIndexingUtility_Helper::Index3D(i+1, j+1, k+1, this->Number(0), this->Number(1), this->Number(2));
+                values[cnt] = N1 * N2 * N3;
+                if (derivatives[cnt].size() != 3)
+                    derivatives[cnt].resize(3);
+                derivatives[cnt][0] = dN1 * N2 * N3;
+                derivatives[cnt][1] = N1 * dN2 * N3;
+                derivatives[cnt][2] = N1 * N2 * dN3;
+                ++cnt;
+            }
+        }
+    }
+}
+
 } // namespace Kratos.
 
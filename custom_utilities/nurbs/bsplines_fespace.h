@@ -19,9 +19,11 @@
 // Project includes
 #include "includes/define.h"
 #include "containers/array_1d.h"
+#include "utilities/openmp_utils.h"
 #include "custom_utilities/bezier_utils.h"
 #include "custom_utilities/bspline_utils.h"
 #include "custom_utilities/fespace.h"
+#include "custom_utilities/extraction_operator_pool.h"
 #include "custom_utilities/nurbs/knot_array_1d.h"
 #include "custom_utilities/nurbs/bsplines_indexing_utility.h"
 #include "custom_utilities/nurbs/bcell.h"
@@ -209,6 +211,62 @@ public:
         KRATOS_THROW_ERROR(std::logic_error, "GetValueAndDerivative is not implemented for dimension", TDim)
     }
 
+    /// Get the values of the (p+1)^d basis functions which are nonzero at point xi
+    virtual void GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& values, const std::vector<double>& xi) const
+    {
+        KRATOS_THROW_ERROR(std::logic_error, "GetNonzeroValue is not implemented for dimension", TDim)
+    }
+
+    /// Get the values and derivatives of the (p+1)^d basis functions which are nonzero at point xi
+    /// the output derivatives has the form of derivatives[k][dim_index], k being the position in local_ids
+    virtual void GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+            std::vector<std::vector<double> >& derivatives, const std::vector<double>& xi) const
+    {
+        KRATOS_THROW_ERROR(std::logic_error, "GetNonzeroValueAndDerivative is not implemented for dimension", TDim)
+    }
+
+    /// The B-Splines basis functions are tensor products of the univariate B-Splines
+    virtual bool IsTensorProduct() const
+    {
+        return true;
+    }
+
+    /// Get the number of univariate functions in direction dim
+    virtual std::size_t UnivariateNumber(const std::size_t& dim) const
+    {
+        return this->Number(dim);
+    }
+
+    /// Get the values and derivatives of the p+1 univariate B-Splines in direction dim which are nonzero at coordinate t
+    virtual void GetUnivariateNonzeroValueAndDerivative(std::size_t& start, std::vector<double>& values,
+            std::vector<double>& derivatives, const std::size_t& dim, const double& t) const
+    {
+        int Span = this->KnotVector(dim).FindSpan(this->Number(dim), this->Order(dim), t);
+        start = Span - this->Order(dim);
+
+        std::vector<std::vector<double> > ShapeFunctionsValuesAndDerivatives;
+        BSplineUtils::BasisFunsDer(ShapeFunctionsValuesAndDerivatives, Span, t, this->Order(dim), this->KnotVector(dim), 1, BSplineUtils::StdVector2DOp<double>());
+        values = ShapeFunctionsValuesAndDerivatives[0];
+        derivatives = ShapeFunctionsValuesAndDerivatives[1];
+    }
+
+    /// Get the local knot vectors of the basis function i, i.e. the knots [U_k, ..., U_{k+p+1}] on each direction
+    virtual bool GetLocalKnotVectors(const std::size_t& i, std::vector<std::vector<double> >& rKnots) const
+    {
+        rKnots.resize(TDim);
+        std::size_t tmp = i;
+        for (std::size_t dim = 0; dim < TDim; ++dim)
+        {
+            const std::size_t k = tmp % this->Number(dim);
+            tmp /= this->Number(dim);
+
+            rKnots[dim].resize(this->Order(dim) + 2);
+            for (std::size_t j = 0; j < this->Order(dim) + 2; ++j)
+                rKnots[dim][j] = this->KnotVector(dim)[k + j];
+        }
+        return true;
+    }
+
     /// Compare between two BSplines patches in terms of parametric information
     virtual bool IsCompatible(const FESpace<TDim>& rOtherFESpace) const
     {
@@ -869,6 +927,8 @@ public:
     }
 
     /// Create the cell manager for all the cells in the support domain of the BSplinesFESpace
+    /// The extraction operator of each cell is the Kronecker product of the 1D extraction operators on each direction,
+    /// hence only the latter are computed and kept in the cells. The cells are then constructed in parallel and inserted to the manager at once.
     virtual typename BaseType::cell_container_t::Pointer ConstructCellManager() const
     {
         typename cell_container_t::Pointer pCellManager;
@@ -877,215 +937,170 @@ public:
 
         pCellManager = typename cell_container_t::Pointer(new BCellManager<TDim, BCell>());
 
-        if (TDim == 1)
+        // compute the 1D Bezier extraction operators, the bounding knots and the first supported function of each span on each direction
+        boost::array<std::vector<Matrix>, TDim> C;
+        boost::array<std::vector<std::tuple<knot_t, knot_t> >, TDim> spans;
+        boost::array<std::vector<std::size_t>, TDim> first_funcs;
+        boost::array<std::size_t, TDim> ne;
+        std::size_t ncells = 1, nb = 1;
+        for (std::size_t dim = 0; dim < TDim; ++dim)
         {
-            // firstly compute the Bezier extraction operator on the patch
-            std::vector<Matrix> C;
-            int ne1;
-            // BezierUtils::bezier_extraction_2d(C, ne1, ne2, this->KnotVector(0), this->KnotVector(1), this->Order(0), this->Order(1));
-            BezierUtils::bezier_extraction_1d(C, ne1, this->KnotVector(0), this->Order(0));
+            int nspans;
+            BezierUtils::bezier_extraction_1d(C[dim], nspans, this->KnotVector(dim), this->Order(dim));
+            ne[dim] = nspans;
+            ncells *= ne[dim];
+            nb *= this->Order(dim) + 1;
 
             #ifdef DEBUG_GEN_CELL
-            KRATOS_WATCH(ne1)
-            KRATOS_WATCH(C.size())
-            KRATOS_WATCH(C[0].size1())
-            KRATOS_WATCH(C[0].size2())
+            KRATOS_WATCH(ne[dim])
             #endif
 
-            // construct cells and add to the manager
-            std::size_t n1 = this->Number(0);
-            std::size_t p1 = this->Order(0);
-            std::size_t i, j, k, l, b1 = p1+1, tmp, mul1, sum_mul1 = 0, id1, id;
-            std::size_t cnt = 0; // cell counter
-
-            for (i = 0; i < ne1; ++i)
+            const std::size_t n = this->Number(dim);
+            const std::size_t p = this->Order(dim);
+            std::size_t b = p + 1, tmp, mul, sum_mul = 0;
+            spans[dim].resize(ne[dim]);
+            first_funcs[dim].resize(ne[dim]);
+            for (std::size_t i = 0; i < ne[dim]; ++i)
             {
                 // check the multiplicity
-                tmp = b1;
-                while (b1 <= (n1 + p1 + 1) && this->KnotVector(0)[b1] == this->KnotVector(0)[b1-1]) ++b1;
-                mul1 = b1 - tmp + 1;
-                b1 = b1 + 1;
-                sum_mul1 = sum_mul1 + (mul1 - 1);
-
-                std::vector<std::size_t> anchors;
-                anchors.reserve(p1+1);
-                for (k = 0; k < p1+1; ++k)
-                {
-                    id1 = i + k + sum_mul1;
-                    id = id1; // this is the local id
-                    anchors.push_back(id);
-                }
-
-                // add the cell
-                std::tuple<knot_t, knot_t> span1 = this->KnotVector(0).span(i+1);
-                BCell::Pointer p_cell = BCell::Pointer(new BCell(cnt, std::get<0>(span1), std::get<1>(span1)));
-                double W = 1.0; // here we set to one because B-Splines space does not have weight
-                for (std::size_t r = 0; r < (p1+1); ++r)
-                    p_cell->AddAnchor(func_indices[anchors[r]], W, row(C[cnt], r));
-                pCellManager->insert(p_cell);
-                ++cnt;
+                tmp = b;
+                while (b <= (n + p + 1) && this->KnotVector(dim)[b] == this->KnotVector(dim)[b-1]) ++b;
+                mul = b - tmp + 1;
+                b = b + 1;
+                sum_mul = sum_mul + (mul - 1);
+
+                first_funcs[dim][i] = i + sum_mul;
+                spans[dim][i] = this->KnotVector(dim).span(i+1);
             }
         }
-        else if (TDim == 2)
+
+        // the 1D extraction operators are shared by all the cells on the same knot span, and the equal ones by all the knot spans
+        boost::array<std::vector<BCell::ExtractionOperatorPointerType>, TDim> pC;
+        for (std::size_t dim = 0; dim < TDim; ++dim)
         {
-            // firstly compute the Bezier extraction operator on the patch
-            std::vector<Matrix> C;
-            int ne1, ne2;
-            // BezierUtils::bezier_extraction_2d(C, ne1, ne2, this->KnotVector(0), this->KnotVector(1), this->Order(0), this->Order(1));
-            BezierUtils::bezier_extraction_2d(C, ne2, ne1, this->KnotVector(1), this->KnotVector(0), this->Order(1), this->Order(0)); // we rotate the order of input
+            pC[dim].resize(ne[dim]);
+            for (std::size_t i = 0; i < ne[dim]; ++i)
+                pC[dim][i] = ExtractionOperatorPool<Matrix>::Intern(C[dim][i]);
+        }
 
-            #ifdef DEBUG_GEN_CELL
-            KRATOS_WATCH(ne1)
-            KRATOS_WATCH(ne2)
-            KRATOS_WATCH(C.size())
-            KRATOS_WATCH(C[0].size1())
-            KRATOS_WATCH(C[0].size2())
-            #endif
+        // construct the cells. The cells are numbered with the last direction running fastest.
+        std::vector<BCell::Pointer> cells(ncells);
+        ExtractionOperatorArena::Pointer pArena = pCellManager->pExtractionOperatorArena();
 
-            // construct cells and add to the manager
-            std::size_t n1 = this->Number(0);
-            std::size_t n2 = this->Number(1);
-            std::size_t p1 = this->Order(0);
-            std::size_t p2 = this->Order(1);
-            std::size_t i, j, k, l, b1 = p1+1, b2, tmp, mul1, mul2, sum_mul1 = 0, sum_mul2 = 0, id1, id2, id;
-            std::size_t cnt = 0; // cell counter
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(ncells, number_of_threads, partition);
 
-            for (i = 0; i < ne1; ++i)
+        #pragma omp parallel for
+        for (int k = 0; k < number_of_threads; ++k)
+        {
+            boost::array<std::size_t, TDim> e, u;
+
+            for (std::size_t cnt = partition[k]; cnt < partition[k+1]; ++cnt)
             {
-                // check the multiplicity
-                tmp = b1;
-                while (b1 <= (n1 + p1 + 1) && this->KnotVector(0)[b1] == this->KnotVector(0)[b1-1]) ++b1;
-                mul1 = b1 - tmp + 1;
-                b1 = b1 + 1;
-                sum_mul1 = sum_mul1 + (mul1 - 1);
-
-                b2 = p2 + 1;
-                sum_mul2 = 0;
-                for (j = 0; j < ne2; ++j)
+                // index of the span on each direction
+                std::size_t tmp = cnt;
+                for (int dim = TDim-1; dim >= 0; --dim)
                 {
-                    // check the multiplicity
-                    tmp = b2;
-                    while (b2 <= (n2 + p2 + 1) && this->KnotVector(1)[b2] == this->KnotVector(1)[b2-1]) ++b2;
-                    mul2 = b2 - tmp + 1;
-                    b2 = b2 + 1;
-                    sum_mul2 = sum_mul2 + (mul2 - 1);
-
-                    std::vector<std::size_t> anchors;
-                    anchors.reserve((p1+1)*(p2+1));
-                    for (k = 0; k < p1+1; ++k)
+                    e[dim] = tmp % ne[dim];
+                    tmp /= ne[dim];
+                }
+
+                BCell::Pointer p_cell;
+                if (TDim == 1)
+                    p_cell = BCell::Pointer(new BCell(cnt, std::get<0>(spans[0][e[0]]), std::get<1>(spans[0][e[0]])));
+                else if (TDim == 2)
+                    p_cell = BCell::Pointer(new BCell(cnt, std::get<0>(spans[0][e[0]]), std::get<1>(spans[0][e[0]]),
+                            std::get<0>(spans[1][e[1]]), std::get<1>(spans[1][e[1]])));
+                else if (TDim == 3)
+                    p_cell = BCell::Pointer(new BCell(cnt, std::get<0>(spans[0][e[0]]), std::get<1>(spans[0][e[0]]),
+                            std::get<0>(spans[1][e[1]]), std::get<1>(spans[1][e[1]]),
+                            std::get<0>(spans[2][e[2]]), std::get<1>(spans[2][e[2]])));
+
+                // the arena only receives rows if the cell is later merged with another one, see BCell::Absorb
+                p_cell->SetExtractionOperatorArena(pArena);
+
+                // only the 1D extraction operators are kept; the extraction operator of the cell is C1[e1] x C2[e2] x C3[e3]
+                if (TDim == 1)
+                    p_cell->SetExtractionOperatorFactors(pC[0][e[0]]);
+                else if (TDim == 2)
+                    p_cell->SetExtractionOperatorFactors(pC[0][e[0]], pC[1][e[1]]);
+                else if (TDim == 3)
+                    p_cell->SetExtractionOperatorFactors(pC[0][e[0]], pC[1][e[1]], pC[2][e[2]]);
+
+                double W = 1.0; // here we set to one because B-Splines space does not have weight
+                for (std::size_t r = 0; r < nb; ++r)
+                {
+                    // local index of the supported function on each direction; the first direction is the outermost
+                    tmp = r;
+                    for (int dim = TDim-1; dim >= 0; --dim)
                     {
-                        for (l = 0; l < p2+1; ++l)
-                        {
-                            id1 = i + k + sum_mul1;
-                            id2 = j + l + sum_mul2;
-                            id = id1 + id2*n1; // this is the local id
-                            anchors.push_back(id);
-                        }
+                        u[dim] = tmp % (this->Order(dim) + 1);
+                        tmp /= (this->Order(dim) + 1);
                     }
 
-                    // add the cell
-                    std::tuple<knot_t, knot_t> span1 = this->KnotVector(0).span(i+1);
-                    std::tuple<knot_t, knot_t> span2 = this->KnotVector(1).span(j+1);
-                    BCell::Pointer p_cell = BCell::Pointer(new BCell(cnt, std::get<0>(span1), std::get<1>(span1), std::get<0>(span2), std::get<1>(span2)));
-                    double W = 1.0; // here we set to one because B-Splines space does not have weight
-                    for (std::size_t r = 0; r < (p1+1)*(p2+1); ++r)
-                        p_cell->AddAnchor(func_indices[anchors[r]], W, row(C[cnt], r));
-                    pCellManager->insert(p_cell);
-                    ++cnt;
+                    // the local id of the function
+                    std::size_t id = 0;
+                    for (int dim = TDim-1; dim >= 0; --dim)
+                        id = id * this->Number(dim) + first_funcs[dim][e[dim]] + u[dim];
+
+                    p_cell->AddAnchor(func_indices[id], W);
                 }
+
+                cells[cnt] = p_cell;
             }
         }
-        else if(TDim == 3)
+
+        pCellManager->insert(cells);
+
+        return pCellManager;
+    }
+
+    /// Append the equation ids of the basis functions supported on each knot span of the BSplinesFESpace.
+    /// The knot span [U_j, U_{j+1}] on each direction supports the functions j-p, ..., j, hence the cells are not constructed.
+    virtual void GetCellSupports(std::vector<std::vector<std::size_t> >& rSupports) const
+    {
+        boost::array<std::vector<std::size_t>, TDim> first_funcs;
+        std::size_t ncells = 1, nb = 1;
+        for (std::size_t dim = 0; dim < TDim; ++dim)
+        {
+            const std::size_t p = this->Order(dim);
+            for (std::size_t j = p; j < this->Number(dim); ++j)
+                if (this->KnotVector(dim)[j+1] > this->KnotVector(dim)[j])
+                    first_funcs[dim].push_back(j - p);
+            ncells *= first_funcs[dim].size();
+            nb *= p + 1;
+        }
+
+        const std::vector<std::size_t> func_indices = this->FunctionIndices();
+        const std::size_t offset = rSupports.size();
+        rSupports.resize(offset + ncells, std::vector<std::size_t>(nb));
+        for (std::size_t cnt = 0; cnt < ncells; ++cnt)
         {
-            // firstly compute the Bezier extraction operator on the patch
-            std::vector<Matrix> C;
-            int ne1, ne2, ne3;
-            // BezierUtils::bezier_extraction_3d(C, ne1, ne2, ne3,
-            //     this->KnotVector(0), this->KnotVector(1), this->KnotVector(2),
-            //     this->Order(0), this->Order(1), this->Order(2));
-            BezierUtils::bezier_extraction_3d(C, ne3, ne2, ne1,
-                this->KnotVector(2), this->KnotVector(1), this->KnotVector(0),
-                this->Order(2), this->Order(1), this->Order(0)); // we rotate the order of input
-
-            // construct cells and add to the manager
-            std::size_t n1 = this->Number(0);
-            std::size_t n2 = this->Number(1);
-            std::size_t n3 = this->Number(2);
-            std::size_t p1 = this->Order(0);
-            std::size_t p2 = this->Order(1);
-            std::size_t p3 = this->Order(2);
-            std::size_t i, j, k, l, u, v, w, b1 = p1+1, b2, b3, tmp, mul1, mul2, mul3;
-            std::size_t sum_mul1 = 0, sum_mul2 = 0, sum_mul3 = 0, id1, id2, id3, id;
-            std::size_t cnt = 0; // cell counter
-
-            for (i = 0; i < ne1; ++i)
+            boost::array<std::size_t, TDim> e, u;
+            std::size_t tmp = cnt;
+            for (std::size_t dim = 0; dim < TDim; ++dim)
             {
-                // check the multiplicity
-                tmp = b1;
-                while (b1 <= (n1 + p1 + 1) && this->KnotVector(0)[b1] == this->KnotVector(0)[b1-1]) ++b1;
-                mul1 = b1 - tmp + 1;
-                b1 = b1 + 1;
-                sum_mul1 = sum_mul1 + (mul1 - 1);
-
-                b2 = p2 + 1;
-                sum_mul2 = 0;
-                for (j = 0; j < ne2; ++j)
+                e[dim] = tmp % first_funcs[dim].size();
+                tmp /= first_funcs[dim].size();
+            }
+
+            for (std::size_t r = 0; r < nb; ++r)
+            {
+                tmp = r;
+                for (std::size_t dim = 0; dim < TDim; ++dim)
                 {
-                    // check the multiplicity
-                    tmp = b2;
-                    while (b2 <= (n2 + p2 + 1) && this->KnotVector(1)[b2] == this->KnotVector(1)[b2-1]) ++b2;
-                    mul2 = b2 - tmp + 1;
-                    b2 = b2 + 1;
-                    sum_mul2 = sum_mul2 + (mul2 - 1);
-
-                    b3 = p3 + 1;
-                    sum_mul3 = 0;
-                    for (k = 0; k < ne3; ++k)
-                    {
-                        // check the multiplicity
-                        tmp = b3;
-                        while (b3 <= (n3 + p3 + 1) && this->KnotVector(2)[b3] == this->KnotVector(2)[b3-1]) ++b3;
-                        mul3 = b3 - tmp + 1;
-                        b3 = b3 + 1;
-                        sum_mul3 = sum_mul3 + (mul3 - 1);
-
-                        std::vector<std::size_t> anchors;
-                        anchors.reserve((p1+1)*(p2+1)*(p3+1));
-                        for (u = 0; u < p1+1; ++u)
-                        {
-                            for (v = 0; v < p2+1; ++v)
-                            {
-                                for (v = 0; v < p2+1; ++v)
-                                {
-                                    for (w = 0; w < p3+1; ++w)
-                                    {
-                                        id1 = i + u + sum_mul1;
-                                        id2 = j + v + sum_mul2;
-                                        id3 = k + w + sum_mul3;
-                                        id = id1 + (id2 + id3 * n2) * n1; // this is the local id
-                                        anchors.push_back(id);
-                                    }
-                                }
-                            }
-                        }
-
-                        // add the cell
-                        std::tuple<knot_t, knot_t> span1 = this->KnotVector(0).span(i+1);
-                        std::tuple<knot_t, knot_t> span2 = this->KnotVector(1).span(j+1);
-                        std::tuple<knot_t, knot_t> span3 = this->KnotVector(2).span(k+1);
-                        BCell::Pointer p_cell = BCell::Pointer(new BCell(cnt, std::get<0>(span1), std::get<1>(span1),
-                                std::get<0>(span2), std::get<1>(span2), std::get<0>(span3), std::get<1>(span3)));
-                        double W = 1.0; // here we set to one because B-Splines space does not have weight
-                        for (std::size_t r = 0; r < (p1+1)*(p2+1)*(p3+1); ++r)
-                            p_cell->AddAnchor(func_indices[anchors[r]], W, row(C[cnt], r));
-                        pCellManager->insert(p_cell);
-                        ++cnt;
-                    }
+                    u[dim] = tmp % (this->Order(dim) + 1);
+                    tmp /= (this->Order(dim) + 1);
                 }
+
+                std::size_t id = 0;
+                for (int dim = TDim-1; dim >= 0; --dim)
+                    id = id * this->Number(dim) + first_funcs[dim][e[dim]] + u[dim];
+
+                rSupports[offset + cnt][r] = func_indices[id];
             }
         }
-
-        return pCellManager;
     }
 
     /// Overload assignment operator
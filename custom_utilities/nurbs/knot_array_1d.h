@@ -11,17 +11,20 @@
 
 // System includes
 #include <deque>
+#include <vector>
 #include <string>
 #include <iostream>
 
 
 // External includes
+#include <boost/shared_ptr.hpp>
 
 
 // Project includes
 #include "includes/define.h"
 #include "custom_utilities/iga_define.h"
 #include "custom_utilities/nurbs/knot.h"
+#include "custom_utilities/nurbs/knot_span_locator.h"
 
 namespace Kratos
 {
@@ -33,6 +36,8 @@ Short description:
 +   mpKnots is always sorted ascending.
 +   the index of knot starts from 0.
 +   this container stores the array of pointers to the knot, not the knot value itself.
++   the knot values, the table of non-empty spans and the span lookup table are cached contiguously. The cache is rebuilt on the first read access after the knot vector is modified.
++   the copies share the knots, hence they share the version of the knots; a modification through any copy invalidates the cache of all of them.
  */
 template<typename TDataType>
 class KnotArray1D
@@ -51,7 +56,10 @@ public:
     typedef typename knot_container_t::const_iterator const_iterator;
 
     /// Default constructor
-    KnotArray1D() {}
+    KnotArray1D() : mpVersion(new std::size_t(0)), mCacheVersion(-1) {}
+
+    /// Copy constructor
+    KnotArray1D(const KnotArray1D& rOther) : mpKnots(rOther.mpKnots), mpVersion(rOther.mpVersion), mCacheVersion(-1) {}
 
     /// Destructor
     virtual ~KnotArray1D() {}
@@ -60,6 +68,7 @@ public:
     void clear()
     {
         mpKnots.clear();
+        this->ResetCache();
     }
 
     /// Insert the knot to the array and return its pointer.
@@ -73,6 +82,7 @@ public:
                 break;
         knot_t p_knot = knot_t(new KnotType(k));
         mpKnots.insert(it, p_knot);
+        this->ResetCache();
 
         // update the index of the knot
         std::size_t index = 0;
@@ -98,6 +108,7 @@ public:
         {
             (*it)->Value() /= kmax;
         }
+        this->ResetCache();
     }
 
     /// Insert the knot to the array and return its pointer.
@@ -128,6 +139,7 @@ public:
             (*it)->Value() = maxv - (*it)->Value();
             ++index;
         }
+        this->ResetCache();
     }
 
     /// Create a clone of this knot vector
@@ -170,53 +182,61 @@ public:
     /// Get the size of the knot vector
     std::size_t size() const {return mpKnots.size();}
 
-    /// Get the number of knot spans
+    /// Get the number of (non-empty) knot spans
     std::size_t nspans() const
     {
-        std::size_t nspan = 0;
-        TDataType left = (*begin())->Value();
-        for (const_iterator it = begin(); it != end(); ++it)
-        {
-            TDataType right = (*it)->Value();
-            if (right != left)
-            {
-                ++nspan;
-                left = right;
-            }
-        }
-        return nspan;
+        this->CheckCache();
+        return mSpans.size();
     }
 
-    /// Get the two knots bounded the span (the closest one)
+    /// Get the two knots bounded the span (the closest one). The span index starts from 1.
     std::tuple<knot_t, knot_t> span(const std::size_t& i_span) const
     {
-        std::size_t i = 0;
-        knot_t left = *begin();
-        for (const_iterator it = begin(); it != end(); ++it)
-        {
-            knot_t right = (*it);
-            if (right->Value() != left->Value())
-            {
-                ++i;
-                if (i == i_span)
-                    return std::make_tuple(left, right);
-                left = right;
-            }
-            else
-                left = right; // move the knot
-        }
-        // shall not come here
-        KRATOS_THROW_ERROR(std::logic_error, "the span index exceeds the number of span of the knot vector", "")
+        this->CheckCache();
+        if (i_span < 1 || i_span > mSpans.size())
+            KRATOS_THROW_ERROR(std::logic_error, "the span index exceeds the number of span of the knot vector", "")
+        const std::size_t right = mSpans[i_span - 1];
+        return std::make_tuple(mpKnots[right - 1], mpKnots[right]);
+    }
+
+    /// Get the values of the two knots bounded the span. The span index starts from 1.
+    void span(const std::size_t& i_span, TDataType& rLeft, TDataType& rRight) const
+    {
+        this->CheckCache();
+        if (i_span < 1 || i_span > mSpans.size())
+            KRATOS_THROW_ERROR(std::logic_error, "the span index exceeds the number of span of the knot vector", "")
+        const std::size_t right = mSpans[i_span - 1];
+        rLeft = mValues[right - 1];
+        rRight = mValues[right];
+    }
+
+    /// Find the knot span of xi, with the same result as BSplineUtils::FindSpan(n, p, xi, *this)
+    /// The lookup is constant time for uniform knot vectors
+    int FindSpan(const int& rN, const int& rP, const TDataType& rXi) const
+    {
+        this->CheckCache();
+        return mSpanLocator.FindSpan(rN, rP, rXi);
+    }
+
+    /// Get the contiguous array of knot values
+    const std::vector<TDataType>& Values() const
+    {
+        this->CheckCache();
+        return mValues;
+    }
+
+    /// Discard the cached knot values and span tables, of this container and of its copies. It is called by all the modifiers
+    /// of this container, but shall be called explicitly if the knot values are changed through the knot pointers.
+    void ResetCache()
+    {
+        #pragma omp atomic
+        ++(*mpVersion);
     }
 
     /// Return the values of the knot vector
     void GetValues(std::vector<TDataType>& r_values) const
     {
-        if (r_values.size() != mpKnots.size())
-            r_values.resize(mpKnots.size());
-
-        for (std::size_t i = 0; i < mpKnots.size(); ++i)
-            r_values[i] = mpKnots[i]->Value();
+        r_values = this->Values();
     }
 
     /// Return the values of the knot vector
@@ -362,6 +382,8 @@ public:
     KnotArray1D& operator=(const KnotArray1D& rOther)
     {
         this->mpKnots = rOther.mpKnots;
+        this->mpVersion = rOther.mpVersion;
+        this->mCacheVersion = -1;
         return *this;
     }
 
@@ -377,16 +399,13 @@ public:
         return pKnotAt(i);
     }
 
-    // overload operator []
-    TDataType& operator[] (const std::size_t& i)
-    {
-        return pKnotAt(i)->Value();
-    }
-
-    // overload operator []
+    // overload operator []. The access is read-only; the knot value is modified through pKnotAt, followed by ResetCache.
     const TDataType& operator[] (const std::size_t& i) const
     {
-        return pKnotAt(i)->Value();
+        this->CheckCache();
+        if (i >= mValues.size())
+            KRATOS_THROW_ERROR(std::runtime_error, "Index access out of range", "")
+        return mValues[i];
     }
 
     /// Information
@@ -399,6 +418,67 @@ public:
 private:
 
     knot_container_t mpKnots;
+
+    mutable std::vector<TDataType> mValues; // contiguous copy of the knot values
+    mutable std::vector<std::size_t> mSpans; // index of the right knot of each non-empty span; the left knot is the previous one
+    mutable KnotSpanLocator mSpanLocator;
+    boost::shared_ptr<std::size_t> mpVersion; // the version of the knots, incremented at each modification and shared by the copies
+    mutable std::size_t mCacheVersion; // the version of the knots of the cache, -1 if there is no cache
+
+    /// Get the version of the knots, without locking
+    std::size_t Version() const
+    {
+        std::size_t version;
+        #pragma omp atomic read
+        version = *mpVersion;
+        return version;
+    }
+
+    /// Get the version of the knots of the cache, without locking
+    std::size_t CacheVersion() const
+    {
+        std::size_t version;
+        #pragma omp atomic read
+        version = mCacheVersion;
+        #pragma omp flush
+        return version;
+    }
+
+    /// Rebuild the cache if the knot vector is modified. The version of the cache is published atomically after
+    /// the cache is built, hence the cache is read without locking once it is up to date.
+    void CheckCache() const
+    {
+        const std::size_t version = this->Version();
+        if (this->CacheVersion() != version)
+        {
+            #pragma omp critical(KnotArray1D_CreateCache)
+            {
+                if (this->CacheVersion() != version)
+                {
+                    this->CreateCache();
+
+                    #pragma omp flush
+                    #pragma omp atomic write
+                    mCacheVersion = version;
+                }
+            }
+        }
+    }
+
+    /// Copy the knot values and build the span tables
+    void CreateCache() const
+    {
+        mValues.resize(mpKnots.size());
+        for (std::size_t i = 0; i < mpKnots.size(); ++i)
+            mValues[i] = mpKnots[i]->Value();
+
+        mSpans.clear();
+        for (std::size_t i = 1; i < mValues.size(); ++i)
+            if (mValues[i] != mValues[i - 1])
+                mSpans.push_back(i);
+
+        mSpanLocator.Initialize(mValues);
+    }
 };
 
 /// output stream function
@@ -0,0 +1,193 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 16 Oct 2026 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_KNOT_SPAN_LOCATOR_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_KNOT_SPAN_LOCATOR_H_INCLUDED
+
+// System includes
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+// External includes
+
+// Project includes
+#include "includes/define.h"
+
+namespace Kratos
+{
+
+/**
+This class accelerates the search of the knot span containing a parameter.
+
+Short description:
++   the range [U[0], U[m]] of the knot vector is divided into equal buckets. Each bucket stores the index of the last knot not greater than its left end.
++   for a uniform knot vector, the buckets coincide with the knot spans and the lookup is constant time.
++   for a general knot vector, two buckets per knot span are used and the lookup is a search within the (usually few) knots of one bucket.
++   the knot values are copied at Initialize. The locator must be initialized again when the knot vector changes.
+ */
+class KnotSpanLocator
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(KnotSpanLocator);
+
+    /// Default constructor
+    KnotSpanLocator() : mIsUniform(false), mLeft(0.0), mRight(0.0), mScale(0.0) {}
+
+    /// Constructor with knot vector
+    template<class ValuesContainerType>
+    KnotSpanLocator(const ValuesContainerType& rU) : mIsUniform(false), mLeft(0.0), mRight(0.0), mScale(0.0)
+    {
+        this->Initialize(rU);
+    }
+
+    /// Destructor
+    virtual ~KnotSpanLocator() {}
+
+    /// Build the bucket table for the knot vector rU. rU must be sorted ascending.
+    template<class ValuesContainerType>
+    void Initialize(const ValuesContainerType& rU)
+    {
+        const std::size_t m = rU.size();
+        mKnots.resize(m);
+        for (std::size_t i = 0; i < m; ++i)
+            mKnots[i] = rU[i];
+
+        mBuckets.clear();
+        mIsUniform = false;
+        if (m < 2)
+            return;
+
+        mLeft = mKnots.front();
+        mRight = mKnots.back();
+        if (!(mRight > mLeft))
+            return;
+
+        // count the non-empty knot spans and check if they have the same length
+        std::size_t nspans = 0;
+        double hmin = mRight - mLeft, hmax = 0.0;
+        for (std::size_t i = 0; i < m - 1; ++i)
+        {
+            const double h = mKnots[i + 1] - mKnots[i];
+            if (h > 0.0)
+            {
+                ++nspans;
+                hmin = std::min(hmin, h);
+                hmax = std::max(hmax, h);
+            }
+        }
+        mIsUniform = (hmax - hmin) <= 1.0e-10 * (mRight - mLeft);
+
+        const std::size_t nbuckets = mIsUniform ? nspans : 2 * nspans;
+        mScale = static_cast<double>(nbuckets) / (mRight - mLeft);
+        mBuckets.resize(nbuckets);
+        std::size_t s = 0;
+        for (std::size_t b = 0; b < nbuckets; ++b)
+        {
+            const double x = mLeft + (mRight - mLeft) * static_cast<double>(b) / nbuckets;
+            while (s + 1 < m && mKnots[s + 1] <= x)
+                ++s;
+            mBuckets[b] = s;
+        }
+    }
+
+    /// Clear the locator
+    void Clear()
+    {
+        mKnots.clear();
+        mBuckets.clear();
+        mIsUniform = false;
+    }
+
+    /// Check if the locator is initialized with a non-degenerated knot vector
+    bool IsInitialized() const {return !mBuckets.empty();}
+
+    /// Check if the knot vector is uniform, i.e. the lookup is constant time
+    bool IsUniform() const {return mIsUniform;}
+
+    /// Get the number of buckets
+    std::size_t NumberOfBuckets() const {return mBuckets.size();}
+
+    /// Find the knot span of xi, with the same result as BSplineUtils::FindSpan, i.e. U[span] <= xi < U[span+1] and p <= span <= n-1
+    /// Parameters outside [U[p], U[n]] are clamped to the first and last span
+    int FindSpan(const int& rN, const int& rP, const double& rXi) const
+    {
+        int span = static_cast<int>(this->FindKnot(rXi));
+        if (span > rN - 1) return rN - 1;
+        if (span < rP) return rP;
+        return span;
+    }
+
+    /// Find the index of the last knot not greater than xi. If xi is smaller than the first knot, 0 is returned.
+    std::size_t FindKnot(const double& rXi) const
+    {
+        const std::size_t m = mKnots.size();
+        if (m == 0)
+            return 0;
+
+        const double* U = &mKnots[0];
+        if (mBuckets.empty())
+            return LastNotGreater(U, 0, m, rXi);
+
+        // locate the bucket
+        const std::size_t nbuckets = mBuckets.size();
+        std::size_t b;
+        if (!(rXi > mLeft))
+            b = 0;
+        else if (!(rXi < mRight))
+            b = nbuckets - 1;
+        else
+            b = std::min(static_cast<std::size_t>((rXi - mLeft) * mScale), nbuckets - 1);
+
+        // the knots range of the bucket, corrected for the round-off at the bucket ends
+        std::size_t first = mBuckets[b];
+        while (first > 0 && U[first] > rXi)
+            --first;
+        std::size_t last = (b + 1 < nbuckets) ? mBuckets[b + 1] + 1 : m;
+        if (last <= first || (last < m && U[last] <= rXi))
+            last = m;
+
+        return LastNotGreater(U, first, last, rXi);
+    }
+
+    /// Information
+    void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "KnotSpanLocator, number of knots: " << mKnots.size()
+                 << ", number of buckets: " << mBuckets.size()
+                 << ", uniform: " << (mIsUniform ? "yes" : "no");
+    }
+
+private:
+
+    bool mIsUniform;
+    double mLeft;
+    double mRight;
+    double mScale; // number of buckets per unit length
+    std::vector<double> mKnots; // contiguous copy of the knot values
+    std::vector<std::size_t> mBuckets; // index of the last knot not greater than the left end of each bucket
+
+    /// Search in [first, last) for the last knot not greater than xi
+    static std::size_t LastNotGreater(const double* U, const std::size_t& first, const std::size_t& last, const double& rXi)
+    {
+        std::size_t i = std::upper_bound(U + first, U + last, rXi) - U;
+        return (i > 0) ? i - 1 : 0;
+    }
+};
+
+/// output stream function
+inline std::ostream& operator <<(std::ostream& rOStream, const KnotSpanLocator& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_KNOT_SPAN_LOCATOR_H_INCLUDED
@@ -11,6 +11,7 @@
 
 // System includes
 #include <cmath>
+#include <algorithm>
 
 // External includes
 
@@ -64,11 +65,15 @@ public:
 
     /// Empty constructor for serialization
     PBBSplinesBasisFunction() : BaseType(), mBoundaryId(0)
-    {}
+    {
+        std::fill(mLocalKnotOffsets.begin(), mLocalKnotOffsets.end(), 0);
+    }
 
     /// Constructor with Id
     PBBSplinesBasisFunction(const std::size_t& Id) : BaseType(Id), mBoundaryId(0)
-    {}
+    {
+        std::fill(mLocalKnotOffsets.begin(), mLocalKnotOffsets.end(), 0);
+    }
 
     /// Destructor
     ~PBBSplinesBasisFunction()
@@ -124,6 +129,16 @@ public:
         mpLocalKnots[dim].clear();
         for(std::size_t i = 0; i < rpKnots.size(); ++i)
             mpLocalKnots[dim].push_back(rpKnots[i]);
+
+        // refresh the contiguous copy of the knot values
+        mLocalKnotValues.clear();
+        for (int d = 0; d < TDim; ++d)
+        {
+            mLocalKnotOffsets[d] = mLocalKnotValues.size();
+            for(std::size_t i = 0; i < mpLocalKnots[d].size(); ++i)
+                mLocalKnotValues.push_back(CellType::GetValue(mpLocalKnots[d][i]));
+        }
+        mLocalKnotOffsets[TDim] = mLocalKnotValues.size();
     }
 
     /// Get the bounding box (=support domain) of this basis function
@@ -176,6 +191,19 @@ public:
         return true;
     }
 
+    /// Check if the point is in the (closed) support of this basis function, i.e. within the local knot vectors
+    bool IsInSupport(const std::vector<double>& xi) const
+    {
+        for (int dim = 0; dim < TDim; ++dim)
+        {
+            if (mLocalKnotOffsets[dim + 1] == mLocalKnotOffsets[dim])
+                return false;
+            if (xi[dim] < mLocalKnotValues[mLocalKnotOffsets[dim]] || xi[dim] > mLocalKnotValues[mLocalKnotOffsets[dim + 1] - 1])
+                return false;
+        }
+        return true;
+    }
+
     /// Get the value of point-based B-splines basis function
     virtual double GetValueAt(const std::vector<double>& xi) const
     {
@@ -188,25 +216,13 @@ public:
     virtual void GetValueAt(double& res, const std::vector<double>& xi) const
     {
         res = 1.0;
-        // std::cout << "----------" << std::endl;
-        // KRATOS_WATCH(this->Id())
-        // std::cout << "xi: " << xi[0] << " " << xi[1] << std::endl;
+        double val, der;
         for (std::size_t dim = 0; dim < TDim; ++dim)
         {
-            std::vector<double> local_knots;
-            this->LocalKnots(dim, local_knots);
-            // std::cout << "local_knots " << dim << ":";
-            // for (int i = 0; i < local_knots.size(); ++i)
-            //     std::cout << " " << local_knots[i];
-            // std::cout << std::endl;
-            int order = this->Order(dim);
-            // double val = BSplineUtils::CoxDeBoor(xi[dim], 0, order, local_knots);
-            // double val = CoxDeBoor2(xi[dim], 0, order, local_knots);
-            double val = BSplineUtils::CoxDeBoor3(xi[dim], 0, order, local_knots);
-            // KRATOS_WATCH(val)
+            BSplineUtils::CoxDeBoorLocal(val, der, xi[dim], this->Order(dim), &mLocalKnotValues[mLocalKnotOffsets[dim]]);
             res *= val;
+            if (res == 0.0) return;
         }
-        // KRATOS_WATCH(res)
     }
 
     /// Get the derivative of point-based B-splines basis function
@@ -220,8 +236,29 @@ public:
     /// Get the derivative of point-based B-splines basis function
     virtual void GetDerivativeAt(std::vector<double>& res, const std::vector<double>& xi) const
     {
-        // TODO
-        KRATOS_THROW_ERROR(std::logic_error, "Error calling unimplemented function", __FUNCTION__)
+        double val;
+        this->GetValueAndDerivativeAt(val, res, xi);
+    }
+
+    /// Get the value and derivatives of point-based B-splines basis function in one pass
+    virtual void GetValueAndDerivativeAt(double& res, std::vector<double>& dres, const std::vector<double>& xi) const
+    {
+        if (dres.size() != TDim)
+            dres.resize(TDim);
+
+        double val[TDim], der[TDim];
+        for (std::size_t dim = 0; dim < TDim; ++dim)
+            BSplineUtils::CoxDeBoorLocal(val[dim], der[dim], xi[dim], this->Order(dim), &mLocalKnotValues[mLocalKnotOffsets[dim]]);
+
+        res = 1.0;
+        for (std::size_t dim = 0; dim < TDim; ++dim)
+        {
+            res *= val[dim];
+            dres[dim] = der[dim];
+            for (std::size_t dim2 = 0; dim2 < TDim; ++dim2)
+                if (dim2 != dim)
+                    dres[dim] *= val[dim2];
+        }
     }
 
     /**************************************************************************
@@ -315,6 +352,8 @@ protected:
     boost::array<std::size_t, TDim> mOrders;
     cell_container_t mpCells; // list of cells support this basis function
     boost::array<std::vector<knot_t>, TDim> mpLocalKnots;
+    std::vector<double> mLocalKnotValues; // values of the local knots of all directions, stored contiguously
+    boost::array<std::size_t, TDim+1> mLocalKnotOffsets; // the local knots in direction dim are in [mLocalKnotOffsets[dim], mLocalKnotOffsets[dim+1])
 
     /** A pointer to data related to this basis function. */
 
@@ -11,6 +11,8 @@
 
 // System includes
 #include <vector>
+#include <map>
+#include <algorithm>
 
 // External includes
 #include <boost/array.hpp>
@@ -19,6 +21,7 @@
 #include "includes/define.h"
 #include "containers/array_1d.h"
 #include "custom_utilities/fespace.h"
+#include "custom_utilities/bezier_kernels.h"
 #include "isogeometric_application/isogeometric_application.h"
 
 #define DEBUG_GEN_CELL
@@ -54,7 +57,8 @@ public:
     typedef std::map<std::size_t, bf_t> function_map_t;
 
     /// Default constructor
-    PBBSplinesFESpace() : BaseType(), m_function_map_is_created(false)
+    PBBSplinesFESpace() : BaseType(), m_function_map_is_created(false), m_support_index_is_created(false), m_support_index_is_valid(false)
+    , m_support_index_has_crows(false), mEvaluationMode(_EVALUATE_BEZIER_EXTRACTION_)
     {
         mpCellManager = typename cell_container_t::Pointer(new TCellManagerType());
     }
@@ -77,6 +81,7 @@ public:
     void AddBf(bf_t p_bf)
     {
         mpBasisFuncs.insert(p_bf);
+        this->ResetSupportIndex();
     }
 
     /// Check if the bf exists in the list; otherwise create new bf and return
@@ -97,6 +102,7 @@ public:
         }
         mpBasisFuncs.insert(p_bf);
         m_function_map_is_created = false;
+        this->ResetSupportIndex();
 
         return p_bf;
     }
@@ -105,8 +111,29 @@ public:
     void RemoveBf(bf_t p_bf)
     {
         mpBasisFuncs.erase(p_bf);
+        this->ResetSupportIndex();
     }
 
+    /// Mark the support index (parametric location -> cell -> supporting basis functions) to be rebuilt at the next evaluation.
+    /// The index is reset automatically when basis functions are added or removed; call this if the cells of the
+    /// basis functions are modified otherwise.
+    void ResetSupportIndex()
+    {
+        #pragma omp flush
+        #pragma omp atomic write
+        m_support_index_is_created = false;
+    }
+
+    /// Set the point evaluation mode (see PointEvaluationMode)
+    void SetEvaluationMode(const int& mode)
+    {
+        mEvaluationMode = mode;
+        this->ResetSupportIndex();
+    }
+
+    /// Get the point evaluation mode
+    int EvaluationMode() const {return mEvaluationMode;}
+
     // Iterators for the basis functions
     bf_iterator bf_begin() {return mpBasisFuncs.begin();}
     bf_const_iterator bf_begin() const {return mpBasisFuncs.begin();}
@@ -164,17 +191,11 @@ public:
     /// REMARK: This function only returns the unweighted basis function value. To obtain the correct one, use WeightedFESpace
     virtual void GetValue(double& v, const std::size_t& i, const std::vector<double>& xi) const
     {
-        std::size_t j = 0;
-        for (bf_const_iterator it = bf_begin(); it != bf_end(); ++it)
-        {
-            if (j == i)
-            {
-                v = (*it)->GetValueAt(xi);
-                return;
-            }
-            ++j;
-        }
-        v = 0.0;
+        this->CheckSupportIndex();
+        if (i < mLocalBfs.size())
+            v = mLocalBfs[i]->GetValueAt(xi);
+        else
+            v = 0.0;
     }
 
     /// Get the values of the basis functions at point xi
@@ -183,9 +204,13 @@ public:
     {
         if (values.size() != this->TotalNumber())
             values.resize(this->TotalNumber());
-        std::size_t i = 0;
-        for (bf_const_iterator it = bf_begin(); it != bf_end(); ++it)
-            values[i++] = (*it)->GetValueAt(xi);
+        std::fill(values.begin(), values.end(), 0.0);
+
+        std::vector<std::size_t> local_ids;
+        std::vector<double> nonzero_values;
+        this->EvaluateSupportFunctions(local_ids, nonzero_values, NULL, xi);
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+            values[local_ids[k]] = nonzero_values[k];
     }
 
     /// Get the derivative of the basis function i at point xi
@@ -193,21 +218,30 @@ public:
     /// REMARK: This function only returns the unweighted basis function derivatives. To obtain the correct one, use WeightedFESpace
     virtual void GetDerivative(std::vector<double>& values, const std::size_t& i, const std::vector<double>& xi) const
     {
-        std::size_t j = 0;
-        for (bf_const_iterator it = bf_begin(); it != bf_end(); ++it)
+        this->CheckSupportIndex();
+        if (i < mLocalBfs.size())
         {
-            if (j == i)
-            {
-                (*it)->GetDerivativeAt(values, xi);
-                return;
-            }
-            ++j;
+            mLocalBfs[i]->GetDerivativeAt(values, xi);
+            return;
         }
         if (values.size() != TDim)
             values.resize(TDim);
         for (int dim = 0; dim < TDim; ++dim) values[dim] = 0.0;
     }
 
+    /// Get the local knot vectors of the basis function i
+    virtual bool GetLocalKnotVectors(const std::size_t& i, std::vector<std::vector<double> >& rKnots) const
+    {
+        this->CheckSupportIndex();
+        if (i >= mLocalBfs.size())
+            return false;
+
+        rKnots.resize(TDim);
+        for (int dim = 0; dim < TDim; ++dim)
+            mLocalBfs[i]->LocalKnots(dim, rKnots[dim]);
+        return true;
+    }
+
     /// Get the derivative of the basis functions at point xi
     /// the output derivatives has the form of values[func_index][dim_index]
     /// REMARK: This function only returns the unweighted basis function derivatives. To obtain the correct one, use WeightedFESpace
@@ -215,14 +249,15 @@ public:
     {
         if (values.size() != this->TotalNumber())
             values.resize(this->TotalNumber());
-        std::size_t i = 0;
-        for (bf_const_iterator it = bf_begin(); it != bf_end(); ++it)
-        {
-            if (values[i].size() != TDim)
-                values[i].resize(TDim);
-            (*it)->GetDerivativeAt(values[i], xi);
-            ++i;
-        }
+        for (std::size_t i = 0; i < values.size(); ++i)
+            values[i].assign(TDim, 0.0);
+
+        std::vector<std::size_t> local_ids;
+        std::vector<double> nonzero_values;
+        std::vector<std::vector<double> > nonzero_derivatives;
+        this->EvaluateSupportFunctions(local_ids, nonzero_values, &nonzero_derivatives, xi);
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+            values[local_ids[k]] = nonzero_derivatives[k];
     }
 
     /// Get the values and derivatives of the basis functions at point xi
@@ -234,18 +269,39 @@ public:
             values.resize(this->TotalNumber());
         if (derivatives.size() != this->TotalNumber())
             derivatives.resize(this->TotalNumber());
-
-        std::size_t i = 0;
-        for (bf_const_iterator it = bf_begin(); it != bf_end(); ++it)
+        std::fill(values.begin(), values.end(), 0.0);
+        for (std::size_t i = 0; i < derivatives.size(); ++i)
+            derivatives[i].assign(TDim, 0.0);
+
+        std::vector<std::size_t> local_ids;
+        std::vector<double> nonzero_values;
+        std::vector<std::vector<double> > nonzero_derivatives;
+        this->EvaluateSupportFunctions(local_ids, nonzero_values, &nonzero_derivatives, xi);
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
         {
-            values[i] = (*it)->GetValueAt(xi);
-            if (derivatives[i].size() != TDim)
-                derivatives[i].resize(TDim);
-            (*it)->GetDerivativeAt(derivatives[i], xi);
-            ++i;
+            values[local_ids[k]] = nonzero_values[k];
+            derivatives[local_ids[k]] = nonzero_derivatives[k];
         }
     }
 
+    /// Get the values of the basis functions whose support contains point xi
+    /// Only these basis functions are evaluated. In the Bezier extraction mode, the functions vanishing at xi
+    /// because xi is on the boundary of their support may be omitted.
+    /// REMARK: This function only returns the unweighted basis function value. To obtain the correct one, use WeightedFESpace
+    virtual void GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& values, const std::vector<double>& xi) const
+    {
+        this->EvaluateSupportFunctions(local_ids, values, NULL, xi);
+    }
+
+    /// Get the values and derivatives of the basis functions whose support contains point xi
+    /// the output derivatives has the form of derivatives[k][dim_index], k being the position in local_ids
+    /// REMARK: This function only returns the unweighted basis function derivatives. To obtain the correct one, use WeightedFESpace
+    virtual void GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+            std::vector<std::vector<double> >& derivatives, const std::vector<double>& xi) const
+    {
+        this->EvaluateSupportFunctions(local_ids, values, &derivatives, xi);
+    }
+
     /// Compare between two BSplines patches in terms of parametric information
     virtual bool IsCompatible(const FESpace<TDim>& rOtherFESpace) const
     {
@@ -497,11 +553,12 @@ public:
     /// Get the underlying cell manager
     typename cell_container_t::ConstPointer pCellManager() const {return mpCellManager;}
 
-    /// Clean the internal data of all the cells
+    /// Clean the internal data of all the cells. The support index refers to the extraction rows of the cells, hence it is reset too.
     void ResetCells()
     {
         for(typename cell_container_t::iterator it_cell = mpCellManager->begin(); it_cell != mpCellManager->end(); ++it_cell)
             (*it_cell)->Reset();
+        this->ResetSupportIndex();
     }
 
     /// Update the basis functions for all cells. This function must be called before any operation on cell is required.
@@ -527,12 +584,31 @@ public:
         return mpCellManager;
     }
 
+    /// Append the equation ids of the basis functions supported on each cell, taken from the current equation ids of the basis functions
+    virtual void GetCellSupports(std::vector<std::vector<std::size_t> >& rSupports) const
+    {
+        std::map<const CellType*, std::size_t> cell_ids;
+        for (bf_const_iterator it = bf_begin(); it != bf_end(); ++it)
+        {
+            for (typename BasisFunctionType::cell_iterator it_cell = (*it)->cell_begin(); it_cell != (*it)->cell_end(); ++it_cell)
+            {
+                const CellType* p_cell = &(*(*it_cell));
+                typename std::map<const CellType*, std::size_t>::iterator it_id = cell_ids.find(p_cell);
+                if (it_id == cell_ids.end())
+                {
+                    it_id = cell_ids.insert(std::make_pair(p_cell, rSupports.size())).first;
+                    rSupports.push_back(std::vector<std::size_t>());
+                }
+                rSupports[it_id->second].push_back((*it)->EquationId());
+            }
+        }
+    }
+
     /// Overload operator[], this allows to access the basis function randomly based on index
     bf_t operator[](const std::size_t& i)
     {
-        typename bf_container_t::iterator it = mpBasisFuncs.begin();
-        std::advance(it, i);
-        return *it;
+        this->CheckSupportIndex();
+        return mLocalBfs[i];
     }
 
     /// Overload operator(), this allows to access the basis function based on its id
@@ -613,6 +689,519 @@ protected:
             mFunctionsMap[(*it)->Id()] = *it;
         m_function_map_is_created = true;
     }
+
+    /// Search for the local ids (in ascending order) of the basis functions whose support contains xi
+    void FindSupportFunctions(std::vector<std::size_t>& local_ids, const std::vector<double>& xi) const
+    {
+        this->CheckSupportIndex();
+
+        local_ids.clear();
+        if (!m_support_index_is_valid)
+        {
+            for (std::size_t i = 0; i < mLocalBfs.size(); ++i)
+                if (mLocalBfs[i]->IsInSupport(xi))
+                    local_ids.push_back(i);
+            return;
+        }
+
+        // the functions supported on the cells containing xi. A point on a cell boundary belongs to all the neighbours.
+        std::vector<std::size_t> cells;
+        this->FindCells(cells, &xi[0], &xi[0], false);
+        for (std::size_t i = 0; i < cells.size(); ++i)
+        {
+            const std::size_t c = cells[i];
+            for (std::size_t k = mSupportIndexCellPtr[c]; k < mSupportIndexCellPtr[c + 1]; ++k)
+                local_ids.push_back(mSupportIndexFunctions[k]);
+        }
+
+        std::sort(local_ids.begin(), local_ids.end());
+        local_ids.erase(std::unique(local_ids.begin(), local_ids.end()), local_ids.end());
+
+        std::size_t cnt = 0;
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+            if (mLocalBfs[local_ids[k]]->IsInSupport(xi))
+                local_ids[cnt++] = local_ids[k];
+        local_ids.resize(cnt);
+    }
+
+    /// Evaluate the basis functions supported at xi, and their derivatives if pDerivatives is not NULL
+    void EvaluateSupportFunctions(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+            std::vector<std::vector<double> >* pDerivatives, const std::vector<double>& xi) const
+    {
+        this->CheckSupportIndex();
+
+        if (m_support_index_is_valid && m_support_index_has_crows && mEvaluationMode == _EVALUATE_BEZIER_EXTRACTION_)
+        {
+            this->EvaluateBezierExtraction(local_ids, values, pDerivatives, xi);
+            return;
+        }
+
+        this->FindSupportFunctions(local_ids, xi);
+        values.resize(local_ids.size());
+        if (pDerivatives != NULL)
+        {
+            pDerivatives->resize(local_ids.size());
+            for (std::size_t k = 0; k < local_ids.size(); ++k)
+                mLocalBfs[local_ids[k]]->GetValueAndDerivativeAt(values[k], (*pDerivatives)[k], xi);
+        }
+        else
+        {
+            for (std::size_t k = 0; k < local_ids.size(); ++k)
+                values[k] = mLocalBfs[local_ids[k]]->GetValueAt(xi);
+        }
+    }
+
+    /// Evaluate the basis functions supported on the cell containing xi by applying the extraction rows kept by the cell
+    /// to the Bernstein polynomials. Same as the Cox-de Boor evaluation, the cell on the right is taken when xi is on
+    /// a cell boundary, except at the end of the domain.
+    void EvaluateBezierExtraction(std::vector<std::size_t>& local_ids, std::vector<double>& values,
+            std::vector<std::vector<double> >* pDerivatives, const std::vector<double>& xi) const
+    {
+        local_ids.clear();
+        values.clear();
+        if (pDerivatives != NULL)
+            pDerivatives->clear();
+
+        // locate the cell
+        const std::size_t c = this->FindCell(&xi[0]);
+        if (c == static_cast<std::size_t>(-1))
+            return;
+
+        // univariate Bernstein polynomials and their derivatives on the cell
+        double ders[TDim][2 * (BernsteinBasis::MaxDegree + 1)];
+        std::size_t n[TDim], nb = 1;
+        for (int dim = 0; dim < TDim; ++dim)
+        {
+            const int p = this->Order(dim);
+            n[dim] = p + 1;
+            nb *= n[dim];
+            const double xmin = CellMin(*mSupportIndexCells[c], dim);
+            const double xmax = CellMax(*mSupportIndexCells[c], dim);
+            BernsteinBasis::Derivatives(ders[dim], p, 1, (xi[dim] - xmin) / (xmax - xmin));
+            for (int i = 0; i <= p; ++i)
+                ders[dim][n[dim] + i] /= (xmax - xmin);
+        }
+
+        // multivariate Bernstein polynomials, ordered as the columns of the extraction rows (first direction outermost)
+        double stack_buffer[256];
+        std::vector<double> heap_buffer;
+        double* B = stack_buffer;
+        if (nb * (TDim + 1) > 256)
+        {
+            heap_buffer.resize(nb * (TDim + 1));
+            B = &heap_buffer[0];
+        }
+        double* dB = B + nb;
+        for (std::size_t j = 0; j < nb; ++j)
+        {
+            std::size_t a[TDim], r = j;
+            for (int dim = TDim - 1; dim >= 0; --dim)
+            {
+                a[dim] = r % n[dim];
+                r /= n[dim];
+            }
+            B[j] = 1.0;
+            for (int dim = 0; dim < TDim; ++dim)
+            {
+                B[j] *= ders[dim][a[dim]];
+                dB[dim * nb + j] = ders[dim][n[dim] + a[dim]];
+                for (int dim2 = 0; dim2 < TDim; ++dim2)
+                    if (dim2 != dim)
+                        dB[dim * nb + j] *= ders[dim2][a[dim2]];
+            }
+        }
+
+        // apply the extraction rows
+        const std::size_t nfuncs = mSupportIndexCellPtr[c + 1] - mSupportIndexCellPtr[c];
+        local_ids.resize(nfuncs);
+        values.resize(nfuncs);
+        if (pDerivatives != NULL)
+            pDerivatives->resize(nfuncs);
+        for (std::size_t k = 0; k < nfuncs; ++k)
+        {
+            const std::size_t e = mSupportIndexCellPtr[c] + k;
+            const typename CellType::RowViewType Crow = mSupportIndexCells[c]->GetCrowView(mSupportIndexCrowPositions[e]);
+            local_ids[k] = mSupportIndexFunctions[e];
+
+            double v = 0.0;
+            for (std::size_t j = 0; j < Crow.NumberOfNonzeros; ++j)
+                v += Crow.Values[j] * B[Crow.Indices[j]];
+            values[k] = v;
+
+            if (pDerivatives != NULL)
+            {
+                std::vector<double>& dv = (*pDerivatives)[k];
+                dv.resize(TDim);
+                for (int dim = 0; dim < TDim; ++dim)
+                {
+                    double d = 0.0;
+                    for (std::size_t j = 0; j < Crow.NumberOfNonzeros; ++j)
+                        d += Crow.Values[j] * dB[dim * nb + Crow.Indices[j]];
+                    dv[dim] = d;
+                }
+            }
+        }
+    }
+
+private:
+
+    /// Node of the bounding volume hierarchy of the cells. The cells of the node are mSupportIndexTreeCells[Begin..End).
+    struct SupportIndexNode
+    {
+        double Box[2 * TDim]; // [min, max] in direction dim at 2*dim
+        std::size_t Begin, End;
+        std::size_t Left, Right; // the children, 0 for a leaf
+    };
+
+    /// Compare the cells by the center of their boxes in one direction
+    struct CellCenterLess
+    {
+        CellCenterLess(const std::vector<double>& rBounds, const int& dim) : mrBounds(rBounds), mDim(dim) {}
+        bool operator() (const std::size_t& c1, const std::size_t& c2) const
+        {
+            return mrBounds[2 * (c1 * TDim + mDim)] + mrBounds[2 * (c1 * TDim + mDim) + 1]
+                 < mrBounds[2 * (c2 * TDim + mDim)] + mrBounds[2 * (c2 * TDim + mDim) + 1];
+        }
+        const std::vector<double>& mrBounds;
+        int mDim;
+    };
+
+    mutable bool m_support_index_is_created;
+    mutable bool m_support_index_is_valid; // false if the cells of the basis functions can't be indexed, then the supports are searched linearly
+    mutable std::vector<bf_t> mLocalBfs; // basis functions by local id
+    mutable std::vector<SupportIndexNode> mSupportIndexTree; // bounding volume hierarchy of the cells, the root is the first node
+    mutable std::vector<std::size_t> mSupportIndexTreeCells; // the cells of the nodes of the hierarchy
+    mutable std::vector<double> mSupportIndexCellBounds; // [min, max] of cell c in direction dim at 2*(c*TDim + dim)
+    mutable std::vector<std::size_t> mSupportIndexCellPtr; // the local ids of the basis functions supported on cell c are
+    mutable std::vector<std::size_t> mSupportIndexFunctions; // mSupportIndexFunctions[mSupportIndexCellPtr[c]..mSupportIndexCellPtr[c+1]]
+    mutable bool m_support_index_has_crows; // true if the cells keep the extraction rows of all their basis functions, see UpdateCells
+    mutable std::vector<typename BasisFunctionType::cell_t> mSupportIndexCells; // the indexed cells
+    mutable std::vector<std::size_t> mSupportIndexCrowPositions; // the position of the k-th entry of mSupportIndexFunctions in the anchors of its cell
+    int mEvaluationMode;
+
+    static double CellMin(const CellType& r_cell, const int& dim)
+    {
+        if (dim == 0) return r_cell.XiMinValue();
+        else if (dim == 1) return r_cell.EtaMinValue();
+        else return r_cell.ZetaMinValue();
+    }
+
+    static double CellMax(const CellType& r_cell, const int& dim)
+    {
+        if (dim == 0) return r_cell.XiMaxValue();
+        else if (dim == 1) return r_cell.EtaMaxValue();
+        else return r_cell.ZetaMaxValue();
+    }
+
+    /// Check if the box intersects [lo, hi]. If Strict, only the intersection with the interior of the box is taken.
+    static bool IsIntersected(const double* box, const double* lo, const double* hi, const bool& Strict)
+    {
+        for (int dim = 0; dim < TDim; ++dim)
+        {
+            if (Strict)
+            {
+                if (hi[dim] <= box[2 * dim] || lo[dim] >= box[2 * dim + 1])
+                    return false;
+            }
+            else
+            {
+                if (hi[dim] < box[2 * dim] || lo[dim] > box[2 * dim + 1])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /// Build the node of the hierarchy containing the cells mSupportIndexTreeCells[begin..end), and its children. The cells are
+    /// split at the median of their centers along the longest direction of the node, hence the depth of the hierarchy is O(log(n)).
+    std::size_t BuildSupportIndexTree(const std::size_t& begin, const std::size_t& end) const
+    {
+        const std::size_t node = mSupportIndexTree.size();
+        mSupportIndexTree.push_back(SupportIndexNode());
+
+        double box[2 * TDim];
+        for (int dim = 0; dim < TDim; ++dim)
+        {
+            box[2 * dim] = mSupportIndexCellBounds[2 * (mSupportIndexTreeCells[begin] * TDim + dim)];
+            box[2 * dim + 1] = mSupportIndexCellBounds[2 * (mSupportIndexTreeCells[begin] * TDim + dim) + 1];
+            for (std::size_t k = begin + 1; k < end; ++k)
+            {
+                box[2 * dim] = std::min(box[2 * dim], mSupportIndexCellBounds[2 * (mSupportIndexTreeCells[k] * TDim + dim)]);
+                box[2 * dim + 1] = std::max(box[2 * dim + 1], mSupportIndexCellBounds[2 * (mSupportIndexTreeCells[k] * TDim + dim) + 1]);
+            }
+        }
+
+        std::size_t left = 0, right = 0;
+        if (end - begin > 4)
+        {
+            int split_dim = 0;
+            for (int dim = 1; dim < TDim; ++dim)
+                if (box[2 * dim + 1] - box[2 * dim] > box[2 * split_dim + 1] - box[2 * split_dim])
+                    split_dim = dim;
+
+            const std::size_t mid = (begin + end) / 2;
+            std::nth_element(mSupportIndexTreeCells.begin() + begin, mSupportIndexTreeCells.begin() + mid,
+                    mSupportIndexTreeCells.begin() + end, CellCenterLess(mSupportIndexCellBounds, split_dim));
+            left = this->BuildSupportIndexTree(begin, mid);
+            right = this->BuildSupportIndexTree(mid, end);
+        }
+
+        SupportIndexNode& r_node = mSupportIndexTree[node];
+        std::copy(box, box + 2 * TDim, r_node.Box);
+        r_node.Begin = begin;
+        r_node.End = end;
+        r_node.Left = left;
+        r_node.Right = right;
+        return node;
+    }
+
+    /// Find the indexed cells intersecting [lo, hi]. If Strict, only the cells whose interior intersects [lo, hi] are taken.
+    void FindCells(std::vector<std::size_t>& rCells, const double* lo, const double* hi, const bool& Strict) const
+    {
+        rCells.clear();
+        if (mSupportIndexTree.empty())
+            return;
+
+        std::size_t stack[64]; // the depth of the hierarchy is logarithmic in the number of cells
+        std::size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const SupportIndexNode& r_node = mSupportIndexTree[stack[--top]];
+            if (!IsIntersected(r_node.Box, lo, hi, Strict))
+                continue;
+
+            if (r_node.Left == 0)
+            {
+                for (std::size_t k = r_node.Begin; k < r_node.End; ++k)
+                    if (IsIntersected(&mSupportIndexCellBounds[2 * mSupportIndexTreeCells[k] * TDim], lo, hi, Strict))
+                        rCells.push_back(mSupportIndexTreeCells[k]);
+            }
+            else
+            {
+                stack[top++] = r_node.Left;
+                stack[top++] = r_node.Right;
+            }
+        }
+    }
+
+    /// Find the indexed cell containing xi. The cell on the right is taken when xi is on a cell boundary, except at the end of the domain.
+    /// Return -1 if xi is not in any cell.
+    std::size_t FindCell(const double* xi) const
+    {
+        if (mSupportIndexTree.empty())
+            return static_cast<std::size_t>(-1);
+
+        const double* domain = mSupportIndexTree[0].Box;
+        std::size_t stack[64];
+        std::size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const SupportIndexNode& r_node = mSupportIndexTree[stack[--top]];
+            if (!IsIntersected(r_node.Box, xi, xi, false))
+                continue;
+
+            if (r_node.Left == 0)
+            {
+                for (std::size_t k = r_node.Begin; k < r_node.End; ++k)
+                {
+                    const double* box = &mSupportIndexCellBounds[2 * mSupportIndexTreeCells[k] * TDim];
+                    bool found = true;
+                    for (int dim = 0; dim < TDim && found; ++dim)
+                        found = (xi[dim] >= box[2 * dim])
+                             && ((xi[dim] < box[2 * dim + 1]) || ((xi[dim] == box[2 * dim + 1]) && (box[2 * dim + 1] == domain[2 * dim + 1])));
+                    if (found)
+                        return mSupportIndexTreeCells[k];
+                }
+            }
+            else
+            {
+                stack[top++] = r_node.Left;
+                stack[top++] = r_node.Right;
+            }
+        }
+
+        return static_cast<std::size_t>(-1);
+    }
+
+    /// Check if the support index is up to date, without locking
+    bool IsSupportIndexCreated() const
+    {
+        bool is_created;
+        #pragma omp atomic read
+        is_created = m_support_index_is_created;
+        #pragma omp flush
+        return is_created;
+    }
+
+    /// Build the support index if it is not up to date. The flag is published atomically after the index is built, hence the
+    /// index is read without locking once it is created. The error raised while building is thrown after the critical section.
+    void CheckSupportIndex() const
+    {
+        if (!this->IsSupportIndexCreated())
+        {
+            std::string error_message;
+
+            #pragma omp critical(PBBSplinesFESpace_CreateSupportIndex)
+            {
+                if (!this->IsSupportIndexCreated())
+                {
+                    try
+                    {
+                        this->CreateSupportIndex();
+
+                        #pragma omp flush
+                        #pragma omp atomic write
+                        m_support_index_is_created = true;
+                    }
+                    catch (std::exception& e)
+                    {
+                        error_message = e.what();
+                    }
+                }
+            }
+
+            if (!error_message.empty())
+                KRATOS_THROW_ERROR(std::logic_error, "Error at creating the support index:", error_message)
+        }
+    }
+
+    /// Build the index from parametric location to the containing cell, and from cell to the supporting basis functions.
+    /// The cells are indexed by a bounding volume hierarchy, hence the memory is linear in the number of cells.
+    void CreateSupportIndex() const
+    {
+        mLocalBfs.assign(bf_begin(), bf_end());
+        m_support_index_is_valid = true;
+
+        // collect the cells and the basis functions supported on each of them
+        std::map<const CellType*, std::size_t> cell_ids;
+        std::vector<typename BasisFunctionType::cell_t> cells;
+        std::vector<std::vector<std::size_t> > cell_functions;
+        for (std::size_t i = 0; i < mLocalBfs.size(); ++i)
+        {
+            if (mLocalBfs[i]->cell_begin() == mLocalBfs[i]->cell_end())
+                m_support_index_is_valid = false;
+
+            for (typename BasisFunctionType::cell_iterator it_cell = mLocalBfs[i]->cell_begin(); it_cell != mLocalBfs[i]->cell_end(); ++it_cell)
+            {
+                const CellType* p_cell = &(*(*it_cell));
+                typename std::map<const CellType*, std::size_t>::iterator it = cell_ids.find(p_cell);
+                if (it == cell_ids.end())
+                {
+                    it = cell_ids.insert(std::make_pair(p_cell, cells.size())).first;
+                    cells.push_back(*it_cell);
+                    cell_functions.push_back(std::vector<std::size_t>());
+                }
+                cell_functions[it->second].push_back(i);
+            }
+        }
+        if (cells.empty())
+            m_support_index_is_valid = false;
+
+        mSupportIndexTree.clear();
+        mSupportIndexTreeCells.clear();
+        mSupportIndexCellBounds.clear();
+        mSupportIndexCellPtr.clear();
+        mSupportIndexFunctions.clear();
+        mSupportIndexCells.clear();
+        mSupportIndexCrowPositions.clear();
+        m_support_index_has_crows = false;
+        if (!m_support_index_is_valid)
+            return;
+
+        // the bounds of the cells
+        mSupportIndexCellBounds.resize(2 * cells.size() * TDim);
+        for (std::size_t c = 0; c < cells.size() && m_support_index_is_valid; ++c)
+        {
+            for (int dim = 0; dim < TDim; ++dim)
+            {
+                mSupportIndexCellBounds[2 * (c * TDim + dim)] = CellMin(*cells[c], dim);
+                mSupportIndexCellBounds[2 * (c * TDim + dim) + 1] = CellMax(*cells[c], dim);
+                if (!(mSupportIndexCellBounds[2 * (c * TDim + dim)] < mSupportIndexCellBounds[2 * (c * TDim + dim) + 1]))
+                    m_support_index_is_valid = false; // degenerated cell
+            }
+        }
+
+        // the hierarchy of the cells. The cells must not overlap.
+        if (m_support_index_is_valid)
+        {
+            mSupportIndexTreeCells.resize(cells.size());
+            for (std::size_t c = 0; c < cells.size(); ++c)
+                mSupportIndexTreeCells[c] = c;
+            mSupportIndexTree.reserve(2 * cells.size());
+            this->BuildSupportIndexTree(0, cells.size());
+
+            std::vector<std::size_t> overlapped_cells;
+            for (std::size_t c = 0; c < cells.size() && m_support_index_is_valid; ++c)
+            {
+                const double* box = &mSupportIndexCellBounds[2 * c * TDim];
+                double lo[TDim], hi[TDim];
+                for (int dim = 0; dim < TDim; ++dim)
+                {
+                    lo[dim] = box[2 * dim];
+                    hi[dim] = box[2 * dim + 1];
+                }
+                this->FindCells(overlapped_cells, lo, hi, true);
+                if (overlapped_cells.size() != 1)
+                    m_support_index_is_valid = false;
+            }
+        }
+
+        if (!m_support_index_is_valid)
+        {
+            std::cout << "WARNING!!! " << Type() << ": the cells overlap or are degenerated, the basis functions will be searched linearly" << std::endl;
+            mSupportIndexTree.clear();
+            mSupportIndexTreeCells.clear();
+            mSupportIndexCellBounds.clear();
+            return;
+        }
+
+        mSupportIndexCellPtr.resize(cells.size() + 1);
+        mSupportIndexCellPtr[0] = 0;
+        for (std::size_t c = 0; c < cells.size(); ++c)
+        {
+            mSupportIndexCellPtr[c + 1] = mSupportIndexCellPtr[c] + cell_functions[c].size();
+            mSupportIndexFunctions.insert(mSupportIndexFunctions.end(), cell_functions[c].begin(), cell_functions[c].end());
+        }
+
+        mSupportIndexCells.swap(cells);
+
+        // refer to the extraction rows kept by the cells. The anchors of a cell are the equation ids of its basis functions at the
+        // last UpdateCells; if they are not up to date, the rows are not referred and the basis functions are evaluated directly.
+        std::size_t nb = 1;
+        for (int dim = 0; dim < TDim; ++dim)
+            nb *= this->Order(dim) + 1;
+
+        m_support_index_has_crows = true;
+        mSupportIndexCrowPositions.resize(mSupportIndexFunctions.size());
+        for (std::size_t c = 0; c < mSupportIndexCells.size() && m_support_index_has_crows; ++c)
+        {
+            const CellType& r_cell = *mSupportIndexCells[c];
+            const std::vector<std::size_t>& anchors = r_cell.GetSupportedAnchors();
+            if (!r_cell.HasCrowsInArena() || (anchors.size() != mSupportIndexCellPtr[c + 1] - mSupportIndexCellPtr[c]))
+            {
+                m_support_index_has_crows = false;
+                break;
+            }
+
+            for (std::size_t k = mSupportIndexCellPtr[c]; k < mSupportIndexCellPtr[c + 1]; ++k)
+            {
+                const std::size_t equation_id = mLocalBfs[mSupportIndexFunctions[k]]->EquationId();
+                const std::size_t pos = std::find(anchors.begin(), anchors.end(), equation_id) - anchors.begin();
+                if ((pos == anchors.size()) || (std::count(anchors.begin(), anchors.end(), equation_id) != 1)
+                        || (r_cell.GetCrowView(pos).Size != nb))
+                {
+                    m_support_index_has_crows = false;
+                    break;
+                }
+                mSupportIndexCrowPositions[k] = pos;
+            }
+        }
+
+        if (!m_support_index_has_crows)
+            mSupportIndexCrowPositions.clear();
+    }
 };
 
 /// output stream function
@@ -0,0 +1,305 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 2026-10-16 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_PRECOMPUTE_MANAGER_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_PRECOMPUTE_MANAGER_H_INCLUDED
+
+// System includes
+#include <map>
+#include <list>
+#include <string>
+#include <iostream>
+
+// External includes
+#include <boost/shared_ptr.hpp>
+
+// Project includes
+#include "includes/define.h"
+#include "includes/ublas_interface.h"
+#include "geometries/geometry_data.h"
+#include "custom_utilities/iga_define.h"
+
+
+namespace Kratos
+{
+
+/**
+ * Global settings and counters of the shape function tables precompute policy (see ShapeFunctionsPrecomputePolicy),
+ * and the store of the tables released by the geometries under the _PRECOMPUTE_LRU_ policy.
+ * The counters are:
+ *  + hits: Initialize found the tables of the geometry already computed
+ *  + misses: Initialize had to compute the tables (only counted for the policies which keep the tables)
+ *  + evictions: tables released from the LRU store because of the memory budget
+ *  + bytes resident: memory of the tables kept between two assemblies, i.e. by the lazy/eager geometries and in the LRU store
+ * The manager is thread-safe.
+ */
+class ShapeFunctionsPrecomputeManager
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(ShapeFunctionsPrecomputeManager);
+
+    /// Type definitions
+    typedef GeometryData::IntegrationMethod IntegrationMethod;
+    typedef GeometryData::ShapeFunctionsGradientsType ShapeFunctionsGradientsType;
+    typedef boost::shared_ptr<const Matrix> ValuesPointerType;
+    typedef boost::shared_ptr<const ShapeFunctionsGradientsType> GradientsPointerType;
+
+    /// Default constructor, only used to expose the static functions to Python
+    ShapeFunctionsPrecomputeManager() {}
+
+    /// Destructor
+    virtual ~ShapeFunctionsPrecomputeManager() {}
+
+    /// Set/get the policy given to the newly created geometries
+    static void SetDefaultPolicy(const int& Policy) {Settings().DefaultPolicy = Policy;}
+    static int DefaultPolicy() {return Settings().DefaultPolicy;}
+
+    /// Set/get the maximum memory (in bytes) of the LRU store
+    static void SetMemoryBudget(const std::size_t& Budget)
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        {
+            Settings().MemoryBudget = Budget;
+            EvictIfNeeded();
+        }
+    }
+    static std::size_t MemoryBudget() {return Settings().MemoryBudget;}
+
+    /// Memory used by the tables
+    static std::size_t MemoryUsage(const Matrix& rValues, const ShapeFunctionsGradientsType& rGradients)
+    {
+        std::size_t size = sizeof(Matrix) + rValues.size1() * rValues.size2() * sizeof(double);
+        size += sizeof(ShapeFunctionsGradientsType);
+        for(std::size_t i = 0; i < rGradients.size(); ++i)
+            size += sizeof(Matrix) + rGradients[i].size1() * rGradients[i].size2() * sizeof(double);
+        return size;
+    }
+
+    /**
+     * Give the tables of a geometry to the LRU store; the least recently used tables are evicted if the budget is exceeded.
+     * Size is the memory attributed to the geometry, i.e. 0 if the tables are held by the ShapeFunctionsTableCache.
+     */
+    static void Release(const void* pOwner, const IntegrationMethod& ThisMethod,
+            const ValuesPointerType& pValues, const GradientsPointerType& pGradients, const std::size_t& Size)
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        {
+            EraseEntry(pOwner);
+
+            EntryType Entry;
+            Entry.pOwner = pOwner;
+            Entry.Method = ThisMethod;
+            Entry.pValues = pValues;
+            Entry.pGradients = pGradients;
+            Entry.Size = Size;
+            GetList().push_front(Entry);
+            GetIndex()[pOwner] = GetList().begin();
+            GetStatistics().BytesInStore += Size;
+            GetStatistics().BytesResident += Size;
+
+            EvictIfNeeded();
+        }
+    }
+
+    /// Take back the tables of a geometry from the LRU store. Return false if the tables were evicted or were computed for another integration method.
+    static bool Acquire(const void* pOwner, const IntegrationMethod& ThisMethod,
+            ValuesPointerType& rpValues, GradientsPointerType& rpGradients, std::size_t& rSize)
+    {
+        bool found = false;
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        {
+            StoreIndexType::iterator it = GetIndex().find(pOwner);
+            if(it != GetIndex().end())
+            {
+                const EntryType& rEntry = *(it->second);
+                if(rEntry.Method == ThisMethod)
+                {
+                    rpValues = rEntry.pValues;
+                    rpGradients = rEntry.pGradients;
+                    rSize = rEntry.Size;
+                    found = true;
+                }
+                EraseEntry(pOwner);
+            }
+        }
+        return found;
+    }
+
+    /// Remove the tables of a geometry from the LRU store, e.g. when the geometry is destroyed
+    static void Remove(const void* pOwner)
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        {
+            EraseEntry(pOwner);
+        }
+    }
+
+    /// Release all the tables in the LRU store
+    static void Clear()
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        {
+            while(!GetList().empty())
+                EraseEntry(GetList().back().pOwner);
+        }
+    }
+
+    /// Counters update, to be called by the geometries
+    static void AddHit()
+    {
+        #pragma omp atomic
+        ++GetStatistics().NumberOfHits;
+    }
+
+    static void AddMiss()
+    {
+        #pragma omp atomic
+        ++GetStatistics().NumberOfMisses;
+    }
+
+    static void AddResident(const std::size_t& Size)
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        GetStatistics().BytesResident += Size;
+    }
+
+    static void RemoveResident(const std::size_t& Size)
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        GetStatistics().BytesResident -= Size;
+    }
+
+    /// Reset the hit/miss/eviction counters
+    static void ResetStatistics()
+    {
+        #pragma omp critical(ShapeFunctionsPrecomputeManager_Store)
+        {
+            GetStatistics().NumberOfHits = 0;
+            GetStatistics().NumberOfMisses = 0;
+            GetStatistics().NumberOfEvictions = 0;
+        }
+    }
+
+    /// Statistics
+    static std::size_t NumberOfHits() {return GetStatistics().NumberOfHits;}
+    static std::size_t NumberOfMisses() {return GetStatistics().NumberOfMisses;}
+    static std::size_t NumberOfEvictions() {return GetStatistics().NumberOfEvictions;}
+    static std::size_t BytesResident() {return GetStatistics().BytesResident;}
+    static std::size_t BytesInStore() {return GetStatistics().BytesInStore;}
+
+    /// Name of a policy
+    static std::string PolicyName(const int& Policy)
+    {
+        switch(Policy)
+        {
+            case _PRECOMPUTE_NEVER_: return "never";
+            case _PRECOMPUTE_LAZY_:  return "lazy";
+            case _PRECOMPUTE_EAGER_: return "eager";
+            case _PRECOMPUTE_LRU_:   return "lru";
+            default:                 return "unknown";
+        }
+    }
+
+    /// Information
+    virtual void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "ShapeFunctionsPrecomputeManager (default policy: " << PolicyName(DefaultPolicy()) << "): "
+                 << NumberOfHits() << " hits, " << NumberOfMisses() << " misses, "
+                 << NumberOfEvictions() << " evictions, " << BytesResident() << " bytes resident, "
+                 << BytesInStore() << "/" << MemoryBudget() << " bytes in LRU store";
+    }
+
+private:
+
+    struct EntryType
+    {
+        const void* pOwner;
+        IntegrationMethod Method;
+        ValuesPointerType pValues;
+        GradientsPointerType pGradients;
+        std::size_t Size;
+    };
+
+    typedef std::list<EntryType> ListType;
+    typedef std::map<const void*, ListType::iterator> StoreIndexType;
+
+    struct SettingsType
+    {
+        SettingsType() : DefaultPolicy(_PRECOMPUTE_NEVER_), MemoryBudget(256*1024*1024) {}
+        int DefaultPolicy;
+        std::size_t MemoryBudget;
+    };
+
+    struct StatisticsType
+    {
+        StatisticsType() : NumberOfHits(0), NumberOfMisses(0), NumberOfEvictions(0), BytesResident(0), BytesInStore(0) {}
+        std::size_t NumberOfHits;
+        std::size_t NumberOfMisses;
+        std::size_t NumberOfEvictions;
+        std::size_t BytesResident;
+        std::size_t BytesInStore;
+    };
+
+    /// to be called inside the critical section
+    static void EraseEntry(const void* pOwner)
+    {
+        StoreIndexType::iterator it = GetIndex().find(pOwner);
+        if(it == GetIndex().end())
+            return;
+        GetStatistics().BytesInStore -= it->second->Size;
+        GetStatistics().BytesResident -= it->second->Size;
+        GetList().erase(it->second);
+        GetIndex().erase(it);
+    }
+
+    /// to be called inside the critical section
+    static void EvictIfNeeded()
+    {
+        while(GetStatistics().BytesInStore > Settings().MemoryBudget && !GetList().empty())
+        {
+            EraseEntry(GetList().back().pOwner);
+            ++GetStatistics().NumberOfEvictions;
+        }
+    }
+
+    static ListType& GetList()
+    {
+        static ListType list;
+        return list;
+    }
+
+    static StoreIndexType& GetIndex()
+    {
+        static StoreIndexType index;
+        return index;
+    }
+
+    static SettingsType& Settings()
+    {
+        static SettingsType settings;
+        return settings;
+    }
+
+    static StatisticsType& GetStatistics()
+    {
+        static StatisticsType stats;
+        return stats;
+    }
+};
+
+/// output stream function
+inline std::ostream& operator <<(std::ostream& rOStream, const ShapeFunctionsPrecomputeManager& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_PRECOMPUTE_MANAGER_H_INCLUDED
@@ -0,0 +1,114 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 2026-10-16 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_PRECOMPUTE_UTILITY_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_PRECOMPUTE_UTILITY_H_INCLUDED
+
+// System includes
+#include <vector>
+#include <iostream>
+
+// External includes
+
+// Project includes
+#include "includes/define.h"
+#include "includes/model_part.h"
+#include "utilities/openmp_utils.h"
+#include "custom_utilities/iga_define.h"
+#include "custom_utilities/shape_functions_precompute_manager.h"
+#include "custom_geometries/isogeometric_geometry.h"
+#include "isogeometric_application/isogeometric_application.h"
+
+
+namespace Kratos
+{
+
+/**
+ * Utility to select the precompute policy of the shape function tables (see ShapeFunctionsPrecomputePolicy) of the
+ * isogeometric elements and conditions of a model part. The entities with a non-isogeometric geometry are skipped.
+ * The eager tables are computed in parallel.
+ */
+class ShapeFunctionsPrecomputeUtility
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(ShapeFunctionsPrecomputeUtility);
+
+    /// Type definitions
+    typedef ModelPart::NodeType NodeType;
+    typedef IsogeometricGeometry<NodeType> IsogeometricGeometryType;
+
+    /// Default constructor
+    ShapeFunctionsPrecomputeUtility() {}
+
+    /// Destructor
+    virtual ~ShapeFunctionsPrecomputeUtility() {}
+
+    /// Set the same policy to all the elements and conditions of the model part
+    static void SetPolicy(ModelPart& r_model_part, const int& Policy)
+    {
+        SetPolicy(r_model_part.Elements(), Policy, false);
+        SetPolicy(r_model_part.Conditions(), Policy, false);
+    }
+
+    /**
+     * Set the policy of the elements and conditions given by SHAPE_FUNCTIONS_PRECOMPUTE_POLICY in their properties.
+     * The entities whose properties do not define SHAPE_FUNCTIONS_PRECOMPUTE_POLICY are not changed.
+     */
+    static void SetPolicyFromProperties(ModelPart& r_model_part)
+    {
+        SetPolicy(r_model_part.Elements(), _PRECOMPUTE_NEVER_, true);
+        SetPolicy(r_model_part.Conditions(), _PRECOMPUTE_NEVER_, true);
+    }
+
+    /// Information
+    virtual void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "ShapeFunctionsPrecomputeUtility";
+    }
+
+private:
+
+    template<class TEntitiesContainerType>
+    static void SetPolicy(TEntitiesContainerType& rEntities, const int& Policy, const bool& FromProperties)
+    {
+        int number_of_threads = OpenMPUtils::GetNumThreads();
+        OpenMPUtils::PartitionVector partition;
+        OpenMPUtils::DivideInPartitions(rEntities.size(), number_of_threads, partition);
+
+        #pragma omp parallel for
+        for(int k = 0; k < number_of_threads; ++k)
+        {
+            typename TEntitiesContainerType::ptr_iterator it_begin = rEntities.ptr_begin() + partition[k];
+            typename TEntitiesContainerType::ptr_iterator it_end = rEntities.ptr_begin() + partition[k + 1];
+
+            for(typename TEntitiesContainerType::ptr_iterator it = it_begin; it != it_end; ++it)
+            {
+                IsogeometricGeometryType* pGeometry = dynamic_cast<IsogeometricGeometryType*>(&(*it)->GetGeometry());
+                if(pGeometry == NULL)
+                    continue;
+
+                if(!FromProperties)
+                    pGeometry->SetPrecomputePolicy(Policy);
+                else if((*it)->GetProperties().Has(SHAPE_FUNCTIONS_PRECOMPUTE_POLICY))
+                    pGeometry->SetPrecomputePolicy((*it)->GetProperties()[SHAPE_FUNCTIONS_PRECOMPUTE_POLICY]);
+            }
+        }
+    }
+};
+
+/// output stream function
+inline std::ostream& operator <<(std::ostream& rOStream, const ShapeFunctionsPrecomputeUtility& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_PRECOMPUTE_UTILITY_H_INCLUDED
@@ -0,0 +1,318 @@
+//
+//   Project Name:        Kratos
+//   Last Modified by:    $Author: hbui $
+//   Date:                $Date: 2026-10-16 $
+//   Revision:            $Revision: 1.0 $
+//
+//
+
+#if !defined(KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_TABLE_CACHE_H_INCLUDED )
+#define  KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_TABLE_CACHE_H_INCLUDED
+
+// System includes
+#include <map>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+// External includes
+#include <boost/shared_ptr.hpp>
+#include <boost/functional/hash.hpp>
+
+// Project includes
+#include "includes/define.h"
+#include "includes/ublas_interface.h"
+#include "geometries/geometry_data.h"
+
+
+namespace Kratos
+{
+
+/**
+ * Cache of the shape function values and local gradients at the integration points, shared between the geometries of
+ * the same equivalence class. Two geometries are equivalent if they use the same degrees, the same integration rule,
+ * the same (pooled) extraction operator and the same control weights up to a scaling factor; this is the case of all
+ * B-splines elements and of NURBS elements in polynomial regions.
+ * The cache is disabled by default. The stored tables are immutable and are kept until Clear() is called. A table is
+ * not stored if the memory budget would be exceeded.
+ * The cache is thread-safe.
+ */
+class ShapeFunctionsTableCache
+{
+public:
+    /// Pointer definition
+    KRATOS_CLASS_POINTER_DEFINITION(ShapeFunctionsTableCache);
+
+    /// Type definitions
+    typedef GeometryData::ShapeFunctionsGradientsType ShapeFunctionsGradientsType;
+    typedef boost::shared_ptr<const Matrix> ValuesPointerType;
+    typedef boost::shared_ptr<const ShapeFunctionsGradientsType> GradientsPointerType;
+
+    /**
+     * Key of an equivalence class. The objects (integration rule, extraction operators) are compared by address; the key
+     * holds a reference to them, hence the address cannot be reused by another object while the key is alive.
+     */
+    class KeyType
+    {
+    public:
+        KeyType() : mHash(0) {}
+
+        void AddInteger(const int& i)
+        {
+            mIntegers.push_back(i);
+            boost::hash_combine(mHash, i);
+        }
+
+        void AddObject(const boost::shared_ptr<const void>& pObject)
+        {
+            mObjects.push_back(pObject);
+            boost::hash_combine(mHash, pObject.get());
+        }
+
+        /// Set the control weights. The weights are normalized by the largest one since the rational basis is invariant by scaling.
+        template<class TVectorType>
+        void SetWeights(const TVectorType& rWeights)
+        {
+            double wmax = 0.0;
+            for(std::size_t i = 0; i < rWeights.size(); ++i)
+                wmax = std::max(wmax, std::fabs(rWeights[i]));
+            if(wmax == 0.0)
+                wmax = 1.0;
+
+            mNormalizedWeights.resize(rWeights.size(), false);
+            boost::hash_combine(mHash, rWeights.size());
+            for(std::size_t i = 0; i < rWeights.size(); ++i)
+            {
+                mNormalizedWeights[i] = rWeights[i] / wmax;
+                boost::hash_combine(mHash, static_cast<long long>(std::floor(mNormalizedWeights[i] / (1.0e3 * Tolerance()) + 0.5)));
+            }
+        }
+
+        std::size_t Hash() const {return mHash;}
+
+        bool IsEqual(const KeyType& rOther) const
+        {
+            if(mIntegers != rOther.mIntegers)
+                return false;
+            if(mObjects.size() != rOther.mObjects.size())
+                return false;
+            for(std::size_t i = 0; i < mObjects.size(); ++i)
+                if(mObjects[i].get() != rOther.mObjects[i].get())
+                    return false;
+            if(mNormalizedWeights.size() != rOther.mNormalizedWeights.size())
+                return false;
+            for(std::size_t i = 0; i < mNormalizedWeights.size(); ++i)
+                if(std::fabs(mNormalizedWeights[i] - rOther.mNormalizedWeights[i]) > Tolerance())
+                    return false;
+            return true;
+        }
+
+        std::size_t MemoryUsage() const
+        {
+            return sizeof(KeyType) + mIntegers.size() * sizeof(int)
+                 + mObjects.size() * sizeof(boost::shared_ptr<const void>)
+                 + mNormalizedWeights.size() * sizeof(double);
+        }
+
+        static double Tolerance() {return 1.0e-10;}
+
+    private:
+        std::size_t mHash;
+        std::vector<int> mIntegers;
+        std::vector<boost::shared_ptr<const void> > mObjects;
+        Vector mNormalizedWeights;
+    };
+
+    /// Default constructor, only used to expose the static functions to Python
+    ShapeFunctionsTableCache() {}
+
+    /// Destructor
+    virtual ~ShapeFunctionsTableCache() {}
+
+    /// Enable/disable the cache. Disabling the cache does not release the stored tables.
+    static void Enable() {Settings().IsEnabled = true;}
+    static void Disable() {Settings().IsEnabled = false;}
+    static bool IsEnabled() {return Settings().IsEnabled;}
+
+    /// Set/get the maximum memory (in bytes) used by the stored tables
+    static void SetMemoryBudget(const std::size_t& Budget) {Settings().MemoryBudget = Budget;}
+    static std::size_t MemoryBudget() {return Settings().MemoryBudget;}
+
+    /// Find the tables of an equivalence class. Return false if the class is not in the cache.
+    static bool Find(const KeyType& rKey, ValuesPointerType& rpValues, GradientsPointerType& rpGradients)
+    {
+        bool found = false;
+        #pragma omp critical(ShapeFunctionsTableCache_Access)
+        {
+            ++GetStatistics().NumberOfLookups;
+            const EntryType* pEntry = FindEntry(rKey);
+            if(pEntry != NULL)
+            {
+                rpValues = pEntry->pValues;
+                rpGradients = pEntry->pGradients;
+                ++GetStatistics().NumberOfHits;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * Add the tables of an equivalence class. If another thread added the same class in the meantime, the pointers are
+     * replaced by the stored ones. Return false if the tables are not stored because of the memory budget.
+     */
+    static bool Insert(const KeyType& rKey, ValuesPointerType& rpValues, GradientsPointerType& rpGradients)
+    {
+        const std::size_t size = rKey.MemoryUsage() + MemoryUsage(*rpValues) + MemoryUsage(*rpGradients);
+
+        bool stored = true;
+        #pragma omp critical(ShapeFunctionsTableCache_Access)
+        {
+            const EntryType* pEntry = FindEntry(rKey);
+            if(pEntry != NULL)
+            {
+                rpValues = pEntry->pValues;
+                rpGradients = pEntry->pGradients;
+            }
+            else if(GetStatistics().MemoryUsage + size > Settings().MemoryBudget)
+            {
+                ++GetStatistics().NumberOfRejections;
+                stored = false;
+            }
+            else
+            {
+                EntryType Entry;
+                Entry.Key = rKey;
+                Entry.pValues = rpValues;
+                Entry.pGradients = rpGradients;
+                Entry.Size = size;
+                GetMap()[rKey.Hash()].push_back(Entry);
+                ++GetStatistics().NumberOfEntries;
+                GetStatistics().MemoryUsage += size;
+            }
+        }
+        return stored;
+    }
+
+    /// Release all the stored tables. The tables in use by the geometries are kept alive by the geometries.
+    static void Clear()
+    {
+        #pragma omp critical(ShapeFunctionsTableCache_Access)
+        {
+            GetMap().clear();
+            GetStatistics().NumberOfEntries = 0;
+            GetStatistics().MemoryUsage = 0;
+        }
+    }
+
+    /// Reset the lookup/hit/rejection counters
+    static void ResetStatistics()
+    {
+        #pragma omp critical(ShapeFunctionsTableCache_Access)
+        {
+            GetStatistics().NumberOfLookups = 0;
+            GetStatistics().NumberOfHits = 0;
+            GetStatistics().NumberOfRejections = 0;
+        }
+    }
+
+    /// Statistics
+    static std::size_t NumberOfEntries() {return GetStatistics().NumberOfEntries;}
+    static std::size_t MemoryUsage() {return GetStatistics().MemoryUsage;}
+    static std::size_t NumberOfLookups() {return GetStatistics().NumberOfLookups;}
+    static std::size_t NumberOfHits() {return GetStatistics().NumberOfHits;}
+    static std::size_t NumberOfRejections() {return GetStatistics().NumberOfRejections;}
+
+    /// Information
+    virtual void PrintInfo(std::ostream& rOStream) const
+    {
+        rOStream << "ShapeFunctionsTableCache (" << (IsEnabled() ? "enabled" : "disabled") << "): "
+                 << NumberOfEntries() << " tables, " << MemoryUsage() << "/" << MemoryBudget() << " bytes, "
+                 << NumberOfHits() << "/" << NumberOfLookups() << " lookups shared, "
+                 << NumberOfRejections() << " rejected";
+    }
+
+private:
+
+    struct EntryType
+    {
+        KeyType Key;
+        ValuesPointerType pValues;
+        GradientsPointerType pGradients;
+        std::size_t Size;
+    };
+
+    typedef std::map<std::size_t, std::vector<EntryType> > MapType;
+
+    struct SettingsType
+    {
+        SettingsType() : IsEnabled(false), MemoryBudget(256*1024*1024) {}
+        bool IsEnabled;
+        std::size_t MemoryBudget;
+    };
+
+    struct StatisticsType
+    {
+        StatisticsType() : NumberOfEntries(0), MemoryUsage(0), NumberOfLookups(0), NumberOfHits(0), NumberOfRejections(0) {}
+        std::size_t NumberOfEntries;
+        std::size_t MemoryUsage;
+        std::size_t NumberOfLookups;
+        std::size_t NumberOfHits;
+        std::size_t NumberOfRejections;
+    };
+
+    /// to be called inside the critical section
+    static const EntryType* FindEntry(const KeyType& rKey)
+    {
+        MapType::const_iterator it = GetMap().find(rKey.Hash());
+        if(it == GetMap().end())
+            return NULL;
+        for(std::size_t i = 0; i < it->second.size(); ++i)
+            if(it->second[i].Key.IsEqual(rKey))
+                return &(it->second[i]);
+        return NULL;
+    }
+
+    static std::size_t MemoryUsage(const Matrix& rValues)
+    {
+        return sizeof(Matrix) + rValues.size1() * rValues.size2() * sizeof(double);
+    }
+
+    static std::size_t MemoryUsage(const ShapeFunctionsGradientsType& rGradients)
+    {
+        std::size_t size = sizeof(ShapeFunctionsGradientsType);
+        for(std::size_t i = 0; i < rGradients.size(); ++i)
+            size += MemoryUsage(rGradients[i]);
+        return size;
+    }
+
+    static MapType& GetMap()
+    {
+        static MapType map;
+        return map;
+    }
+
+    static SettingsType& Settings()
+    {
+        static SettingsType settings;
+        return settings;
+    }
+
+    static StatisticsType& GetStatistics()
+    {
+        static StatisticsType stats;
+        return stats;
+    }
+};
+
+/// output stream function
+inline std::ostream& operator <<(std::ostream& rOStream, const ShapeFunctionsTableCache& rThis)
+{
+    rThis.PrintInfo(rOStream);
+    return rOStream;
+}
+
+}// namespace Kratos.
+
+#endif // KRATOS_ISOGEOMETRIC_APPLICATION_SHAPE_FUNCTIONS_TABLE_CACHE_H_INCLUDED
@@ -23,6 +23,7 @@ namespace Kratos
         mLastVertex = 0;
         mLockConstruct = true;
         mIsExtended = false;
+        mpExtractionOperatorArena = ExtractionOperatorArena::Pointer(new ExtractionOperatorArena());
     }
 
     TsMesh2D::~TsMesh2D()
@@ -880,6 +881,7 @@ namespace Kratos
         // clear the cell container
         if(!mCells.empty())
             mCells.clear();
+        mpExtractionOperatorArena = ExtractionOperatorArena::Pointer(new ExtractionOperatorArena()); // the old cells keep the old arena
 
         // secondly find all the cells of the extended T-splines topology mesh
         std::set<cell_t> cell_covers;
@@ -900,6 +902,7 @@ namespace Kratos
                                                mKnots[0][(*it).first.second],
                                                mKnots[1][(*it).second.first],
                                                mKnots[1][(*it).second.second]));
+                pCell->SetExtractionOperatorArena(mpExtractionOperatorArena);
                 mCells.push_back(pCell);
             }
         }
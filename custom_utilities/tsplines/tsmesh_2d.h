@@ -101,6 +101,7 @@ public:
     const edge_container_t& Edges() const;
     const anchor_container_t& Anchors() const;
     const cell_container_t& Cells() const;
+    ExtractionOperatorArena::Pointer pExtractionOperatorArena() const {return mpExtractionOperatorArena;}
     void FindCells(std::set<cell_t>& rCells, bool _extend = false) const;
     void FindAnchors(std::vector<anchor_t>& rAnchors) const;
     bool IsAnalysisSuitable();
@@ -306,6 +307,7 @@ private:
     vertex_container_t mVirtualVertices; // list of virtual vertices
     edge_container_t mEdges; // list of edges
     cell_container_t mCells; // list of cells
+    ExtractionOperatorArena::Pointer mpExtractionOperatorArena; // extraction operators of all the cells
     anchor_container_t mAnchors; // list of anchors
 
     boost::array<int, 2> mOrder; // order of the Tsplines mesh in horizontal and vertical direction
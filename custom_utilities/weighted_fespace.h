@@ -192,6 +192,83 @@ public:
         //     KRATOS_WATCH(new_dvalues[i][0])
     }
 
+    /// Get the values of the basis functions which are nonzero at point xi
+    /// Only the nonzero basis functions of the underlying FESpace contribute to the weight function
+    virtual void GetNonzeroValue(std::vector<std::size_t>& local_ids, std::vector<double>& new_values, const std::vector<double>& xi) const
+    {
+        mpFESpace->GetNonzeroValue(local_ids, new_values, xi);
+
+        double sum_value = 0.0;
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+            sum_value += mWeights[local_ids[k]] * new_values[k];
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+            new_values[k] *= mWeights[local_ids[k]] / sum_value;
+    }
+
+    /// Get the values and derivatives of the basis functions which are nonzero at point xi
+    /// the output derivatives has the form of derivatives[k][dim_index], k being the position in local_ids
+    virtual void GetNonzeroValueAndDerivative(std::vector<std::size_t>& local_ids, std::vector<double>& new_values,
+            std::vector<std::vector<double> >& new_dvalues, const std::vector<double>& xi) const
+    {
+        mpFESpace->GetNonzeroValueAndDerivative(local_ids, new_values, new_dvalues, xi);
+
+        double sum_value = 0.0;
+        double dsum_value[TDim];
+        std::fill(dsum_value, dsum_value + TDim, 0.0);
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+        {
+            const double w = mWeights[local_ids[k]];
+            sum_value += w * new_values[k];
+            for (int dim = 0; dim < TDim; ++dim)
+                dsum_value[dim] += w * new_dvalues[k][dim];
+        }
+
+        for (std::size_t k = 0; k < local_ids.size(); ++k)
+        {
+            const double w = mWeights[local_ids[k]];
+            for (int dim = 0; dim < TDim; ++dim)
+                new_dvalues[k][dim] = w * (new_dvalues[k][dim]/sum_value - new_values[k]*dsum_value[dim]/pow(sum_value, 2));
+            new_values[k] *= w / sum_value;
+        }
+    }
+
+    /// The weighted basis functions are tensor products if the underlying ones are, up to the weighting
+    virtual bool IsTensorProduct() const
+    {
+        return mpFESpace->IsTensorProduct();
+    }
+
+    /// Get the number of univariate functions of the underlying FESpace in direction dim
+    virtual std::size_t UnivariateNumber(const std::size_t& dim) const
+    {
+        return mpFESpace->UnivariateNumber(dim);
+    }
+
+    /// Get the unweighted univariate functions of the underlying FESpace; the weighting is given by pWeights()
+    virtual void GetUnivariateNonzeroValueAndDerivative(std::size_t& start, std::vector<double>& values,
+            std::vector<double>& derivatives, const std::size_t& dim, const double& t) const
+    {
+        mpFESpace->GetUnivariateNonzeroValueAndDerivative(start, values, derivatives, dim, t);
+    }
+
+    /// Get the weights of the basis functions
+    virtual const std::vector<double>* pWeights() const
+    {
+        return &mWeights;
+    }
+
+    /// Get the supports of the cells of the underlying FESpace
+    virtual void GetCellSupports(std::vector<std::vector<std::size_t> >& rSupports) const
+    {
+        mpFESpace->GetCellSupports(rSupports);
+    }
+
+    /// Get the local knot vectors of the underlying basis function
+    virtual bool GetLocalKnotVectors(const std::size_t& i, std::vector<std::vector<double> >& rKnots) const
+    {
+        return mpFESpace->GetLocalKnotVectors(i, rKnots);
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /// Reset all the dof numbers for each grid function to -1.
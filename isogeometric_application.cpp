@@ -42,6 +42,7 @@ namespace Kratos
     KRATOS_CREATE_VARIABLE( int, NUM_DIVISION_2 )
     KRATOS_CREATE_VARIABLE( int, NUM_DIVISION_3 )
     KRATOS_CREATE_VARIABLE( int, NUM_IGA_INTEGRATION_METHOD )
+    KRATOS_CREATE_VARIABLE( int, SHAPE_FUNCTIONS_PRECOMPUTE_POLICY )
     KRATOS_CREATE_VARIABLE( Matrix, EXTRACTION_OPERATOR )
     KRATOS_CREATE_VARIABLE( Matrix, EXTRACTION_OPERATOR_MCSR )
     KRATOS_CREATE_VARIABLE( Vector, EXTRACTION_OPERATOR_CSR_ROWPTR )
@@ -87,6 +88,7 @@ namespace Kratos
         KRATOS_REGISTER_VARIABLE( NUM_DIVISION_2 )
         KRATOS_REGISTER_VARIABLE( NUM_DIVISION_3 )
         KRATOS_REGISTER_VARIABLE( NUM_IGA_INTEGRATION_METHOD )
+        KRATOS_REGISTER_VARIABLE( SHAPE_FUNCTIONS_PRECOMPUTE_POLICY )
         KRATOS_REGISTER_VARIABLE( EXTRACTION_OPERATOR )
         KRATOS_REGISTER_VARIABLE( EXTRACTION_OPERATOR_MCSR )
         KRATOS_REGISTER_VARIABLE( EXTRACTION_OPERATOR_CSR_ROWPTR )
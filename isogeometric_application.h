@@ -47,6 +47,7 @@ namespace Kratos
     KRATOS_DEFINE_VARIABLE( int, NUM_DIVISION_2 ) //number of mesh points along 2nd direction in post-processing
     KRATOS_DEFINE_VARIABLE( int, NUM_DIVISION_3 ) //number of mesh points along 3rd direction in post-processing
     KRATOS_DEFINE_VARIABLE( int, NUM_IGA_INTEGRATION_METHOD )
+    KRATOS_DEFINE_VARIABLE( int, SHAPE_FUNCTIONS_PRECOMPUTE_POLICY ) //see ShapeFunctionsPrecomputePolicy
     KRATOS_DEFINE_VARIABLE( Matrix, EXTRACTION_OPERATOR )
     KRATOS_DEFINE_VARIABLE( Matrix, EXTRACTION_OPERATOR_MCSR )
     KRATOS_DEFINE_VARIABLE( Vector, EXTRACTION_OPERATOR_CSR_ROWPTR )
@@ -0,0 +1,126 @@
+#include "includes/define.h"
+#include "includes/ublas_interface.h"
+#include "utilities/openmp_utils.h"
+#include "custom_utilities/bezier_kernels.h"
+#include "custom_utilities/bezier_utils.h"
+
+using namespace Kratos;
+
+/// reference derivatives of order 1 and 2 by the recursive implementation
+void reference(double& v, double& d, double& d2, const int i, const int p, const double x)
+{
+    v = BezierUtils::bernstein2(i, p, x);
+    d = p * (BezierUtils::bernstein2(i - 1, p - 1, x) - BezierUtils::bernstein2(i, p - 1, x));
+    d2 = p * (p - 1) * (BezierUtils::bernstein2(i, p - 2, x) - 2 * BezierUtils::bernstein2(i - 1, p - 2, x) + BezierUtils::bernstein2(i - 2, p - 2, x));
+}
+
+/// compare the Bernstein kernels with the recursive implementation and with finite differences for p = 0..10
+void test(const int p, const int k)
+{
+    const int nx = 21;
+    Vector X(nx);
+    for (int t = 0; t < nx; ++t)
+        X(t) = (double) t / (nx - 1);
+
+    Vector S(p + 1), D(p + 1), D2(p + 1);
+    Matrix Ders;
+    std::vector<double> BatchDers;
+    BezierUtils::bernstein_derivatives(BatchDers, p, k, X);
+
+    double error_values = 0.0, error_derivatives = 0.0, error_batch = 0.0, error_fd = 0.0;
+    const double h = 1.0e-4;
+    for (int t = 0; t < nx; ++t)
+    {
+        const double x = X(t);
+        BezierUtils::bernstein(S, D, D2, p, x);
+        BezierUtils::bernstein_derivatives(Ders, p, k, x);
+
+        for (int i = 0; i < p + 1; ++i)
+        {
+            double v, d, d2;
+            const int ii = i;
+            reference(v, d, d2, i, p, x);
+            error_values = std::max(error_values, fabs(S(i) - v));
+            error_values = std::max(error_values, fabs(BezierUtils::bernstein(ii, p, x) - v));
+            error_derivatives = std::max(error_derivatives, fabs(D(i) - d));
+            error_derivatives = std::max(error_derivatives, fabs(D2(i) - d2));
+
+            for (int j = 0; j < k + 1; ++j)
+            {
+                error_batch = std::max(error_batch, fabs(Ders(j, i) - BatchDers[(j * (p + 1) + i) * nx + t]));
+
+                // central difference of the derivative of order j - 1
+                if (j > 0)
+                {
+                    Matrix Dp, Dm;
+                    BezierUtils::bernstein_derivatives(Dp, p, j - 1, x + h);
+                    BezierUtils::bernstein_derivatives(Dm, p, j - 1, x - h);
+                    double fd = (Dp(j - 1, i) - Dm(j - 1, i)) / (2.0 * h);
+                    double scale = 1.0;
+                    for (int l = 0; l < p + 1; ++l)
+                        scale = std::max(scale, fabs(Ders(j, l)));
+                    error_fd = std::max(error_fd, fabs(Ders(j, i) - fd) / scale);
+                }
+            }
+        }
+    }
+
+    std::cout << "p = " << p << ", k = " << k << std::endl;
+    KRATOS_WATCH(error_values)
+    KRATOS_WATCH(error_derivatives)
+    KRATOS_WATCH(error_batch)
+    KRATOS_WATCH(error_fd)
+}
+
+/// compare the time of the recursive and the kernel evaluation
+void benchmark(const int p, const int nrepeat)
+{
+    const int nx = 64;
+    Vector X(nx);
+    for (int t = 0; t < nx; ++t)
+        X(t) = (t + 0.5) / nx;
+
+    Vector S(p + 1), D(p + 1), D2(p + 1);
+    double sum_old = 0.0, sum_new = 0.0;
+
+    double start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+        for (int t = 0; t < nx; ++t)
+            for (int i = 0; i < p + 1; ++i)
+            {
+                double v, d, d2;
+                reference(v, d, d2, i, p, X(t));
+                sum_old += v + d + d2;
+            }
+    double time_old = OpenMPUtils::GetCurrentTime() - start;
+
+    std::vector<double> BatchDers;
+    start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+    {
+        BezierUtils::bernstein_derivatives(BatchDers, p, 2, X);
+        for (std::size_t i = 0; i < BatchDers.size(); ++i)
+            sum_new += BatchDers[i];
+    }
+    double time_new = OpenMPUtils::GetCurrentTime() - start;
+
+    std::cout << "p = " << p << ", " << nx << " abscissae" << std::endl;
+    std::cout << "  recursive:      " << time_old << " s" << std::endl;
+    std::cout << "  batch kernel:   " << time_new << " s" << std::endl;
+    KRATOS_WATCH(fabs(sum_old - sum_new) / fabs(sum_old))
+}
+
+int main(int argc, char** argv)
+{
+    int nrepeat = 1000;
+    if (argc > 1)
+        nrepeat = atoi(argv[1]);
+
+    for (int p = 0; p <= 10; ++p)
+        test(p, p + 1);
+
+    for (int p = 2; p <= 8; p += 2)
+        benchmark(p, nrepeat);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "includes/define.h"
+#include "includes/node.h"
+#include "custom_utilities/bezier_utils.h"
+#include "custom_utilities/bezier_batch_evaluator.h"
+#include "custom_utilities/nurbs/bcell.h"
+#include "custom_geometries/geo_3d_bezier.h"
+
+using namespace Kratos;
+
+typedef Node<3> NodeType;
+typedef Geo3dBezier<NodeType> GeometryType;
+
+/// compare the batch evaluator against the per-element Geo3dBezier, on a 3x3x3 patch of degree p.
+/// The first half of the cells keep the factored extraction operator, the other half keep their rows in the arena.
+void test(const int p)
+{
+    // 1D extraction operators of an open knot vector with two internal knots
+    std::vector<double> U;
+    for (int i = 0; i < p + 1; ++i) U.push_back(0.0);
+    U.push_back(0.3);
+    U.push_back(0.7);
+    for (int i = 0; i < p + 1; ++i) U.push_back(1.0);
+    std::vector<Matrix> C1d;
+    int nb;
+    BezierUtils::bezier_extraction_1d(C1d, nb, U, p);
+    const int ne = C1d.size();
+    const int n = p + 1;
+
+    std::vector<BCell::ExtractionOperatorPointerType> pC1d(ne);
+    for (int e = 0; e < ne; ++e)
+        pC1d[e] = BCell::ExtractionOperatorPointerType(new Matrix(C1d[e]));
+
+    // control points and weights of the patch, row Id for the basis function Id
+    const int nctrl = nb * nb * nb;
+    Matrix ControlPoints(nctrl, 3);
+    std::vector<double> ControlWeights(nctrl);
+    for (int i = 0; i < nb; ++i)
+        for (int j = 0; j < nb; ++j)
+            for (int k = 0; k < nb; ++k)
+            {
+                int id = k + (j + i * nb) * nb;
+                ControlPoints(id, 0) = i + 0.1 * sin(j + k);
+                ControlPoints(id, 1) = j + 0.1 * cos(i + k);
+                ControlPoints(id, 2) = k + 0.1 * sin(i * j);
+                ControlWeights[id] = 1.0 + 0.1 * ((id * 7) % 5);
+            }
+
+    BCell::ArenaType::Pointer pArena(new BCell::ArenaType());
+    BCell::knot_t pKnot(new BCell::KnotType(0.0));
+    std::vector<BCell::Pointer> cells;
+    std::vector<GeometryType::Pointer> geometries;
+    for (int ex = 0; ex < ne; ++ex)
+        for (int ey = 0; ey < ne; ++ey)
+            for (int ez = 0; ez < ne; ++ez)
+            {
+                BCell::Pointer p_cell(new BCell(cells.size() + 1, pKnot, pKnot, pKnot, pKnot, pKnot, pKnot));
+                p_cell->SetExtractionOperatorArena(pArena);
+                const bool factored = (static_cast<int>(cells.size()) < ne * ne * ne / 2);
+                if (factored)
+                    p_cell->SetExtractionOperatorFactors(pC1d[ex], pC1d[ey], pC1d[ez]);
+
+                GeometryType::PointsArrayType Points;
+                GeometryType::ValuesContainerType Weights(n * n * n);
+                Vector Crow(n * n * n);
+                for (int i = 0; i < n; ++i)
+                    for (int j = 0; j < n; ++j)
+                        for (int k = 0; k < n; ++k)
+                        {
+                            int id = (k + ez) + ((j + ey) + (i + ex) * nb) * nb;
+                            int loc = k + (j + i * n) * n;
+                            Points.push_back(NodeType::Pointer(new NodeType(id + 1, ControlPoints(id, 0), ControlPoints(id, 1), ControlPoints(id, 2))));
+                            Weights(loc) = ControlWeights[id];
+                            if (factored)
+                                p_cell->AddAnchor(id, ControlWeights[id]);
+                            else
+                            {
+                                for (int a = 0; a < n; ++a)
+                                    for (int b = 0; b < n; ++b)
+                                        for (int c = 0; c < n; ++c)
+                                            Crow(c + (b + a * n) * n) = C1d[ex](i, a) * C1d[ey](j, b) * C1d[ez](k, c);
+                                p_cell->AddAnchor(id, ControlWeights[id], Crow);
+                            }
+                        }
+                cells.push_back(p_cell);
+
+                GeometryType::Pointer p_geometry(new GeometryType(Points));
+                GeometryType::ValuesContainerType DummyKnots;
+                p_geometry->AssignGeometryData(DummyKnots, DummyKnots, DummyKnots, Weights, C1d[ex], C1d[ey], C1d[ez], p, p, p, 1);
+                geometries.push_back(p_geometry);
+            }
+
+    std::vector<int> Degrees(3, p);
+    GeometryData::IntegrationMethod ThisMethod = GeometryData::GI_GAUSS_1;
+    BezierBatchEvaluator<3> Evaluator(Degrees, 1, ThisMethod, n * n * n);
+    Evaluator.AddCells(cells.begin(), cells.end(), ControlPoints);
+    Evaluator.Evaluate();
+    KRATOS_WATCH(Evaluator)
+
+    double error_N = 0.0, error_DN = 0.0, error_J = 0.0, error_InvJ = 0.0;
+    Matrix N;
+    GeometryType::ShapeFunctionsGradientsType DN;
+    GeometryType::JacobiansType J;
+    for (std::size_t e = 0; e < geometries.size(); ++e)
+    {
+        geometries[e]->CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(N, DN, ThisMethod);
+        geometries[e]->Jacobian(J, ThisMethod);
+        for (std::size_t q = 0; q < N.size1(); ++q)
+        {
+            for (std::size_t i = 0; i < N.size2(); ++i)
+            {
+                error_N = std::max(error_N, fabs(N(q, i) - Evaluator.N(q, i, e)));
+                for (int d = 0; d < 3; ++d)
+                    error_DN = std::max(error_DN, fabs(DN[q](i, d) - Evaluator.DN(q, i, d, e)));
+            }
+
+            for (int a = 0; a < 3; ++a)
+                for (int d = 0; d < 3; ++d)
+                    error_J = std::max(error_J, fabs(J[q](a, d) - Evaluator.J(q, a, d, e)));
+
+            // InvJ * J shall be the identity
+            for (int d = 0; d < 3; ++d)
+                for (int b = 0; b < 3; ++b)
+                {
+                    double v = 0.0;
+                    for (int a = 0; a < 3; ++a)
+                        v += Evaluator.InvJ(q, d, a, e) * Evaluator.J(q, a, b, e);
+                    error_InvJ = std::max(error_InvJ, fabs(v - (d == b ? 1.0 : 0.0)));
+                }
+        }
+    }
+
+    std::cout << "p = " << p << ", number of elements = " << geometries.size()
+              << ", number of integration points = " << Evaluator.NumberOfIntegrationPoints() << std::endl;
+    KRATOS_WATCH(error_N)
+    KRATOS_WATCH(error_DN)
+    KRATOS_WATCH(error_J)
+    KRATOS_WATCH(error_InvJ)
+}
+
+int main(int argc, char** argv)
+{
+    for (int p = 1; p <= 4; ++p)
+        test(p);
+
+    return 0;
+}
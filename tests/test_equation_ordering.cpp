@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include "includes/define.h"
+#include "custom_utilities/disjoint_set.h"
+#include "custom_utilities/equation_ordering_utility.h"
+
+using namespace Kratos;
+
+/// merge the coincident functions of two patches of n x n functions, glued along one side, and count the equations
+void test_disjoint_set(const std::size_t n)
+{
+    DisjointSet labels(2*n*n);
+    for (std::size_t j = 0; j < n; ++j)
+        labels.Union(j*n + n-1, n*n + j*n); // the right side of patch 1 is the left side of patch 2
+    KRATOS_WATCH(labels)
+    KRATOS_WATCH((labels.NumberOfSets() == 2*n*n - n))
+}
+
+/// reorder the equations of a structured grid of quadratic cells, numbered randomly
+void test_reverse_cuthill_mckee(const std::size_t ncells)
+{
+    const std::size_t p = 2;
+    const std::size_t n = ncells + p; // number of functions in each direction
+    std::vector<std::size_t> numbering(n*n);
+    for (std::size_t i = 0; i < n*n; ++i)
+        numbering[i] = i;
+    srand(0);
+    for (std::size_t i = n*n - 1; i > 0; --i)
+        std::swap(numbering[i], numbering[rand() % (i+1)]);
+
+    std::vector<std::vector<std::size_t> > connectivities;
+    for (std::size_t ci = 0; ci < ncells; ++ci)
+    {
+        for (std::size_t cj = 0; cj < ncells; ++cj)
+        {
+            std::vector<std::size_t> anchors;
+            for (std::size_t i = ci; i <= ci + p; ++i)
+                for (std::size_t j = cj; j <= cj + p; ++j)
+                    anchors.push_back(numbering[j*n + i]);
+            connectivities.push_back(anchors);
+        }
+    }
+
+    std::vector<std::size_t> rowPtr, colInd, permutation;
+    EquationOrderingUtility::CreateGraph(n*n, connectivities, rowPtr, colInd);
+    EquationOrderingUtility::ReverseCuthillMcKee(rowPtr, colInd, permutation);
+
+    std::vector<bool> is_taken(n*n, false);
+    std::size_t number_of_errors = 0;
+    for (std::size_t i = 0; i < permutation.size(); ++i)
+    {
+        if (permutation[i] >= n*n || is_taken[permutation[i]])
+            ++number_of_errors;
+        else
+            is_taken[permutation[i]] = true;
+    }
+
+    std::cout << ncells << " x " << ncells << " cells, " << n*n << " equations" << std::endl;
+    KRATOS_WATCH(EquationOrderingUtility::Bandwidth(rowPtr, colInd, std::vector<std::size_t>()))
+    KRATOS_WATCH(EquationOrderingUtility::Bandwidth(rowPtr, colInd, permutation))
+    KRATOS_WATCH(number_of_errors)
+}
+
+int main(int argc, char** argv)
+{
+    test_disjoint_set(10);
+    test_reverse_cuthill_mckee(10);
+    test_reverse_cuthill_mckee(100);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include "includes/define.h"
+#include "utilities/openmp_utils.h"
+#include "custom_utilities/bspline_utils.h"
+#include "custom_utilities/nurbs/knot_array_1d.h"
+#include "custom_utilities/nurbs/knot_span_locator.h"
+
+using namespace Kratos;
+
+/// create an open knot vector of order p with nspans spans on [0, 1]; if graded, the spans are refined geometrically toward 0
+std::vector<double> create_knots(const int p, const int nspans, const bool graded)
+{
+    std::vector<double> knots;
+    for (int i = 0; i < p; ++i)
+        knots.push_back(0.0);
+    for (int i = 0; i <= nspans; ++i)
+    {
+        double t = (double) i / nspans;
+        knots.push_back(graded ? t * t * t : t);
+    }
+    for (int i = 0; i < p; ++i)
+        knots.push_back(1.0);
+    return knots;
+}
+
+/// compare the span lookup with the binary search, at random points and at the knots
+void benchmark(const int p, const int nspans, const bool graded, const int npoints)
+{
+    std::vector<double> knots = create_knots(p, nspans, graded);
+    const int n = knots.size() - p - 1;
+
+    std::vector<double> points(npoints);
+    srand(0);
+    for (int i = 0; i < npoints; ++i)
+        points[i] = (double) rand() / RAND_MAX;
+
+    double start = OpenMPUtils::GetCurrentTime();
+    KnotSpanLocator locator(knots);
+    double time_init = OpenMPUtils::GetCurrentTime() - start;
+
+    long sum_old = 0, sum_new = 0;
+    start = OpenMPUtils::GetCurrentTime();
+    for (int i = 0; i < npoints; ++i)
+        sum_old += BSplineUtils::FindSpan(n, p, points[i], knots);
+    double time_old = OpenMPUtils::GetCurrentTime() - start;
+
+    start = OpenMPUtils::GetCurrentTime();
+    for (int i = 0; i < npoints; ++i)
+        sum_new += locator.FindSpan(n, p, points[i]);
+    double time_new = OpenMPUtils::GetCurrentTime() - start;
+
+    int number_of_errors = (sum_old != sum_new);
+    for (std::size_t i = p; i < knots.size() - p; ++i)
+        if (locator.FindSpan(n, p, knots[i]) != BSplineUtils::FindSpan(n, p, knots[i], knots))
+            ++number_of_errors;
+
+    std::cout << (graded ? "graded" : "uniform") << " knot vector, p = " << p << ", " << nspans << " spans, " << npoints << " points" << std::endl;
+    std::cout << "  initialize:     " << time_init << " s" << std::endl;
+    std::cout << "  binary search:  " << time_old << " s" << std::endl;
+    std::cout << "  span locator:   " << time_new << " s" << std::endl;
+    KRATOS_WATCH(locator.IsUniform())
+    KRATOS_WATCH(number_of_errors)
+}
+
+/// check that the span lookup of KnotArray1D follows the knot insertion
+void test_knot_insertion()
+{
+    KnotArray1D<double> knots;
+    double values[] = {0.0, 0.0, 0.0, 0.5, 1.0, 1.0, 1.0};
+    for (int i = 0; i < 7; ++i)
+        knots.pCreateKnot(values[i]);
+    KRATOS_WATCH(knots.FindSpan(4, 2, 0.6))
+
+    knots.pCreateKnot(0.75);
+    KRATOS_WATCH(knots.FindSpan(5, 2, 0.6))
+    KRATOS_WATCH(knots.FindSpan(5, 2, 0.8))
+    KRATOS_WATCH(BSplineUtils::FindSpan(5, 2, 0.8, knots))
+}
+
+int main(int argc, char** argv)
+{
+    int npoints = 1000000;
+    if (argc > 1)
+        npoints = atoi(argv[1]);
+
+    test_knot_insertion();
+
+    for (int nspans = 100; nspans <= 1000000; nspans *= 10)
+    {
+        benchmark(2, nspans, false, npoints);
+        benchmark(2, nspans, true, npoints);
+    }
+
+    return 0;
+}
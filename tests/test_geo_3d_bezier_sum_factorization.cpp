@@ -0,0 +1,138 @@
+#include "includes/define.h"
+#include "includes/node.h"
+#include "utilities/openmp_utils.h"
+#include "custom_utilities/bezier_utils.h"
+#include "custom_geometries/geo_3d_bezier.h"
+
+using namespace Kratos;
+
+typedef Node<3> NodeType;
+typedef Geo3dBezier<NodeType> GeometryType;
+
+/// compare the dense Bezier path and the sum factorization path of Geo3dBezier for p = 2..5
+void benchmark(const int p, const int nrepeat)
+{
+    // extraction operator of the first element of an open knot vector with two internal knots
+    std::vector<double> U;
+    for (int i = 0; i < p + 1; ++i) U.push_back(0.0);
+    U.push_back(0.3);
+    U.push_back(0.7);
+    for (int i = 0; i < p + 1; ++i) U.push_back(1.0);
+    std::vector<Matrix> C1d;
+    int nb;
+    BezierUtils::bezier_extraction_1d(C1d, nb, U, p);
+    const Matrix& C = C1d[0];
+
+    const int n = p + 1;
+    Matrix C3d(n * n * n, n * n * n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < n; ++k)
+                for (int a = 0; a < n; ++a)
+                    for (int b = 0; b < n; ++b)
+                        for (int c = 0; c < n; ++c)
+                            C3d(k + (j + i * n) * n, c + (b + a * n) * n) = C(i, a) * C(j, b) * C(k, c);
+
+    GeometryType::PointsArrayType Points;
+    Vector Weights(n * n * n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < n; ++k)
+            {
+                int id = k + (j + i * n) * n;
+                double x = i + 0.1 * sin(j + k);
+                double y = j + 0.1 * cos(i + k);
+                double z = k + 0.1 * sin(i * j);
+                Points.push_back(NodeType::Pointer(new NodeType(id + 1, x, y, z)));
+                Weights(id) = 1.0 + 0.1 * ((id * 7) % 5);
+            }
+
+    GeometryType::ValuesContainerType DummyKnots;
+    GeometryType DenseGeometry(Points);
+    DenseGeometry.AssignGeometryData(DummyKnots, DummyKnots, DummyKnots, Weights, C3d, p, p, p, 1);
+    GeometryType FactoredGeometry(Points);
+    FactoredGeometry.AssignGeometryData(DummyKnots, DummyKnots, DummyKnots, Weights, C, C, C, p, p, p, 1);
+
+    GeometryData::IntegrationMethod ThisMethod = GeometryData::GI_GAUSS_1;
+    Matrix N_old, N_new, N_fac;
+    GeometryType::ShapeFunctionsGradientsType DN_old, DN_new, DN_fac;
+    GeometryType::JacobiansType J_old, J_new;
+
+    double start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+        DenseGeometry.CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradientsDense(N_old, DN_old, ThisMethod);
+    double time_old = OpenMPUtils::GetCurrentTime() - start;
+
+    start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+        DenseGeometry.CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(N_new, DN_new, ThisMethod);
+    double time_new = OpenMPUtils::GetCurrentTime() - start;
+
+    start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+        FactoredGeometry.CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradients(N_fac, DN_fac, ThisMethod);
+    double time_fac = OpenMPUtils::GetCurrentTime() - start;
+
+    // Jacobian by contracting the dense shape function gradients with all nodes
+    start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+    {
+        DenseGeometry.CalculateShapeFunctionsIntegrationPointsValuesAndLocalGradientsDense(N_old, DN_old, ThisMethod);
+        J_old.resize(DN_old.size());
+        for (std::size_t pnt = 0; pnt < DN_old.size(); ++pnt)
+        {
+            J_old[pnt] = ZeroMatrix(3, 3);
+            for (std::size_t i = 0; i < Points.size(); ++i)
+                for (int k = 0; k < 3; ++k)
+                {
+                    J_old[pnt](0, k) += Points[i].X() * DN_old[pnt](i, k);
+                    J_old[pnt](1, k) += Points[i].Y() * DN_old[pnt](i, k);
+                    J_old[pnt](2, k) += Points[i].Z() * DN_old[pnt](i, k);
+                }
+        }
+    }
+    double time_jac_old = OpenMPUtils::GetCurrentTime() - start;
+
+    start = OpenMPUtils::GetCurrentTime();
+    for (int r = 0; r < nrepeat; ++r)
+        DenseGeometry.Jacobian(J_new, ThisMethod);
+    double time_jac_new = OpenMPUtils::GetCurrentTime() - start;
+
+    double error = 0.0;
+    for (std::size_t pnt = 0; pnt < N_old.size1(); ++pnt)
+    {
+        for (std::size_t i = 0; i < N_old.size2(); ++i)
+        {
+            error = std::max(error, fabs(N_old(pnt, i) - N_new(pnt, i)));
+            error = std::max(error, fabs(N_old(pnt, i) - N_fac(pnt, i)));
+            for (int k = 0; k < 3; ++k)
+            {
+                error = std::max(error, fabs(DN_old[pnt](i, k) - DN_new[pnt](i, k)));
+                error = std::max(error, fabs(DN_old[pnt](i, k) - DN_fac[pnt](i, k)));
+            }
+        }
+        for (int k = 0; k < 3; ++k)
+            for (int l = 0; l < 3; ++l)
+                error = std::max(error, fabs(J_old[pnt](k, l) - J_new[pnt](k, l)));
+    }
+
+    std::cout << "p = " << p << ", number of integration points = " << N_old.size1() << std::endl;
+    std::cout << "  shape functions, dense:                  " << time_old << " s" << std::endl;
+    std::cout << "  shape functions, sum factorization:      " << time_new << " s" << std::endl;
+    std::cout << "  shape functions, factored extraction:    " << time_fac << " s" << std::endl;
+    std::cout << "  Jacobian, dense:                         " << time_jac_old << " s" << std::endl;
+    std::cout << "  Jacobian, sum factorization:             " << time_jac_new << " s" << std::endl;
+    KRATOS_WATCH(error)
+}
+
+int main(int argc, char** argv)
+{
+    int nrepeat = 100;
+    if (argc > 1)
+        nrepeat = atoi(argv[1]);
+
+    for (int p = 2; p <= 5; ++p)
+        benchmark(p, nrepeat);
+
+    return 0;
+}
@@ -37,6 +37,13 @@ int main(int argc, char** argv)
         std::cout << "---------------" << std::endl;
     }
 
+    // the copy shares the knots, hence it sees the modification of the knot values
+    knot_container_t knot_vector_copy(knot_vector);
+    KRATOS_WATCH(knot_vector_copy[4])
+    knot_vector.pKnotAt(4)->Value() = 0.3;
+    knot_vector.ResetCache();
+    KRATOS_WATCH(knot_vector_copy[4])
+
     return 0;
 }
 
@@ -0,0 +1,56 @@
+#include "includes/define.h"
+#include "custom_utilities/patch.h"
+#include "custom_utilities/multipatch.h"
+#include "custom_utilities/nurbs/bsplines_fespace_library.h"
+#include "custom_utilities/nurbs/bsplines_patch_utility.h"
+
+using namespace Kratos;
+
+/// enumerate two patches of n x n quadratic functions glued along one side; the functions on the interface are merged
+void test_multipatch_enumerate(const std::size_t n, const bool reorder)
+{
+    std::vector<std::size_t> numbers = {n, n};
+    std::vector<std::size_t> orders = {2, 2};
+
+    Patch<2>::Pointer pPatch1 = Patch<2>::Create(1, BSplinesFESpaceLibrary::CreateUniformFESpace<2>(numbers, orders));
+    Patch<2>::Pointer pPatch2 = Patch<2>::Create(2, BSplinesFESpaceLibrary::CreateUniformFESpace<2>(numbers, orders));
+    BSplinesPatchUtility::MakeInterface2D(pPatch1, _BRIGHT_, pPatch2, _BLEFT_, _FORWARD_);
+
+    MultiPatch<2>::Pointer pMultiPatch = MultiPatch<2>::Pointer(new MultiPatch<2>());
+    pMultiPatch->AddPatch(pPatch1);
+    pMultiPatch->AddPatch(pPatch2);
+    pMultiPatch->SetEquationReordering(reorder);
+    pMultiPatch->Enumerate();
+
+    std::vector<std::size_t> ids1 = pPatch1->pFESpace()->ExtractBoundaryFunctionIndices(_BRIGHT_);
+    std::vector<std::size_t> ids2 = pPatch2->pFESpace()->ExtractBoundaryFunctionIndices(_BLEFT_);
+    std::size_t number_of_errors = (ids1 == ids2) ? 0 : 1;
+
+    // the equation ids shall be consecutive from 0
+    std::vector<bool> is_taken(pMultiPatch->EquationSystemSize(), false);
+    for (std::size_t ip = 1; ip <= 2; ++ip)
+    {
+        std::vector<std::size_t> ids = pMultiPatch->pGetPatch(ip)->pFESpace()->FunctionIndices();
+        for (std::size_t i = 0; i < ids.size(); ++i)
+        {
+            if (ids[i] >= is_taken.size())
+                ++number_of_errors;
+            else
+                is_taken[ids[i]] = true;
+        }
+    }
+    for (std::size_t i = 0; i < is_taken.size(); ++i)
+        if (!is_taken[i])
+            ++number_of_errors;
+
+    std::cout << "2 patches of " << n << " x " << n << " functions, reorder: " << reorder << std::endl;
+    KRATOS_WATCH((pMultiPatch->EquationSystemSize() == 2*n*n - n))
+    KRATOS_WATCH(number_of_errors)
+}
+
+int main(int argc, char** argv)
+{
+    test_multipatch_enumerate(5, false);
+    test_multipatch_enumerate(5, true);
+    return 0;
+}